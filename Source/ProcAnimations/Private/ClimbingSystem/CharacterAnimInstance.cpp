@@ -5,6 +5,8 @@
 #include "ClimbingSystem/CustomMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "ClimbingSystem/ClimbingCharacter.h"
+#include "ClimbingSystem/ClimbIKComponent.h"
+#include "ClimbingSystem/ClimbingSettings.h"
 
 void UCharacterAnimInstance::NativeInitializeAnimation()
 {
@@ -14,6 +16,8 @@ void UCharacterAnimInstance::NativeInitializeAnimation()
 	if(TraversalMechCharacter)
 	{
 		CustomMovementComponent = TraversalMechCharacter->GetCustomMovementComponent();
+		bSkipGraphVariableUpdate = TraversalMechCharacter->IsNetMode(NM_DedicatedServer) &&
+			UClimbingSettings::Get()->bStripPresentationOnServer;
 	}
 }
 
@@ -22,12 +26,28 @@ void UCharacterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 	Super::NativeUpdateAnimation(DeltaSeconds);
 
 	if(!TraversalMechCharacter || !CustomMovementComponent) return;
+	ResolveMontageInputLatency();
+	if(bSkipGraphVariableUpdate) return;
 	GetGroundSpeed();
 	GetAirSpeed();
 	GetShouldMove();
 	GetIsFalling();
 	GetIsClimbing();
+	GetIsWallRunning();
 	GetClimbVelocity();
+	GetClimbIKTargets();
+}
+
+void UCharacterAnimInstance::ResolveMontageInputLatency()
+{
+	const UAnimMontage* Montage = CustomMovementComponent->GetInputLatencyMontage();
+	if(!Montage) return;
+
+	// Montages have already advanced by the time the native update runs
+	if(Montage_IsPlaying(Montage) && Montage_GetPosition(Montage) > 0.f)
+	{
+		CustomMovementComponent->ResolveClimbInputLatency();
+	}
 }
 
 void UCharacterAnimInstance::GetGroundSpeed()
@@ -52,7 +72,13 @@ void UCharacterAnimInstance::GetIsFalling()
 
 void UCharacterAnimInstance::GetIsClimbing()
 {
-	bIsClimbing = CustomMovementComponent->IsClimbing();
+	bIsHanging = CustomMovementComponent->IsHanging();
+	bIsClimbing = CustomMovementComponent->IsClimbing() || bIsHanging;
+}
+
+void UCharacterAnimInstance::GetIsWallRunning()
+{
+	bIsWallRunning = CustomMovementComponent->IsWallRunning();
 }
 
 void UCharacterAnimInstance::GetClimbVelocity()
@@ -60,3 +86,20 @@ void UCharacterAnimInstance::GetClimbVelocity()
 	ClimbVelocity = CustomMovementComponent->GetUnrotatedClimbVelocity();
 }
 
+void UCharacterAnimInstance::GetClimbIKTargets()
+{
+	const UClimbIKComponent* ClimbIKComponent = TraversalMechCharacter->GetClimbIKComponent();
+	if(!ClimbIKComponent)
+	{
+		ClimbIKAlpha = 0.f;
+		return;
+	}
+
+	ClimbIKAlpha = ClimbIKComponent->GetIKAlpha();
+	if(ClimbIKAlpha <= 0.f) return;
+
+	LeftHandIKLocation = ClimbIKComponent->GetLimbEffectorLocation(EClimbLimb::LeftHand);
+	RightHandIKLocation = ClimbIKComponent->GetLimbEffectorLocation(EClimbLimb::RightHand);
+	LeftFootIKLocation = ClimbIKComponent->GetLimbEffectorLocation(EClimbLimb::LeftFoot);
+	RightFootIKLocation = ClimbIKComponent->GetLimbEffectorLocation(EClimbLimb::RightFoot);
+}
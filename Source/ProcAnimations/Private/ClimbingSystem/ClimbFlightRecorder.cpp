@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbFlightRecorder.h"
+
+#include "Async/Async.h"
+#include "ClimbingSystem/ClimbingMemory.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/UObjectArray.h"
+
+FClimbFlightRecorder::FClimbFlightRecorder()
+{
+	// The ring is the recorder's only allocation, recording itself never allocates
+	LLM_SCOPE_BYTAG(Climbing_FlightRecorder);
+	Slots = MakeUnique<FSlot[]>(Capacity);
+}
+
+FClimbFlightRecorder& FClimbFlightRecorder::Get()
+{
+	static FClimbFlightRecorder Recorder;
+	return Recorder;
+}
+
+void FClimbFlightRecorder::Record(EClimbFlightEventType Type, const UObject* Agent, uint8 Arg, float Value, const UObject* Subject)
+{
+	if(!bEnabled) return;
+
+	const uint64 Index = WriteIndex.fetch_add(1, std::memory_order_relaxed);
+	FSlot& Slot = Slots[Index & (Capacity - 1)];
+
+	// Zero marks the slot as being written until the event is complete
+	Slot.Sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Slot.Event.Cycles = FPlatformTime::Cycles64();
+	Slot.Event.FrameNumber = GFrameCounter;
+	Slot.Event.AgentId = Agent ? Agent->GetUniqueID() : MAX_uint32;
+	Slot.Event.SubjectId = Subject ? Subject->GetUniqueID() : MAX_uint32;
+	Slot.Event.Type = Type;
+	Slot.Event.Arg = Arg;
+	Slot.Event.Value = Value;
+
+	Slot.Sequence.store(Index + 1, std::memory_order_release);
+}
+
+FString FClimbFlightRecorder::DumpToFile(double Seconds, float TriggerFrameMs) const
+{
+	LLM_SCOPE_BYTAG(Climbing_FlightRecorder);
+
+	const uint64 NowCycles = FPlatformTime::Cycles64();
+	const uint64 WindowCycles = (uint64)(Seconds / FPlatformTime::GetSecondsPerCycle64());
+	const uint64 End = WriteIndex.load(std::memory_order_acquire);
+	const uint64 Begin = End > Capacity ? End - Capacity : 0;
+
+	TArray<FClimbFlightEvent> Events;
+	Events.Reserve((int32)(End - Begin));
+	for(uint64 Index = Begin; Index < End; ++Index)
+	{
+		const FSlot& Slot = Slots[Index & (Capacity - 1)];
+		if(Slot.Sequence.load(std::memory_order_acquire) != Index + 1) continue;
+
+		const FClimbFlightEvent Event = Slot.Event;
+
+		// Skip slots a writer has lapped while we were copying
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(Slot.Sequence.load(std::memory_order_relaxed) != Index + 1) continue;
+
+		if(NowCycles - Event.Cycles <= WindowCycles)
+		{
+			Events.Add(Event);
+		}
+	}
+
+	// Names are resolved now, on the game thread, while the objects are still alive
+	TMap<uint32, FString> AgentNames;
+	auto AddName = [&AgentNames](uint32 ObjectId)
+	{
+		if(ObjectId == MAX_uint32 || AgentNames.Contains(ObjectId)) return;
+
+		const FUObjectItem* ObjectItem = GUObjectArray.IndexToObject(ObjectId);
+		const UObject* Object = ObjectItem ? static_cast<const UObject*>(ObjectItem->Object) : nullptr;
+		AgentNames.Add(ObjectId, Object ? Object->GetName() : TEXT("<gone>"));
+	};
+	for(const FClimbFlightEvent& Event : Events)
+	{
+		AddName(Event.AgentId);
+		AddName(Event.SubjectId);
+	}
+
+	FClimbFlightDumpHeader Header;
+	Header.SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+	Header.TriggerCycles = NowCycles;
+	Header.TriggerFrameMs = TriggerFrameMs;
+	Header.NumAgents = AgentNames.Num();
+	Header.NumEvents = Events.Num();
+
+	const FString FilePath = FPaths::ProjectSavedDir() / TEXT("Climbing/FlightRecorder") /
+		FString::Printf(TEXT("Hitch_%s.cfr"), *FDateTime::Now().ToString());
+
+	// File IO stays off the frame that is already over budget
+	Async(EAsyncExecution::ThreadPool, [FilePath, Header, AgentNames = MoveTemp(AgentNames), Events = MoveTemp(Events)]()
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		Writer.Serialize(const_cast<FClimbFlightDumpHeader*>(&Header), sizeof(Header));
+		for(const TPair<uint32, FString>& AgentName : AgentNames)
+		{
+			uint32 AgentId = AgentName.Key;
+			FString Name = AgentName.Value;
+			Writer << AgentId << Name;
+		}
+		Writer.Serialize(const_cast<FClimbFlightEvent*>(Events.GetData()), Events.Num() * sizeof(FClimbFlightEvent));
+
+		FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+	});
+
+	return FilePath;
+}
+
+const TCHAR* FClimbFlightRecorder::GetEventTypeName(EClimbFlightEventType Type)
+{
+	switch(Type)
+	{
+	case EClimbFlightEventType::Frame: return TEXT("Frame");
+	case EClimbFlightEventType::ClimbTick: return TEXT("ClimbTick");
+	case EClimbFlightEventType::Trace: return TEXT("Trace");
+	case EClimbFlightEventType::MovementModeChanged: return TEXT("MovementMode");
+	case EClimbFlightEventType::TraversalStateChanged: return TEXT("TraversalState");
+	case EClimbFlightEventType::MontageEvent: return TEXT("Montage");
+	case EClimbFlightEventType::ToggleClimbing: return TEXT("ToggleClimbing");
+	default: return TEXT("Unknown");
+	}
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbFlightRecorderDecodeCommandlet.h"
+
+#include "ClimbingSystem/ClimbFlightRecorder.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+
+UClimbFlightRecorderDecodeCommandlet::UClimbFlightRecorderDecodeCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UClimbFlightRecorderDecodeCommandlet::Main(const FString& Params)
+{
+	FString FilePath;
+	if(!FParse::Value(*Params, TEXT("File="), FilePath))
+	{
+		UE_LOG(LogClimbing, Error, TEXT("Usage: -run=ClimbFlightRecorderDecode -File=Path [-Out=Path]"));
+		return 1;
+	}
+
+	FString OutPath = FPaths::ChangeExtension(FilePath, TEXT("txt"));
+	FParse::Value(*Params, TEXT("Out="), OutPath);
+
+	TArray<uint8> Bytes;
+	if(!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+	{
+		UE_LOG(LogClimbing, Error, TEXT("Could not read %s"), *FilePath);
+		return 1;
+	}
+
+	FMemoryReader Reader(Bytes);
+
+	FClimbFlightDumpHeader Header;
+	Reader.Serialize(&Header, sizeof(Header));
+	if(Reader.IsError() || Header.Magic != FClimbFlightDumpHeader::ExpectedMagic || Header.Version != FClimbFlightDumpHeader::CurrentVersion)
+	{
+		UE_LOG(LogClimbing, Error, TEXT("%s is not a version %u flight recorder dump"), *FilePath, FClimbFlightDumpHeader::CurrentVersion);
+		return 1;
+	}
+
+	TMap<uint32, FString> AgentNames;
+	for(uint32 Index = 0; Index < Header.NumAgents; ++Index)
+	{
+		uint32 AgentId;
+		FString Name;
+		Reader << AgentId << Name;
+		AgentNames.Add(AgentId, Name);
+	}
+
+	TArray<FClimbFlightEvent> Events;
+	Events.SetNumUninitialized(Header.NumEvents);
+	Reader.Serialize(Events.GetData(), Events.Num() * sizeof(FClimbFlightEvent));
+	if(Reader.IsError())
+	{
+		UE_LOG(LogClimbing, Error, TEXT("%s is truncated"), *FilePath);
+		return 1;
+	}
+
+	// Concurrent writers can land slightly out of order
+	Events.StableSort([](const FClimbFlightEvent& A, const FClimbFlightEvent& B) { return A.Cycles < B.Cycles; });
+
+	TArray<FString> Lines;
+	Lines.Add(FString::Printf(TEXT("Hitch frame %.2f ms, %u events, times in ms relative to the hitch"), Header.TriggerFrameMs, Header.NumEvents));
+
+	for(const FClimbFlightEvent& Event : Events)
+	{
+		const double RelativeMs = ((double)Event.Cycles - (double)Header.TriggerCycles) * Header.SecondsPerCycle * 1000.0;
+		const FString* AgentName = AgentNames.Find(Event.AgentId);
+		const FString* SubjectName = AgentNames.Find(Event.SubjectId);
+
+		Lines.Add(FString::Printf(TEXT("%+10.3f  frame %-8u %-16s %-32s arg %-3u value %-10.3f %s"),
+			RelativeMs,
+			Event.FrameNumber,
+			FClimbFlightRecorder::GetEventTypeName(Event.Type),
+			AgentName ? **AgentName : TEXT("-"),
+			Event.Arg,
+			Event.Value,
+			SubjectName ? **SubjectName : TEXT("")));
+	}
+
+	FFileHelper::SaveStringArrayToFile(Lines, *OutPath);
+	UE_LOG(LogClimbing, Display, TEXT("Wrote %d events to %s"), Events.Num(), *OutPath);
+	return 0;
+}
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbFlightRecorderSubsystem.h"
+
+#include "ClimbingSystem/ClimbFlightRecorder.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+
+namespace ClimbFlightRecorderCommands
+{
+	static FAutoConsoleCommand DumpCommand(
+		TEXT("Climbing.FlightRecorder.Dump"),
+		TEXT("Writes the recent climbing flight recorder history to Saved/Climbing/FlightRecorder. Args: [Seconds]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const double Seconds = Args.IsValidIndex(0) ? FCString::Atod(*Args[0]) : UClimbingSettings::Get()->FlightRecorderDumpSeconds;
+			const FString FilePath = FClimbFlightRecorder::Get().DumpToFile(Seconds, FApp::GetDeltaTime() * 1000.f);
+			UE_LOG(LogClimbing, Display, TEXT("Climbing flight recorder dumped to %s"), *FilePath);
+		}));
+}
+
+void UClimbFlightRecorderSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FClimbFlightRecorder::Get().bEnabled = UClimbingSettings::Get()->bEnableFlightRecorder;
+}
+
+bool UClimbFlightRecorderSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UClimbFlightRecorderSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbFlightRecorderSubsystem, STATGROUP_Climbing);
+}
+
+void UClimbFlightRecorderSubsystem::Tick(float DeltaTime)
+{
+	FClimbFlightRecorder& Recorder = FClimbFlightRecorder::Get();
+	if(!Recorder.bEnabled) return;
+
+	// The real duration of the last frame, not the dilated world delta
+	const float FrameMs = FApp::GetDeltaTime() * 1000.f;
+	Recorder.Record(EClimbFlightEventType::Frame, nullptr, 0, FrameMs);
+
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	if(FrameMs < Settings->FlightRecorderHitchThresholdMs) return;
+
+	const double Now = FPlatformTime::Seconds();
+	if(Now - LastDumpTime < Settings->FlightRecorderDumpCooldown) return;
+	LastDumpTime = Now;
+
+	const FString FilePath = Recorder.DumpToFile(Settings->FlightRecorderDumpSeconds, FrameMs);
+	UE_LOG(LogClimbing, Warning, TEXT("Climbing hitch of %.1f ms, flight recorder dumped to %s"), FrameMs, *FilePath);
+}
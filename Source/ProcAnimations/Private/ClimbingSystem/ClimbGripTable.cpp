@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbGripTable.h"
+
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+namespace ClimbGripTable
+{
+	static uint32 HashGrip(const FClimbGrip& Grip, uint32 Hash)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(Grip.bClimbable));
+		Hash = HashCombine(Hash, GetTypeHash(Grip.MaxClimbSpeed));
+		Hash = HashCombine(Hash, GetTypeHash(Grip.StopClimbSlopeAngle));
+		Hash = HashCombine(Hash, GetTypeHash(Grip.MaxOverhangAngle));
+		return HashCombine(Hash, GetTypeHash(Grip.StaminaCostPerSecond));
+	}
+}
+
+const FClimbGrip& UClimbGripTable::FindGrip(const UPhysicalMaterial* PhysicalMaterial) const
+{
+	if(!PhysicalMaterial) return DefaultGrip;
+
+	const int32* EntryIndex = GripLookup.Find(PhysicalMaterial);
+	return EntryIndex ? Entries[*EntryIndex].Grip : DefaultGrip;
+}
+
+float UClimbGripTable::GetMaxClimbSpeed() const
+{
+	float MaxClimbSpeed = DefaultGrip.MaxClimbSpeed;
+	for(const FClimbGripEntry& Entry : Entries)
+	{
+		MaxClimbSpeed = FMath::Max(MaxClimbSpeed, Entry.Grip.MaxClimbSpeed);
+	}
+	return MaxClimbSpeed;
+}
+
+void UClimbGripTable::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildGripLookup();
+}
+
+#if WITH_EDITOR
+void UClimbGripTable::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BuildGripLookup();
+}
+#endif
+
+void UClimbGripTable::BuildGripLookup()
+{
+	DefaultGrip.CacheSlopeLimits();
+
+	// By content rather than by asset, so an edited table no longer matches what was baked with the old one
+	uint32 Hash = ClimbGripTable::HashGrip(DefaultGrip, 0);
+
+	GripLookup.Reset();
+	for(int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+	{
+		FClimbGripEntry& Entry = Entries[EntryIndex];
+		Entry.Grip.CacheSlopeLimits();
+		Hash = HashCombine(Hash, GetTypeHash(Entry.PhysicalMaterial ? Entry.PhysicalMaterial->GetPathName() : FString()));
+		Hash = ClimbGripTable::HashGrip(Entry.Grip, Hash);
+
+		// The first entry for a material wins, as it would in a linear search
+		if(Entry.PhysicalMaterial && !GripLookup.Contains(Entry.PhysicalMaterial))
+		{
+			GripLookup.Add(Entry.PhysicalMaterial, EntryIndex);
+		}
+	}
+
+	// 0 stands for no grip table at all
+	ContentHash = Hash != 0 ? Hash : 1;
+}
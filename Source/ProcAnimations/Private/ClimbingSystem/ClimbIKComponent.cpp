@@ -0,0 +1,183 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbIKComponent.h"
+
+#include "ClimbingSystem/ClimbingCharacter.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "ClimbingSystem/ClimbIKSubsystem.h"
+#include "ClimbingSystem/CustomMovementComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+
+UClimbIKComponent::UClimbIKComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void UClimbIKComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	OwningClimbingCharacter = Cast<AClimbingCharacter>(GetOwner());
+	if(OwningClimbingCharacter)
+	{
+		CustomMovementComponent = OwningClimbingCharacter->GetCustomMovementComponent();
+	}
+
+	LimbTraceDelegate.BindUObject(this, &UClimbIKComponent::OnLimbTraceDone);
+
+	if(UClimbIKSubsystem* IKSubsystem = GetWorld()->GetSubsystem<UClimbIKSubsystem>())
+	{
+		IKSubsystem->RegisterClimber(this);
+	}
+}
+
+void UClimbIKComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(UClimbIKSubsystem* IKSubsystem = GetWorld()->GetSubsystem<UClimbIKSubsystem>())
+	{
+		IKSubsystem->UnregisterClimber(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UClimbIKComponent::TickComponent(float DeltaTime, ELevelTick TickType,
+                                      FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	SCOPE_CYCLE_COUNTER(STAT_ClimbIK_Update);
+
+	const bool bWantsIK = WantsIK() && !bIKDegraded;
+	IKAlpha = FMath::FInterpTo(IKAlpha, bWantsIK ? 1.f : 0.f, DeltaTime, AlphaInterpSpeed);
+
+	if(IKAlpha <= KINDA_SMALL_NUMBER)
+	{
+		// Invalidate in flight traces so a late result does not pop a limb when IK comes back
+		for(FClimbLimbIKState& Limb : Limbs)
+		{
+			Limb.bHasTarget = false;
+		}
+		++TraceGeneration;
+		return;
+	}
+
+	for(uint8 LimbIndex = 0; LimbIndex < (uint8)EClimbLimb::Num; ++LimbIndex)
+	{
+		FClimbLimbIKState& Limb = Limbs[LimbIndex];
+		const FVector BoneLocation = GetLimbBoneLocation((EClimbLimb)LimbIndex);
+		const FVector DesiredLocation = Limb.bHasTarget ? Limb.TargetLocation : BoneLocation;
+
+		if(Limb.EffectorLocation.IsZero())
+		{
+			Limb.EffectorLocation = BoneLocation;
+		}
+		Limb.EffectorLocation = FMath::VInterpTo(Limb.EffectorLocation, DesiredLocation, DeltaTime, EffectorInterpSpeed);
+	}
+}
+
+bool UClimbIKComponent::WantsIK() const
+{
+	return CustomMovementComponent && (CustomMovementComponent->IsClimbing() || CustomMovementComponent->IsHanging());
+}
+
+int32 UClimbIKComponent::RefreshLimbTargets(int32 TraceBudget)
+{
+	if(!CustomMovementComponent || !WantsIK()) return 0;
+
+	UWorld* World = GetWorld();
+	const FVector SurfaceNormal = CustomMovementComponent->GetClimbableSurfaceNormal();
+	if(SurfaceNormal.IsNearlyZero()) return 0;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbIKLimbTrace), false, GetOwner());
+	const FCollisionObjectQueryParams& ObjectQueryParams = CustomMovementComponent->GetClimbableSurfaceObjectQueryParams();
+
+	int32 TracesIssued = 0;
+	for(uint8 LimbIndex = 0; LimbIndex < (uint8)EClimbLimb::Num; ++LimbIndex)
+	{
+		const FVector LimbLocation = GetLimbBoneLocation((EClimbLimb)LimbIndex);
+
+		FVector ReusedTarget;
+		if(TryReuseSurfaceHit(LimbLocation, ReusedTarget))
+		{
+			Limbs[LimbIndex].TargetLocation = ReusedTarget;
+			Limbs[LimbIndex].bHasTarget = true;
+			INC_DWORD_STAT(STAT_ClimbIK_ReusedSurfaceHits);
+			continue;
+		}
+
+		if(TracesIssued >= TraceBudget) continue;
+
+		const FVector Start = LimbLocation + SurfaceNormal * LimbTraceOutset;
+		const FVector End = LimbLocation - SurfaceNormal * LimbTraceDepth;
+
+		// Generation lives in the upper bits so results from an older batch can be discarded
+		const uint32 UserData = (TraceGeneration << 8) | LimbIndex;
+		World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Start, End, ObjectQueryParams, QueryParams,
+			&LimbTraceDelegate, UserData);
+		++TracesIssued;
+	}
+
+	INC_DWORD_STAT_BY(STAT_ClimbIK_LimbTraces, TracesIssued);
+	return TracesIssued;
+}
+
+FVector UClimbIKComponent::GetLimbBoneLocation(EClimbLimb Limb) const
+{
+	const USkeletalMeshComponent* Mesh = OwningClimbingCharacter ? OwningClimbingCharacter->GetMesh() : nullptr;
+	if(!Mesh) return GetOwner()->GetActorLocation();
+
+	switch (Limb)
+	{
+	case EClimbLimb::LeftHand:
+		return Mesh->GetSocketLocation(LeftHandBone);
+	case EClimbLimb::RightHand:
+		return Mesh->GetSocketLocation(RightHandBone);
+	case EClimbLimb::LeftFoot:
+		return Mesh->GetSocketLocation(LeftFootBone);
+	case EClimbLimb::RightFoot:
+		return Mesh->GetSocketLocation(RightFootBone);
+	default:
+		return Mesh->GetComponentLocation();
+	}
+}
+
+bool UClimbIKComponent::TryReuseSurfaceHit(const FVector& LimbLocation, FVector& OutTargetLocation) const
+{
+	const float ReuseRadiusSq = FMath::Square(SurfaceHitReuseRadius);
+
+	for(const FHitResult& SurfaceHit : CustomMovementComponent->GetClimbableSurfacesTracedResults())
+	{
+		// Slide the limb onto the plane of the nearby capsule hit rather than snapping it to the hit point
+		const FVector ProjectedLimb = FVector::PointPlaneProject(LimbLocation, SurfaceHit.ImpactPoint, SurfaceHit.ImpactNormal);
+		if(FVector::DistSquared(ProjectedLimb, SurfaceHit.ImpactPoint) <= ReuseRadiusSq)
+		{
+			OutTargetLocation = ProjectedLimb;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UClimbIKComponent::OnLimbTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const uint32 Generation = TraceDatum.UserData >> 8;
+	const uint8 LimbIndex = TraceDatum.UserData & 0xFF;
+
+	if(Generation != (TraceGeneration & 0x00FFFFFF) || LimbIndex >= (uint8)EClimbLimb::Num) return;
+
+	FClimbLimbIKState& Limb = Limbs[LimbIndex];
+	if(TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit)
+	{
+		Limb.TargetLocation = TraceDatum.OutHits[0].ImpactPoint;
+		Limb.bHasTarget = true;
+	}
+	else
+	{
+		Limb.bHasTarget = false;
+	}
+}
@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbIKSubsystem.h"
+
+#include "ClimbingSystem/ClimbIKComponent.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingMemory.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+void UClimbIKSubsystem::RegisterClimber(UClimbIKComponent* Climber)
+{
+	Climbers.AddUnique(Climber);
+}
+
+void UClimbIKSubsystem::UnregisterClimber(UClimbIKComponent* Climber)
+{
+	Climbers.RemoveSwap(Climber);
+	LastRefreshFrames.Remove(Climber);
+}
+
+bool UClimbIKSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UClimbIKSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbIKSubsystem, STATGROUP_Climbing);
+}
+
+void UClimbIKSubsystem::Tick(float DeltaTime)
+{
+	LLM_SCOPE_BYTAG(Climbing_IK);
+	SCOPE_CYCLE_COUNTER(STAT_ClimbIK_Schedule);
+
+	++FrameCounter;
+	Climbers.RemoveAllSwap([](const TWeakObjectPtr<UClimbIKComponent>& Climber) { return !Climber.IsValid(); });
+	for(auto It = LastRefreshFrames.CreateIterator(); It; ++It)
+	{
+		if(!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	TArray<FVector> ViewLocations;
+	GatherViewLocations(ViewLocations);
+
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	const float MaxDistanceSq = FMath::Square(Settings->IKMaxDistance);
+
+	struct FScheduledClimber
+	{
+		UClimbIKComponent* Climber;
+		float DistanceSq;
+		/** Frames since the last refresh in update intervals, past 1 when a budget ran out on its slot */
+		float Overdue;
+	};
+	TArray<FScheduledClimber, TInlineAllocator<64>> Scheduled;
+
+	int32 ActiveCount = 0;
+	int32 DegradedCount = 0;
+	for(const TWeakObjectPtr<UClimbIKComponent>& WeakClimber : Climbers)
+	{
+		UClimbIKComponent* Climber = WeakClimber.Get();
+		if(!Climber->WantsIK()) continue;
+
+		float ClosestDistanceSq = MAX_flt;
+		const FVector ClimberLocation = Climber->GetOwner()->GetActorLocation();
+		for(const FVector& ViewLocation : ViewLocations)
+		{
+			ClosestDistanceSq = FMath::Min(ClosestDistanceSq, FVector::DistSquared(ViewLocation, ClimberLocation));
+		}
+
+		// No viewer (dedicated server) or too far away: degrade to no IK
+		if(ClosestDistanceSq > MaxDistanceSq)
+		{
+			Climber->SetIKDegraded(true);
+			++DegradedCount;
+			continue;
+		}
+
+		Climber->SetIKDegraded(false);
+		++ActiveCount;
+
+		const uint32 UpdateInterval = GetUpdateInterval(ClosestDistanceSq);
+		const uint32* LastRefreshFrame = LastRefreshFrames.Find(WeakClimber);
+		const uint32 FramesSinceRefresh = LastRefreshFrame ? FrameCounter - *LastRefreshFrame : MAX_uint32;
+
+		// A phase from the climber itself staggers those sharing an interval and holds while others come and go.
+		// One that missed its slot for lack of budget stays due until it gets some
+		const uint32 Phase = GetTypeHash(Climber->GetUniqueID()) % UpdateInterval;
+		const bool bOnPhase = (FrameCounter + Phase) % UpdateInterval == 0;
+		if(!bOnPhase && FramesSinceRefresh <= UpdateInterval) continue;
+
+		Scheduled.Add({Climber, ClosestDistanceSq, (float)FramesSinceRefresh / UpdateInterval});
+	}
+
+	Scheduled.Sort([](const FScheduledClimber& A, const FScheduledClimber& B)
+	{
+		return A.Overdue != B.Overdue ? A.Overdue > B.Overdue : A.DistanceSq < B.DistanceSq;
+	});
+
+	int32 RemainingTraces = Settings->MaxIKLimbTracesPerFrame;
+	for(const FScheduledClimber& Due : Scheduled)
+	{
+		// Reused surface hits still refresh without budget, but only a refresh that could trace counts as one
+		if(RemainingTraces > 0)
+		{
+			LastRefreshFrames.Add(Due.Climber, FrameCounter);
+		}
+		RemainingTraces -= Due.Climber->RefreshLimbTargets(RemainingTraces);
+	}
+
+	SET_DWORD_STAT(STAT_ClimbIK_ActiveClimbers, ActiveCount);
+	SET_DWORD_STAT(STAT_ClimbIK_DegradedClimbers, DegradedCount);
+}
+
+void UClimbIKSubsystem::GatherViewLocations(TArray<FVector>& OutViewLocations) const
+{
+	for(FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if(!PlayerController || !PlayerController->IsLocalController()) continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		OutViewLocations.Add(ViewLocation);
+	}
+}
+
+int32 UClimbIKSubsystem::GetUpdateInterval(float DistanceSq) const
+{
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+
+	if(DistanceSq <= FMath::Square(Settings->IKFullRateDistance)) return 1;
+	if(DistanceSq <= FMath::Square(Settings->IKHalfRateDistance)) return 2;
+	if(DistanceSq <= FMath::Square(Settings->IKQuarterRateDistance)) return 4;
+	return 8;
+}
@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbInputLatency.h"
+
+#include "ClimbingSystem/ClimbingStats.h"
+#include "HAL/IConsoleManager.h"
+
+namespace ClimbInputLatencyCommands
+{
+	static FAutoConsoleCommand StartCommand(
+		TEXT("Climbing.InputLatency.Start"),
+		TEXT("Starts measuring input to motion latency of the traversal actions"),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FClimbInputLatency::Get().Start();
+			UE_LOG(LogClimbing, Display, TEXT("Climbing input latency recording"));
+		}));
+
+	static FAutoConsoleCommand StopCommand(
+		TEXT("Climbing.InputLatency.Stop"),
+		TEXT("Stops measuring input latency and logs p50/p95/p99 per traversal action"),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FClimbInputLatency::Get().Stop();
+			FClimbInputLatency::Get().LogReport(TEXT("Console"));
+		}));
+}
+
+FClimbInputStamp FClimbInputStamp::Now()
+{
+	FClimbInputStamp Stamp;
+	Stamp.Frame = GFrameCounter;
+	Stamp.Seconds = FPlatformTime::Seconds();
+	return Stamp;
+}
+
+FClimbInputLatency& FClimbInputLatency::Get()
+{
+	static FClimbInputLatency InputLatency;
+	return InputLatency;
+}
+
+void FClimbInputLatency::Start()
+{
+	check(IsInGameThread());
+
+	for(int32 Index = 0; Index < (int32)EClimbLatencyAction::Num; ++Index)
+	{
+		Samples[Index].Reset();
+		Unresolved[Index] = 0;
+	}
+	bRecording = true;
+}
+
+void FClimbInputLatency::Stop()
+{
+	bRecording = false;
+}
+
+void FClimbInputLatency::Resolve(FClimbInputStamp& Stamp)
+{
+	if(bRecording && Stamp.IsAwaitingMotion())
+	{
+		FSample Sample;
+		Sample.Frames = (uint32)(GFrameCounter - Stamp.Frame);
+		Sample.Milliseconds = (float)((FPlatformTime::Seconds() - Stamp.Seconds) * 1000.0);
+		Samples[(uint8)Stamp.Action].Add(Sample);
+	}
+	Stamp = FClimbInputStamp();
+}
+
+void FClimbInputLatency::Abandon(FClimbInputStamp& Stamp)
+{
+	if(bRecording && Stamp.IsAwaitingMotion())
+	{
+		++Unresolved[(uint8)Stamp.Action];
+	}
+	Stamp = FClimbInputStamp();
+}
+
+FClimbLatencyReport FClimbInputLatency::GetReport(EClimbLatencyAction Action) const
+{
+	const TArray<FSample>& ActionSamples = Samples[(uint8)Action];
+
+	FClimbLatencyReport Report;
+	Report.NumSamples = ActionSamples.Num();
+	Report.NumUnresolved = Unresolved[(uint8)Action];
+	if(ActionSamples.IsEmpty()) return Report;
+
+	TArray<uint32> Frames;
+	TArray<float> Milliseconds;
+	Frames.Reserve(ActionSamples.Num());
+	Milliseconds.Reserve(ActionSamples.Num());
+	for(const FSample& Sample : ActionSamples)
+	{
+		Frames.Add(Sample.Frames);
+		Milliseconds.Add(Sample.Milliseconds);
+	}
+	Frames.Sort();
+	Milliseconds.Sort();
+
+	const int32 NumSamples = ActionSamples.Num();
+	auto Rank = [NumSamples](int32 Percentile) { return FMath::Min(NumSamples - 1, (NumSamples * Percentile) / 100); };
+
+	Report.FramesP50 = Frames[Rank(50)];
+	Report.FramesP95 = Frames[Rank(95)];
+	Report.FramesP99 = Frames[Rank(99)];
+	Report.MillisecondsP50 = Milliseconds[Rank(50)];
+	Report.MillisecondsP95 = Milliseconds[Rank(95)];
+	Report.MillisecondsP99 = Milliseconds[Rank(99)];
+	return Report;
+}
+
+void FClimbInputLatency::LogReport(const FString& Label) const
+{
+	for(int32 Index = 0; Index < (int32)EClimbLatencyAction::Num; ++Index)
+	{
+		const EClimbLatencyAction Action = (EClimbLatencyAction)Index;
+		const FClimbLatencyReport Report = GetReport(Action);
+		if(Report.NumSamples == 0 && Report.NumUnresolved == 0) continue;
+
+		UE_LOG(LogClimbing, Display, TEXT("Climbing input latency %s %s: %d samples (%d unresolved), frames p50 %u p95 %u p99 %u, ms p50 %.2f p95 %.2f p99 %.2f"),
+			*Label, GetActionName(Action), Report.NumSamples, Report.NumUnresolved,
+			Report.FramesP50, Report.FramesP95, Report.FramesP99,
+			Report.MillisecondsP50, Report.MillisecondsP95, Report.MillisecondsP99);
+	}
+}
+
+const TCHAR* FClimbInputLatency::GetActionName(EClimbLatencyAction Action)
+{
+	switch(Action)
+	{
+	case EClimbLatencyAction::EnterClimb: return TEXT("EnterClimb");
+	case EClimbLatencyAction::ClimbDownLedge: return TEXT("ClimbDownLedge");
+	case EClimbLatencyAction::Vault: return TEXT("Vault");
+	case EClimbLatencyAction::WallRun: return TEXT("WallRun");
+	case EClimbLatencyAction::ExitClimb: return TEXT("ExitClimb");
+	case EClimbLatencyAction::ClimbMove: return TEXT("ClimbMove");
+	case EClimbLatencyAction::HangShimmy: return TEXT("HangShimmy");
+	default: return TEXT("Unknown");
+	}
+}
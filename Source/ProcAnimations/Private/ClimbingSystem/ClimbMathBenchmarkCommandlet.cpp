@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbMathBenchmarkCommandlet.h"
+
+#include "ClimbingSystem/ClimbMath.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "Misc/FileHelper.h"
+
+namespace ClimbMathBenchmark
+{
+	struct FInputs
+	{
+		TArray<FHitResult> Hits;
+		TArray<FVector> Locations;
+		TArray<FVector> Forwards;
+		TArray<FVector> SurfaceLocations;
+		TArray<FVector> SurfaceNormals;
+		TArray<FQuat> Rotations;
+		TArray<FVector> Velocities;
+	};
+
+	static void MakeInputs(int32 BatchSize, FInputs& Inputs)
+	{
+		FRandomStream Random(0x0C11B);
+
+		for(int32 Index = 0; Index < BatchSize; ++Index)
+		{
+			// Mostly wall like normals with some tilt so both slope branches get taken
+			const FVector SurfaceNormal = FVector(Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f), Random.FRandRange(-0.3f, 0.9f)).GetSafeNormal();
+
+			Inputs.Locations.Add(Random.GetUnitVector() * 500.f);
+			Inputs.Forwards.Add(-SurfaceNormal);
+			Inputs.SurfaceLocations.Add(Inputs.Locations.Last() - SurfaceNormal * Random.FRandRange(20.f, 60.f));
+			Inputs.SurfaceNormals.Add(SurfaceNormal);
+			Inputs.Rotations.Add(FRotator(Random.FRandRange(-90.f, 90.f), Random.FRandRange(-180.f, 180.f), 0.f).Quaternion());
+			Inputs.Velocities.Add(Random.GetUnitVector() * 100.f);
+
+			// A climb sweep usually returns a handful of hits
+			for(int32 HitIndex = 0; HitIndex < 4; ++HitIndex)
+			{
+				FHitResult& Hit = Inputs.Hits.AddDefaulted_GetRef();
+				Hit.ImpactPoint = Inputs.SurfaceLocations.Last() + Random.GetUnitVector() * 10.f;
+				Hit.ImpactNormal = (SurfaceNormal + Random.GetUnitVector() * 0.1f).GetSafeNormal();
+			}
+		}
+	}
+
+	/** Runs Kernel over the whole batch until at least MinCalls calls are made, returns ns per call */
+	template<typename KernelType>
+	static double TimeKernel(int32 BatchSize, int64 MinCalls, KernelType&& Kernel)
+	{
+		const int64 NumPasses = FMath::Max<int64>(1, MinCalls / BatchSize);
+
+		const double StartSeconds = FPlatformTime::Seconds();
+		for(int64 Pass = 0; Pass < NumPasses; ++Pass)
+		{
+			for(int32 Index = 0; Index < BatchSize; ++Index)
+			{
+				Kernel(Index);
+			}
+		}
+		const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+		return ElapsedSeconds * 1.0e9 / (double)(NumPasses * BatchSize);
+	}
+}
+
+UClimbMathBenchmarkCommandlet::UClimbMathBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UClimbMathBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace ClimbMathBenchmark;
+
+	int64 MinCalls = 2000000;
+	FParse::Value(*Params, TEXT("Iterations="), MinCalls);
+
+	FString CsvPath;
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+
+	static const int32 BatchSizes[] = { 1, 16, 256, 4096, 65536 };
+
+	// Written to from every kernel so the optimiser cannot drop the work
+	volatile float Sink = 0.f;
+
+	TArray<FString> CsvLines;
+	CsvLines.Add(TEXT("Kernel,BatchSize,NsPerCall,MCallsPerSecond"));
+
+	auto Report = [&CsvLines](const TCHAR* KernelName, int32 BatchSize, double NsPerCall)
+	{
+		const double MCallsPerSecond = NsPerCall > 0.0 ? 1000.0 / NsPerCall : 0.0;
+		UE_LOG(LogClimbing, Display, TEXT("%-28s batch %6d: %8.2f ns/call  %8.2f Mcalls/s"), KernelName, BatchSize, NsPerCall, MCallsPerSecond);
+		CsvLines.Add(FString::Printf(TEXT("%s,%d,%.3f,%.3f"), KernelName, BatchSize, NsPerCall, MCallsPerSecond));
+	};
+
+	for(const int32 BatchSize : BatchSizes)
+	{
+		FInputs Inputs;
+		MakeInputs(BatchSize, Inputs);
+
+		Report(TEXT("AverageSurfaceHits"), BatchSize, TimeKernel(BatchSize, MinCalls, [&](int32 Index)
+		{
+			FVector Location, Normal;
+			ClimbMath::AverageSurfaceHits(TConstArrayView<FHitResult>(&Inputs.Hits[Index * 4], 4), Location, Normal);
+			Sink = Sink + Normal.X;
+		}));
+
+		Report(TEXT("SlopeTest_Acos (baseline)"), BatchSize, TimeKernel(BatchSize, MinCalls, [&](int32 Index)
+		{
+			Sink = Sink + ClimbMath::IsSlopeTooFlatToClimb_Acos(Inputs.SurfaceNormals[Index], 60.f);
+		}));
+
+		Report(TEXT("SlopeTest_Dot"), BatchSize, TimeKernel(BatchSize, MinCalls, [&](int32 Index)
+		{
+			Sink = Sink + ClimbMath::IsSlopeTooFlatToClimb(Inputs.SurfaceNormals[Index], ClimbMath::DefaultStopClimbSlopeCos);
+		}));
+
+		Report(TEXT("ComputeClimbRotation"), BatchSize, TimeKernel(BatchSize, MinCalls, [&](int32 Index)
+		{
+			Sink = Sink + ClimbMath::ComputeClimbRotation(Inputs.Rotations[Index], Inputs.SurfaceNormals[Index], 1.f / 60.f, 5.f).W;
+		}));
+
+		Report(TEXT("ComputeSnapVector"), BatchSize, TimeKernel(BatchSize, MinCalls, [&](int32 Index)
+		{
+			Sink = Sink + ClimbMath::ComputeSnapVector(Inputs.Locations[Index], Inputs.Forwards[Index],
+				Inputs.SurfaceLocations[Index], Inputs.SurfaceNormals[Index]).X;
+		}));
+
+		Report(TEXT("UnrotateClimbVelocity"), BatchSize, TimeKernel(BatchSize, MinCalls, [&](int32 Index)
+		{
+			Sink = Sink + ClimbMath::UnrotateClimbVelocity(Inputs.Rotations[Index], Inputs.Velocities[Index]).Z;
+		}));
+	}
+
+	if(!CsvPath.IsEmpty())
+	{
+		FFileHelper::SaveStringArrayToFile(CsvLines, *CsvPath);
+	}
+
+	return 0;
+}
@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbMoveValidation.h"
+
+const TCHAR* LexToString(EClimbMoveVerdict Verdict)
+{
+	switch(Verdict)
+	{
+	case EClimbMoveVerdict::Valid: return TEXT("Valid");
+	case EClimbMoveVerdict::Expired: return TEXT("Expired");
+	case EClimbMoveVerdict::NeedsGeometry: return TEXT("NeedsGeometry");
+	case EClimbMoveVerdict::TooFast: return TEXT("TooFast");
+	case EClimbMoveVerdict::OffSurface: return TEXT("OffSurface");
+	case EClimbMoveVerdict::TraversalOvershoot: return TEXT("TraversalOvershoot");
+	case EClimbMoveVerdict::NoClimbableGeometry: return TEXT("NoClimbableGeometry");
+	default: return TEXT("Unknown");
+	}
+}
+
+FVector FClimbTransformSample::GetAnchorLocation() const
+{
+	return GetLocation() + FVector(AnchorOffset[0], AnchorOffset[1], AnchorOffset[2]);
+}
+
+FVector FClimbTransformSample::GetAnchorNormal() const
+{
+	return FVector(AnchorNormal[0], AnchorNormal[1], AnchorNormal[2]).GetSafeNormal();
+}
+
+FVector FClimbTransformSample::GetForward() const
+{
+	return FRotator(0.f, FRotator::DecompressAxisFromShort(Yaw), 0.f).Vector();
+}
+
+FClimbTransformSample FClimbTransformSample::Make(float Time, const FVector& Location, float Yaw, bool bClimbing, bool bRootMotion,
+	const FVector* SurfaceLocation, const FVector* SurfaceNormal)
+{
+	FClimbTransformSample Sample;
+	Sample.Time = Time;
+	Sample.Location = FVector3f(Location);
+	Sample.Yaw = FRotator::CompressAxisToShort(Yaw);
+	Sample.Flags = (uint8)((bClimbing ? Climbing : 0) | (bRootMotion ? RootMotion : 0));
+
+	if(SurfaceLocation && SurfaceNormal && !SurfaceNormal->IsNearlyZero())
+	{
+		const FVector Offset = *SurfaceLocation - Location;
+		for(int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			Sample.AnchorOffset[Axis] = (int16)FMath::Clamp(FMath::RoundToInt(Offset[Axis]), -MAX_int16, MAX_int16);
+			Sample.AnchorNormal[Axis] = (int8)FMath::Clamp(FMath::RoundToInt((*SurfaceNormal)[Axis] * 127.f), -127, 127);
+		}
+		Sample.Flags |= HasAnchor;
+	}
+
+	return Sample;
+}
+
+void FClimbMoveHistory::Init(int32 Capacity)
+{
+	Samples.SetNumZeroed(FMath::Max(Capacity, 2));
+	NextSequence = 1;
+	SimulatedTime = 0.f;
+	ClearPreviousClaim();
+}
+
+uint32 FClimbMoveHistory::Record(float DeltaTime, const FVector& Location, float Yaw, bool bClimbing, bool bRootMotion,
+	const FVector* SurfaceLocation, const FVector* SurfaceNormal)
+{
+	SimulatedTime += DeltaTime;
+
+	const uint32 Sequence = NextSequence++;
+	Samples[Sequence % Samples.Num()] = FClimbTransformSample::Make(SimulatedTime, Location, Yaw, bClimbing, bRootMotion, SurfaceLocation, SurfaceNormal);
+	return Sequence;
+}
+
+const FClimbTransformSample* FClimbMoveHistory::FindBySequence(uint32 Sequence) const
+{
+	if(Sequence == 0 || Sequence >= NextSequence) return nullptr;
+	if(NextSequence - Sequence > (uint32)Samples.Num()) return nullptr;
+
+	return &Samples[Sequence % Samples.Num()];
+}
+
+void FClimbMoveHistory::NoteClaim(const FClimbMoveClaim& Claim, float Time)
+{
+	LastClaimLocation = Claim.ClaimedLocation;
+	LastClaimTime = Time;
+}
+
+void FClimbMoveHistory::DecaySuspicion(double Now, float Decay)
+{
+	Suspicion = FMath::Max(0.f, Suspicion - Decay * (float)(Now - SuspicionTime));
+	SuspicionTime = Now;
+
+	if(Suspicion <= 0.f) bFlagged = false;
+}
+
+bool FClimbMoveHistory::AddSuspicion(double Now, float Decay, float FlagThreshold)
+{
+	DecaySuspicion(Now, Decay);
+	Suspicion += 1.f;
+
+	if(bFlagged || Suspicion < FlagThreshold) return false;
+
+	bFlagged = true;
+	return true;
+}
+
+void FClimbMoveHistory::ForceFlag(double Now, float Decay, float Seconds)
+{
+	Suspicion = 1.f + Decay * Seconds;
+	SuspicionTime = Now;
+	bFlagged = true;
+}
+
+void FClimbMoveHistory::ClearSuspicion()
+{
+	Suspicion = 0.f;
+	bFlagged = false;
+}
+
+EClimbMoveVerdict FClimbMoveValidator::CheckClaim(const FClimbMoveHistory& History, const FClimbMoveClaim& Claim,
+	const FClimbMoveValidationParams& Params, FVector& OutProbeDirection)
+{
+	const FClimbTransformSample* AtClaim = History.FindBySequence(Claim.Sequence);
+	if(!AtClaim) return EClimbMoveVerdict::Expired;
+
+	const bool bRootMotion = AtClaim->HasFlag(FClimbTransformSample::RootMotion);
+
+	// No faster than the climb, or a traversal montage, could have carried it since the last claim
+	if(History.HasPreviousClaim() && !Claim.bStartsClimb)
+	{
+		const float ElapsedTime = AtClaim->Time - History.GetPreviousClaimTime();
+		const float AllowedSpeed = bRootMotion ? Params.RootMotionSpeed : Params.MaxClimbSpeed;
+		const float AllowedDistance = AllowedSpeed * FMath::Max(ElapsedTime, 0.f) * Params.SpeedSlack + Params.Tolerance;
+
+		if(FVector::DistSquared(Claim.ClaimedLocation, History.GetPreviousClaimLocation()) > FMath::Square(AllowedDistance))
+		{
+			return EClimbMoveVerdict::TooFast;
+		}
+	}
+
+	const int32 Capacity = History.Samples.Num();
+	const uint32 OldestSequence = History.NextSequence > (uint32)Capacity ? History.NextSequence - Capacity : 1;
+
+	// Traversal montages leave the wall, bound them by how far one can carry from where it started
+	if(bRootMotion)
+	{
+		for(uint32 Sequence = Claim.Sequence; Sequence >= OldestSequence && Sequence > 0; --Sequence)
+		{
+			const FClimbTransformSample& Sample = History.Samples[Sequence % Capacity];
+			if(Sample.HasFlag(FClimbTransformSample::RootMotion)) continue;
+
+			const bool bOvershoot = FVector::DistSquared(Claim.ClaimedLocation, Sample.GetLocation()) > FMath::Square(Params.MaxTraversalDisplacement);
+			return bOvershoot ? EClimbMoveVerdict::TraversalOvershoot : EClimbMoveVerdict::Valid;
+		}
+
+		// The whole history is one traversal, it has been going on for too long to still be a montage
+		return EClimbMoveVerdict::TraversalOvershoot;
+	}
+
+	// Otherwise the climber has to be within reach of a surface the server itself found recently
+	for(uint32 Sequence = Claim.Sequence; Sequence >= OldestSequence && Sequence > 0; --Sequence)
+	{
+		const FClimbTransformSample& Sample = History.Samples[Sequence % Capacity];
+		const float SampleAge = AtClaim->Time - Sample.Time;
+		if(SampleAge > Params.AnchorWindow) break;
+		if(!Sample.HasFlag(FClimbTransformSample::HasAnchor)) continue;
+
+		const FVector AnchorNormal = Sample.GetAnchorNormal();
+		const FVector ToClaim = Claim.ClaimedLocation - Sample.GetAnchorLocation();
+
+		const float PlaneDistance = FMath::Abs(FVector::DotProduct(ToClaim, AnchorNormal));
+		const float LateralDistance = FVector::VectorPlaneProject(ToClaim, AnchorNormal).Size();
+		const float LateralReach = Params.AnchorReach + Params.MaxClimbSpeed * SampleAge * Params.SpeedSlack;
+
+		if(PlaneDistance > Params.AnchorReach || LateralDistance > LateralReach)
+		{
+			return EClimbMoveVerdict::OffSurface;
+		}
+		return EClimbMoveVerdict::Valid;
+	}
+
+	OutProbeDirection = AtClaim->GetForward();
+	return EClimbMoveVerdict::NeedsGeometry;
+}
@@ -0,0 +1,218 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbMoveValidationBenchmarkCommandlet.h"
+
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbMoveValidation.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "Misc/FileHelper.h"
+
+namespace ClimbMoveValidationBenchmark
+{
+	/** A client climbing a wall facing -X, with the odd traversal montage and the odd teleport */
+	struct FSimulatedClient
+	{
+		FClimbMoveHistory History;
+		FVector Location = FVector::ZeroVector;
+		FVector Velocity = FVector::ZeroVector;
+		float TraversalTimeLeft = 0.f;
+		bool bClimbing = false;
+	};
+
+	struct FQueuedClaim
+	{
+		int32 ClientIndex;
+		FClimbMoveClaim Claim;
+		bool bCheat;
+	};
+
+	struct FTotals
+	{
+		int64 Claims = 0;
+		int64 Cheats = 0;
+		int64 CheatsCaught = 0;
+		int64 CheatsMissed = 0;
+		int64 FalsePositives = 0;
+		int64 NeedsGeometry = 0;
+		int64 Expired = 0;
+		int32 MaxBacklog = 0;
+	};
+}
+
+UClimbMoveValidationBenchmarkCommandlet::UClimbMoveValidationBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UClimbMoveValidationBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace ClimbMoveValidationBenchmark;
+
+	int32 NumClients = 100;
+	float Seconds = 30.f;
+	float TickRate = 60.f;
+	float CheatRate = 0.002f;
+	FParse::Value(*Params, TEXT("Clients="), NumClients);
+	FParse::Value(*Params, TEXT("Seconds="), Seconds);
+	FParse::Value(*Params, TEXT("TickRate="), TickRate);
+	FParse::Value(*Params, TEXT("CheatRate="), CheatRate);
+
+	FString CsvPath;
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	const float DeltaTime = 1.f / FMath::Max(TickRate, 1.f);
+	const int32 NumFrames = FMath::CeilToInt(Seconds * TickRate);
+	const uint64 BudgetCycles = (uint64)(Settings->ClimbValidationBudgetMs / (1000.0 * FPlatformTime::GetSecondsPerCycle64()));
+
+	FClimbMoveValidationParams ValidationParams;
+	ValidationParams.MaxClimbSpeed = 100.f;
+	ValidationParams.RootMotionSpeed = Settings->ClimbValidationRootMotionSpeed;
+	ValidationParams.SpeedSlack = Settings->ClimbValidationSpeedSlack;
+	ValidationParams.Tolerance = Settings->ClimbValidationTolerance;
+	ValidationParams.AnchorReach = Settings->ClimbValidationAnchorReach;
+	ValidationParams.AnchorWindow = Settings->ClimbValidationAnchorWindow;
+	ValidationParams.MaxTraversalDisplacement = Settings->ClimbValidationMaxTraversalDisplacement;
+
+	static constexpr float SurfaceDistance = 45.f;
+	static constexpr float TraversalSpeed = 500.f;
+	static constexpr float TraversalDuration = 0.6f;
+	const FVector SurfaceNormal = FVector::ForwardVector;
+
+	FRandomStream Random(0x0C11B);
+
+	TArray<FSimulatedClient> Clients;
+	Clients.SetNum(NumClients);
+	for(int32 ClientIndex = 0; ClientIndex < NumClients; ++ClientIndex)
+	{
+		Clients[ClientIndex].History.Init(Settings->ClimbMoveHistoryLength);
+		Clients[ClientIndex].Location = FVector(ClientIndex * 500.f, 0.f, 200.f);
+	}
+
+	TArray<FQueuedClaim> Queue;
+	int32 QueueHead = 0;
+	FTotals Totals;
+	TArray<double> FrameMs;
+	FrameMs.Reserve(NumFrames);
+
+	for(int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		// The server simulates every client's move and receives its claim, as ServerCheckClientError would
+		for(int32 ClientIndex = 0; ClientIndex < NumClients; ++ClientIndex)
+		{
+			FSimulatedClient& Client = Clients[ClientIndex];
+			const bool bStartsClimb = !Client.bClimbing;
+			Client.bClimbing = true;
+
+			if(Client.TraversalTimeLeft <= 0.f && Random.FRand() < DeltaTime * 0.2f)
+			{
+				Client.TraversalTimeLeft = TraversalDuration;
+				Client.Velocity = FVector(-0.5f, 0.f, 1.f).GetSafeNormal() * TraversalSpeed;
+			}
+			else if(Client.TraversalTimeLeft <= 0.f && Random.FRand() < DeltaTime * 2.f)
+			{
+				Client.Velocity = FVector(0.f, Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f)).GetClampedToMaxSize(1.f) * ValidationParams.MaxClimbSpeed;
+			}
+
+			const bool bRootMotion = Client.TraversalTimeLeft > 0.f;
+			Client.Location += Client.Velocity * DeltaTime;
+			Client.TraversalTimeLeft -= DeltaTime;
+			if(bRootMotion && Client.TraversalTimeLeft <= 0.f) Client.Velocity = FVector::ZeroVector;
+
+			const FVector SurfaceLocation = Client.Location - SurfaceNormal * SurfaceDistance;
+			const uint32 Sequence = Client.History.Record(DeltaTime, Client.Location, 180.f, true, bRootMotion,
+				bRootMotion ? nullptr : &SurfaceLocation, bRootMotion ? nullptr : &SurfaceNormal);
+
+			FQueuedClaim& Queued = Queue.AddDefaulted_GetRef();
+			Queued.ClientIndex = ClientIndex;
+			Queued.Claim.Sequence = Sequence;
+			Queued.Claim.ClaimedLocation = Client.Location + Random.GetUnitVector() * 2.f;
+			Queued.Claim.bStartsClimb = bStartsClimb;
+			Queued.bCheat = Random.FRand() < CheatRate;
+
+			if(Queued.bCheat)
+			{
+				// The client teleports and, trusted or not, carries on from there
+				Queued.Claim.ClaimedLocation += FVector(0.f, Random.FRandRange(-1.f, 1.f), Random.FRandRange(0.5f, 1.f)).GetSafeNormal() * Random.FRandRange(300.f, 1000.f);
+				Client.Location = Queued.Claim.ClaimedLocation;
+				++Totals.Cheats;
+			}
+		}
+
+		// Then validates as much of the backlog as the budget allows, like the subsystem tick
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		while(QueueHead < Queue.Num() && FPlatformTime::Cycles64() - StartCycles < BudgetCycles)
+		{
+			const FQueuedClaim& Queued = Queue[QueueHead++];
+			FClimbMoveHistory& History = Clients[Queued.ClientIndex].History;
+
+			FVector ProbeDirection;
+			const EClimbMoveVerdict Verdict = FClimbMoveValidator::CheckClaim(History, Queued.Claim, ValidationParams, ProbeDirection);
+			++Totals.Claims;
+
+			if(Verdict == EClimbMoveVerdict::Expired)
+			{
+				++Totals.Expired;
+				History.ClearPreviousClaim();
+				continue;
+			}
+			History.NoteClaim(Queued.Claim, History.FindBySequence(Queued.Claim.Sequence)->Time);
+
+			if(Verdict == EClimbMoveVerdict::NeedsGeometry) ++Totals.NeedsGeometry;
+
+			const bool bSuspicious = FClimbMoveValidator::IsSuspicious(Verdict);
+			if(Queued.bCheat)
+			{
+				++(bSuspicious ? Totals.CheatsCaught : Totals.CheatsMissed);
+			}
+			else if(bSuspicious)
+			{
+				++Totals.FalsePositives;
+			}
+		}
+		FrameMs.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+
+		if(QueueHead == Queue.Num())
+		{
+			Queue.Reset();
+			QueueHead = 0;
+		}
+		Totals.MaxBacklog = FMath::Max(Totals.MaxBacklog, Queue.Num() - QueueHead);
+	}
+
+	FrameMs.Sort();
+	const double MedianMs = FrameMs.IsEmpty() ? 0.0 : FrameMs[FrameMs.Num() / 2];
+	const double P99Ms = FrameMs.IsEmpty() ? 0.0 : FrameMs[FMath::Min(FrameMs.Num() - 1, FrameMs.Num() * 99 / 100)];
+	const double MaxMs = FrameMs.IsEmpty() ? 0.0 : FrameMs.Last();
+
+	UE_LOG(LogClimbing, Display, TEXT("%d clients, %d frames at %.0f Hz, budget %.3f ms"), NumClients, NumFrames, TickRate, Settings->ClimbValidationBudgetMs);
+	UE_LOG(LogClimbing, Display, TEXT("Validation ms per frame: median %.4f  p99 %.4f  max %.4f"), MedianMs, P99Ms, MaxMs);
+	UE_LOG(LogClimbing, Display, TEXT("Claims validated %lld, expired %lld, needing geometry %lld, max backlog %d"),
+		Totals.Claims, Totals.Expired, Totals.NeedsGeometry, Totals.MaxBacklog);
+	UE_LOG(LogClimbing, Display, TEXT("Cheats %lld: caught %lld, missed %lld. False positives %lld"),
+		Totals.Cheats, Totals.CheatsCaught, Totals.CheatsMissed, Totals.FalsePositives);
+
+	if(!CsvPath.IsEmpty())
+	{
+		TArray<FString> CsvLines;
+		CsvLines.Add(TEXT("Clients,TickRate,BudgetMs,MedianMs,P99Ms,MaxMs,Claims,Expired,NeedsGeometry,MaxBacklog,Cheats,Caught,Missed,FalsePositives"));
+		CsvLines.Add(FString::Printf(TEXT("%d,%.0f,%.3f,%.4f,%.4f,%.4f,%lld,%lld,%lld,%d,%lld,%lld,%lld,%lld"),
+			NumClients, TickRate, Settings->ClimbValidationBudgetMs, MedianMs, P99Ms, MaxMs, Totals.Claims, Totals.Expired,
+			Totals.NeedsGeometry, Totals.MaxBacklog, Totals.Cheats, Totals.CheatsCaught, Totals.CheatsMissed, Totals.FalsePositives));
+		FFileHelper::SaveStringArrayToFile(CsvLines, *CsvPath);
+	}
+
+	// One claim may start just before the budget runs out, allow for it
+	const bool bOverBudget = MaxMs > Settings->ClimbValidationBudgetMs + 0.05;
+	if(Totals.FalsePositives > 0 || Totals.CheatsMissed > 0 || bOverBudget)
+	{
+		UE_LOG(LogClimbing, Error, TEXT("Climb move validation benchmark failed"));
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,287 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbMoveValidationSubsystem.h"
+
+#include "ClimbingSystem/ClimbingCharacter.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingMemory.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "ClimbingSystem/CustomMovementComponent.h"
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "TimerManager.h"
+#include "UObject/UObjectIterator.h"
+
+namespace ClimbMoveValidation
+{
+	static FAutoConsoleCommandWithWorldAndArgs ReportCommand(
+		TEXT("Climbing.Validation.Report"),
+		TEXT("Logs climb move validation totals, the pending backlog and the most expensive validation frame"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(!World) return;
+
+			if(const UClimbMoveValidationSubsystem* ValidationSubsystem = World->GetSubsystem<UClimbMoveValidationSubsystem>())
+			{
+				ValidationSubsystem->LogValidationReport();
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs CheckFlaggedCorrectionCommand(
+		TEXT("Climbing.Validation.CheckFlaggedCorrection"),
+		TEXT("Run on a server while clients climb. Flags every remote climber for the given seconds (default 5) and checks each of their climb moves got corrected. Add quit to exit with the result"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(!World) return;
+
+			if(UClimbMoveValidationSubsystem* ValidationSubsystem = World->GetSubsystem<UClimbMoveValidationSubsystem>())
+			{
+				ValidationSubsystem->StartFlaggedCorrectionCheck(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 5.f, Args.Contains(TEXT("quit")));
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs DriveLocalClimberCommand(
+		TEXT("Climbing.Validation.DriveLocalClimber"),
+		TEXT("Run on a client facing a climbable wall. Presses climb through the move stream, then climbs up and down for the given seconds (default 10), for CheckFlaggedCorrection on the server"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+			AClimbingCharacter* Climber = PlayerController ? Cast<AClimbingCharacter>(PlayerController->GetPawn()) : nullptr;
+			if(!Climber)
+			{
+				UE_LOG(LogClimbing, Error, TEXT("DriveLocalClimber needs a locally controlled climbing character"));
+				return;
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			const double EndTime = StartTime + FMath::Max(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 10.f, 1.f);
+			Climber->InjectClimbAction();
+
+			TWeakObjectPtr<AClimbingCharacter> WeakClimber = Climber;
+			FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakClimber, StartTime, EndTime](float)
+			{
+				AClimbingCharacter* DrivenClimber = WeakClimber.Get();
+				const double Now = FPlatformTime::Seconds();
+				if(!DrivenClimber || Now >= EndTime) return false;
+
+				// Up and down keeps the climber on the same stretch of wall for the whole run
+				DrivenClimber->InjectMoveInput(FVector2D(0.f, FMath::Sin((Now - StartTime) * PI * 0.5) >= 0.0 ? 1.f : -1.f));
+				return true;
+			}));
+		}));
+}
+
+bool UClimbMoveValidationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UClimbMoveValidationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbMoveValidationSubsystem, STATGROUP_Climbing);
+}
+
+void UClimbMoveValidationSubsystem::SubmitClaim(UCustomMovementComponent* Climber, const FClimbMoveClaim& Claim)
+{
+	LLM_SCOPE_BYTAG(Climbing_Validation);
+
+	// A full queue sheds its oldest claims, they are the likeliest to have expired anyway
+	const int32 MaxPendingClaims = UClimbingSettings::Get()->ClimbValidationMaxPendingClaims;
+	if(PendingClaims.Num() - PendingHead >= MaxPendingClaims)
+	{
+		++PendingHead;
+		++TotalDropped;
+		INC_DWORD_STAT(STAT_ClimbValidation_Dropped);
+	}
+
+	PendingClaims.Add({Climber, Claim});
+}
+
+void UClimbMoveValidationSubsystem::Tick(float DeltaTime)
+{
+	const ENetMode NetMode = GetWorld()->GetNetMode();
+	if(NetMode == NM_Client || NetMode == NM_Standalone) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_ClimbValidation_Update);
+
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	const uint64 BudgetCycles = (uint64)(Settings->ClimbValidationBudgetMs / (1000.0 * FPlatformTime::GetSecondsPerCycle64()));
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	int32 NumValidated = 0;
+	while(PendingHead < PendingClaims.Num() && FPlatformTime::Cycles64() - StartCycles < BudgetCycles)
+	{
+		const FPendingClaim Pending = PendingClaims[PendingHead++];
+		if(UCustomMovementComponent* Climber = Pending.Climber.Get())
+		{
+			ValidateClaim(Climber, Pending.Claim);
+			++NumValidated;
+		}
+	}
+
+	if(PendingHead == PendingClaims.Num())
+	{
+		PendingClaims.Reset();
+		PendingHead = 0;
+	}
+	else if(PendingHead > PendingClaims.Num() / 2)
+	{
+		PendingClaims.RemoveAt(0, PendingHead, false);
+		PendingHead = 0;
+	}
+
+	const double FrameMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+	MaxFrameMs = FMath::Max(MaxFrameMs, FrameMs);
+
+	INC_DWORD_STAT_BY(STAT_ClimbValidation_Claims, NumValidated);
+	SET_DWORD_STAT(STAT_ClimbValidation_Pending, PendingClaims.Num() - PendingHead);
+}
+
+EClimbMoveVerdict UClimbMoveValidationSubsystem::ValidateClaim(UCustomMovementComponent* Climber, const FClimbMoveClaim& Claim)
+{
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	const FClimbMoveValidationParams Params = Climber->GetClimbMoveValidationParams();
+	FClimbMoveHistory& History = Climber->GetClimbMoveHistory();
+	++TotalClaims;
+
+	FVector ProbeDirection = FVector::ZeroVector;
+	EClimbMoveVerdict Verdict = FClimbMoveValidator::CheckClaim(History, Claim, Params, ProbeDirection);
+
+	if(Verdict == EClimbMoveVerdict::Expired)
+	{
+		++TotalExpired;
+		INC_DWORD_STAT(STAT_ClimbValidation_Expired);
+		History.ClearPreviousClaim();
+		return Verdict;
+	}
+
+	// The server never saw a surface here, one trace settles whether there is one to hold on to
+	if(Verdict == EClimbMoveVerdict::NeedsGeometry)
+	{
+		++TotalGeometryTraces;
+		INC_DWORD_STAT(STAT_ClimbValidation_GeometryTraces);
+
+		FHitResult Hit;
+		const FVector TraceEnd = Claim.ClaimedLocation + ProbeDirection * Params.AnchorReach;
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbMoveValidation), false, Climber->GetOwner());
+		const bool bHit = GetWorld()->LineTraceSingleByObjectType(Hit, Claim.ClaimedLocation, TraceEnd, Climber->GetClimbableSurfaceObjectQueryParams(), QueryParams);
+		Verdict = bHit ? EClimbMoveVerdict::Valid : EClimbMoveVerdict::NoClimbableGeometry;
+	}
+
+	History.NoteClaim(Claim, History.FindBySequence(Claim.Sequence)->Time);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if(!FClimbMoveValidator::IsSuspicious(Verdict))
+	{
+		if(History.IsFlagged()) History.DecaySuspicion(Now, Settings->ClimbValidationSuspicionDecay);
+		return Verdict;
+	}
+
+	++TotalSuspicious;
+	INC_DWORD_STAT(STAT_ClimbValidation_Suspicious);
+
+	if(History.AddSuspicion(Now, Settings->ClimbValidationSuspicionDecay, Settings->ClimbValidationFlagThreshold))
+	{
+		++TotalFlagged;
+		UE_LOG(LogClimbing, Warning, TEXT("%s flagged for suspicious climb moves, last one %s at %s"),
+			*GetNameSafe(Climber->GetOwner()), LexToString(Verdict), *Claim.ClaimedLocation.ToCompactString());
+	}
+
+	OnSuspiciousClimbMove.Broadcast(Climber, Verdict, Claim.ClaimedLocation);
+	return Verdict;
+}
+
+void UClimbMoveValidationSubsystem::StartFlaggedCorrectionCheck(float Seconds, bool bQuitWhenDone)
+{
+	UWorld* World = GetWorld();
+	if(World->GetNetMode() == NM_Client || World->GetNetMode() == NM_Standalone)
+	{
+		UE_LOG(LogClimbing, Error, TEXT("Flagged correction check needs a server with remote climbers"));
+		return;
+	}
+
+	if(!FlaggedCorrectionChecks.IsEmpty())
+	{
+		UE_LOG(LogClimbing, Warning, TEXT("Flagged correction check already running"));
+		return;
+	}
+
+	Seconds = FMath::Max(Seconds, 1.f);
+	const double Now = World->GetTimeSeconds();
+	const float Decay = UClimbingSettings::Get()->ClimbValidationSuspicionDecay;
+
+	for(TObjectIterator<UCustomMovementComponent> It; It; ++It)
+	{
+		UCustomMovementComponent* Climber = *It;
+		if(Climber->GetWorld() != World || !Climber->GetClimbMoveHistory().IsInitialized()) continue;
+
+		FClimbMoveHistory& History = Climber->GetClimbMoveHistory();
+		History.ForceFlag(Now, Decay, Seconds);
+		FlaggedCorrectionChecks.Add({Climber, History.GetFlaggedClaims(), History.GetOnWallFlaggedClaims(), History.GetForcedCorrections()});
+	}
+
+	if(FlaggedCorrectionChecks.IsEmpty())
+	{
+		UE_LOG(LogClimbing, Error, TEXT("Flagged correction check found no remotely controlled climbers"));
+		if(bQuitWhenDone) FPlatformMisc::RequestExitWithStatus(false, 1);
+		return;
+	}
+
+	bQuitAfterFlaggedCorrectionCheck = bQuitWhenDone;
+	UE_LOG(LogClimbing, Display, TEXT("Flagged %d climbers for %.1f s, keep them climbing"), FlaggedCorrectionChecks.Num(), Seconds);
+	World->GetTimerManager().SetTimer(FlaggedCorrectionCheckTimer, this, &UClimbMoveValidationSubsystem::FinishFlaggedCorrectionCheck, Seconds);
+}
+
+void UClimbMoveValidationSubsystem::FinishFlaggedCorrectionCheck()
+{
+	uint32 TotalFlaggedClaims = 0;
+	uint32 TotalOnWallClaims = 0;
+	bool bFailed = false;
+
+	for(const FFlaggedCorrectionCheck& Check : FlaggedCorrectionChecks)
+	{
+		UCustomMovementComponent* Climber = Check.Climber.Get();
+		if(!Climber) continue;
+
+		FClimbMoveHistory& History = Climber->GetClimbMoveHistory();
+		const uint32 Claims = History.GetFlaggedClaims() - Check.StartClaims;
+		const uint32 Corrections = History.GetForcedCorrections() - Check.StartCorrections;
+		History.ClearSuspicion();
+
+		TotalFlaggedClaims += Claims;
+		TotalOnWallClaims += History.GetOnWallFlaggedClaims() - Check.StartOnWallClaims;
+		if(Corrections < Claims)
+		{
+			bFailed = true;
+			UE_LOG(LogClimbing, Error, TEXT("%s sent %u climb moves while flagged but was only corrected %u times"),
+				*GetNameSafe(Climber->GetOwner()), Claims, Corrections);
+		}
+	}
+	FlaggedCorrectionChecks.Reset();
+
+	// Without the server's own climber on the wall the climb never went through the move stream, the corrections prove nothing
+	if(TotalOnWallClaims == 0)
+	{
+		bFailed = true;
+		UE_LOG(LogClimbing, Error, TEXT("Flagged correction check saw %u climb moves but none while the server had the climber on the wall"), TotalFlaggedClaims);
+	}
+
+	UE_LOG(LogClimbing, Display, TEXT("Flagged correction check %s over %u climb moves, %u of them on the wall on the server"),
+		bFailed ? TEXT("FAILED") : TEXT("passed"), TotalFlaggedClaims, TotalOnWallClaims);
+
+	if(bQuitAfterFlaggedCorrectionCheck)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bFailed ? 1 : 0);
+	}
+}
+
+void UClimbMoveValidationSubsystem::LogValidationReport() const
+{
+	UE_LOG(LogClimbing, Display, TEXT("Climb move validation: %llu claims, %llu suspicious, %llu geometry traces, %llu expired, %llu dropped, %llu flags raised"),
+		TotalClaims, TotalSuspicious, TotalGeometryTraces, TotalExpired, TotalDropped, TotalFlagged);
+	UE_LOG(LogClimbing, Display, TEXT("Climb move validation: %d pending, most expensive frame %.3f ms of a %.3f ms budget"),
+		PendingClaims.Num() - PendingHead, MaxFrameMs, UClimbingSettings::Get()->ClimbValidationBudgetMs);
+}
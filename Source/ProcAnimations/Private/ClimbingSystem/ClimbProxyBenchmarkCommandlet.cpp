@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbProxyBenchmarkCommandlet.h"
+
+#include "ClimbingSystem/ClimbProxyBuilder.h"
+#include "ClimbingSystem/ClimbProxyComponent.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Misc/FileHelper.h"
+
+namespace ClimbProxyBenchmark
+{
+	/** A query the climbing component would make, from just off a wall straight into it */
+	struct FProbe
+	{
+		FVector Start;
+		FVector End;
+	};
+
+	struct FResult
+	{
+		double Microseconds = 0.0;
+		int32 Hits = 0;
+	};
+
+	static constexpr float ProbeStandOff = 60.f;
+	static constexpr float ProbeReach = 120.f;
+	static constexpr float CapsuleRadius = 50.f;
+	static constexpr float CapsuleHalfHeight = 72.f;
+	static constexpr float AgreementTolerance = 10.f;
+
+	/** Runs every probe as a sweep or a line and keeps where each hit, NaN for a miss */
+	static FResult RunProbes(UWorld& World, const TArray<FProbe>& Probes, bool bSweep, const FCollisionObjectQueryParams& ObjectParams,
+		const FCollisionQueryParams& QueryParams, TArray<float>& OutHitDistances)
+	{
+		OutHitDistances.SetNumUninitialized(Probes.Num());
+		const FCollisionShape Capsule = FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight);
+
+		FResult Result;
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		for(int32 ProbeIndex = 0; ProbeIndex < Probes.Num(); ++ProbeIndex)
+		{
+			const FProbe& Probe = Probes[ProbeIndex];
+			FHitResult Hit;
+			const bool bHit = bSweep
+				? World.SweepSingleByObjectType(Hit, Probe.Start, Probe.End, FQuat::Identity, ObjectParams, Capsule, QueryParams)
+				: World.LineTraceSingleByObjectType(Hit, Probe.Start, Probe.End, ObjectParams, QueryParams);
+
+			OutHitDistances[ProbeIndex] = bHit ? Hit.Distance : NAN;
+			Result.Hits += bHit;
+		}
+		Result.Microseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0 / FMath::Max(Probes.Num(), 1);
+		return Result;
+	}
+
+	/** Share of probes where both missed or both hit within the tolerance */
+	static float GetAgreement(const TArray<float>& A, const TArray<float>& B)
+	{
+		int32 NumAgreeing = 0;
+		for(int32 Index = 0; Index < A.Num(); ++Index)
+		{
+			const bool bMissA = FMath::IsNaN(A[Index]);
+			const bool bMissB = FMath::IsNaN(B[Index]);
+			NumAgreeing += (bMissA && bMissB) || (!bMissA && !bMissB && FMath::Abs(A[Index] - B[Index]) <= AgreementTolerance);
+		}
+		return A.IsEmpty() ? 0.f : (float)NumAgreeing / A.Num();
+	}
+}
+
+UClimbProxyBenchmarkCommandlet::UClimbProxyBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UClimbProxyBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace ClimbProxyBenchmark;
+
+	FString MapPath;
+	if(!FParse::Value(*Params, TEXT("Map="), MapPath))
+	{
+		UE_LOG(LogClimbing, Error, TEXT("ClimbProxyBenchmark needs -Map="));
+		return 1;
+	}
+
+	int32 NumQueries = 20000;
+	FParse::Value(*Params, TEXT("Queries="), NumQueries);
+
+	FString CsvPath;
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+
+	UWorld* World = ClimbProxyBuilder::LoadWorldForQueries(MapPath);
+	if(!World)
+	{
+		UE_LOG(LogClimbing, Error, TEXT("Could not load %s"), *MapPath);
+		return 1;
+	}
+
+	// Outer faces of every slab in world space, as a transform whose X axis is the face normal
+	TArray<FTransform> Faces;
+	TArray<FVector2D> FaceExtents;
+	for(TObjectIterator<UClimbProxyComponent> ProxyIt; ProxyIt; ++ProxyIt)
+	{
+		if(ProxyIt->GetWorld() != World || !ProxyIt->IsRegistered()) continue;
+
+		const FTransform& ComponentTransform = ProxyIt->GetComponentTransform();
+		for(const FClimbProxySlab& Slab : ProxyIt->GetSlabs())
+		{
+			const FTransform SlabTransform = FTransform(Slab.Rotation, Slab.Center + Slab.Rotation.Vector() * Slab.Extent.X) * ComponentTransform;
+			Faces.Add(SlabTransform);
+			FaceExtents.Add(FVector2D(Slab.Extent.Y, Slab.Extent.Z) * FVector2D(ComponentTransform.GetScale3D().Y, ComponentTransform.GetScale3D().Z));
+		}
+	}
+
+	if(Faces.IsEmpty())
+	{
+		UE_LOG(LogClimbing, Error, TEXT("%s has no climb proxies, run ClimbProxyGenerator first"), *MapPath);
+		ClimbProxyBuilder::ReleaseWorld(World);
+		return 1;
+	}
+
+	FRandomStream Random(0x0C11B);
+	TArray<FProbe> Probes;
+	Probes.Reserve(NumQueries);
+	for(int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+	{
+		const int32 FaceIndex = Random.RandHelper(Faces.Num());
+		const FTransform& Face = Faces[FaceIndex];
+		const FVector Normal = Face.GetUnitAxis(EAxis::X);
+		const FVector OnFace = Face.GetLocation()
+			+ Face.GetUnitAxis(EAxis::Y) * Random.FRandRange(-1.f, 1.f) * FaceExtents[FaceIndex].X
+			+ Face.GetUnitAxis(EAxis::Z) * Random.FRandRange(-1.f, 1.f) * FaceExtents[FaceIndex].Y;
+
+		Probes.Add({OnFace + Normal * ProbeStandOff, OnFace - Normal * (ProbeReach - ProbeStandOff)});
+	}
+
+	FCollisionObjectQueryParams ComplexObjectParams;
+	ComplexObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+	ComplexObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	FCollisionQueryParams ComplexQueryParams(SCENE_QUERY_STAT(ClimbProxyBenchmarkComplex), true);
+
+	const FCollisionObjectQueryParams ProxyObjectParams(ECC_ClimbProxy);
+	FCollisionQueryParams ProxyQueryParams(SCENE_QUERY_STAT(ClimbProxyBenchmarkProxy), false);
+
+	TArray<float> ComplexDistances;
+	TArray<float> ProxyDistances;
+
+	const FResult ComplexSweep = RunProbes(*World, Probes, true, ComplexObjectParams, ComplexQueryParams, ComplexDistances);
+	const FResult ProxySweep = RunProbes(*World, Probes, true, ProxyObjectParams, ProxyQueryParams, ProxyDistances);
+	const float SweepAgreement = GetAgreement(ComplexDistances, ProxyDistances);
+
+	const FResult ComplexLine = RunProbes(*World, Probes, false, ComplexObjectParams, ComplexQueryParams, ComplexDistances);
+	const FResult ProxyLine = RunProbes(*World, Probes, false, ProxyObjectParams, ProxyQueryParams, ProxyDistances);
+	const float LineAgreement = GetAgreement(ComplexDistances, ProxyDistances);
+
+	ClimbProxyBuilder::ReleaseWorld(World);
+
+	const double SweepSpeedup = ComplexSweep.Microseconds / FMath::Max(ProxySweep.Microseconds, 1e-6);
+	const double LineSpeedup = ComplexLine.Microseconds / FMath::Max(ProxyLine.Microseconds, 1e-6);
+
+	UE_LOG(LogClimbing, Display, TEXT("%s: %d queries over %d proxy slabs"), *MapPath, NumQueries, Faces.Num());
+	UE_LOG(LogClimbing, Display, TEXT("Capsule sweep us: complex %.3f  proxy %.3f  (%.2fx), hits %d / %d, agreement %.1f%%"),
+		ComplexSweep.Microseconds, ProxySweep.Microseconds, SweepSpeedup, ComplexSweep.Hits, ProxySweep.Hits, SweepAgreement * 100.f);
+	UE_LOG(LogClimbing, Display, TEXT("Line trace us: complex %.3f  proxy %.3f  (%.2fx), hits %d / %d, agreement %.1f%%"),
+		ComplexLine.Microseconds, ProxyLine.Microseconds, LineSpeedup, ComplexLine.Hits, ProxyLine.Hits, LineAgreement * 100.f);
+
+	if(!CsvPath.IsEmpty())
+	{
+		TArray<FString> CsvLines;
+		CsvLines.Add(TEXT("Queries,Slabs,ComplexSweepUs,ProxySweepUs,SweepAgreement,ComplexLineUs,ProxyLineUs,LineAgreement"));
+		CsvLines.Add(FString::Printf(TEXT("%d,%d,%.3f,%.3f,%.4f,%.3f,%.3f,%.4f"), NumQueries, Faces.Num(),
+			ComplexSweep.Microseconds, ProxySweep.Microseconds, SweepAgreement, ComplexLine.Microseconds, ProxyLine.Microseconds, LineAgreement));
+		FFileHelper::SaveStringArrayToFile(CsvLines, *CsvPath);
+	}
+
+	return 0;
+}
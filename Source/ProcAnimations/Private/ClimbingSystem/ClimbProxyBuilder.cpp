@@ -0,0 +1,257 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbProxyBuilder.h"
+
+#include "Algo/SortBy.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "StaticMeshResources.h"
+
+namespace ClimbProxyBuilder
+{
+	static constexpr int32 NumWallSectors = 8;
+	static constexpr int32 TopBucket = NumWallSectors;
+	/** A patch is halved at most this many times looking for coverage */
+	static constexpr int32 MaxCoverageSplits = 6;
+
+	struct FFace
+	{
+		int32 FirstIndex;
+		float Depth;
+		float Area;
+		/** Corners in the bucket's frame, X along the facing */
+		FVector FrameCorners[3];
+	};
+
+	/** Wall sector by yaw, the top bucket for walkable faces, INDEX_NONE for overhangs and steep slopes */
+	static int32 GetFaceBucket(const FVector& Normal)
+	{
+		if(Normal.Z > 0.7f) return TopBucket;
+		if(FMath::Abs(Normal.Z) > 0.5f) return INDEX_NONE;
+
+		const float Yaw = FMath::Atan2(Normal.Y, Normal.X);
+		return (FMath::RoundToInt(Yaw / (UE_TWO_PI / NumWallSectors)) + NumWallSectors) % NumWallSectors;
+	}
+
+	static int32 FindPatch(TArray<int32>& Parents, int32 Face)
+	{
+		while(Parents[Face] != Face)
+		{
+			Parents[Face] = Parents[Parents[Face]];
+			Face = Parents[Face];
+		}
+		return Face;
+	}
+
+	/**
+	 * One slab over Patch, unless the faces cover too little of its outer face. Then the patch is halved across
+	 * its longer side, so a wall wrapped around a doorway gets slabs beside and above the opening but not in it
+	 */
+	static void AddPatchSlabs(const TArray<FFace>& Faces, TArrayView<int32> Patch, const FMatrix& Frame, const FClimbProxyBuildParams& Params,
+		int32 SplitDepth, TArray<FClimbProxySlab>& OutSlabs)
+	{
+		float PatchArea = 0.f;
+		FVector Min(UE_BIG_NUMBER);
+		FVector Max(-UE_BIG_NUMBER);
+		for(const int32 FaceIndex : Patch)
+		{
+			PatchArea += Faces[FaceIndex].Area;
+			for(const FVector& Corner : Faces[FaceIndex].FrameCorners)
+			{
+				Min = Min.ComponentMin(Corner);
+				Max = Max.ComponentMax(Corner);
+			}
+		}
+		if(PatchArea < Params.MinSlabArea) return;
+
+		const FVector Size = Max - Min;
+		const float Coverage = PatchArea / FMath::Max(Size.Y * Size.Z, UE_KINDA_SMALL_NUMBER);
+		if(Coverage < Params.MinSlabCoverage && SplitDepth < MaxCoverageSplits && Patch.Num() > 1)
+		{
+			const int32 SplitAxis = Size.Y >= Size.Z ? 1 : 2;
+			auto GetCenter = [&Faces, SplitAxis](int32 FaceIndex)
+			{
+				const FFace& Face = Faces[FaceIndex];
+				return (Face.FrameCorners[0][SplitAxis] + Face.FrameCorners[1][SplitAxis] + Face.FrameCorners[2][SplitAxis]) / 3.f;
+			};
+			Algo::SortBy(Patch, GetCenter);
+
+			// Split where the faces are furthest apart, which is the opening itself when there is one
+			int32 SplitIndex = Patch.Num() / 2;
+			float WidestGap = -1.f;
+			for(int32 Index = 1; Index < Patch.Num(); ++Index)
+			{
+				const float Gap = GetCenter(Patch[Index]) - GetCenter(Patch[Index - 1]);
+				if(Gap > WidestGap)
+				{
+					WidestGap = Gap;
+					SplitIndex = Index;
+				}
+			}
+
+			AddPatchSlabs(Faces, Patch.Left(SplitIndex), Frame, Params, SplitDepth + 1, OutSlabs);
+			AddPatchSlabs(Faces, Patch.RightChop(SplitIndex), Frame, Params, SplitDepth + 1, OutSlabs);
+			return;
+		}
+
+		// Outer face on the outermost plane of the patch, the slab reaches SlabThickness into the mesh
+		const FVector FrameCenter(Max.X - Params.SlabThickness * 0.5f, (Min.Y + Max.Y) * 0.5f, (Min.Z + Max.Z) * 0.5f);
+
+		FClimbProxySlab& Slab = OutSlabs.AddDefaulted_GetRef();
+		Slab.Center = Frame.GetScaledAxis(EAxis::X) * FrameCenter.X + Frame.GetScaledAxis(EAxis::Y) * FrameCenter.Y + Frame.GetScaledAxis(EAxis::Z) * FrameCenter.Z;
+		Slab.Rotation = Frame.Rotator();
+		Slab.Extent = FVector(Params.SlabThickness * 0.5f, Size.Y * 0.5f, Size.Z * 0.5f);
+	}
+}
+
+int32 ClimbProxyBuilder::BuildSlabs(const UStaticMesh& Mesh, const FClimbProxyBuildParams& Params, TArray<FClimbProxySlab>& OutSlabs)
+{
+	const FStaticMeshRenderData* RenderData = Mesh.GetRenderData();
+	if(!RenderData || RenderData->LODResources.IsEmpty()) return 0;
+
+	// LOD0 is the surface the climber's traces and the collision were built against, coarser LODs drift from it
+	const FStaticMeshLODResources& LODResources = RenderData->LODResources[0];
+	const FPositionVertexBuffer& Positions = LODResources.VertexBuffers.PositionVertexBuffer;
+	const FIndexArrayView Indices = LODResources.IndexBuffer.GetArrayView();
+	if(Positions.GetNumVertices() == 0 || Indices.Num() < 3) return 0;
+
+	auto GetVertex = [&Positions, &Indices](int32 Index) { return FVector(Positions.VertexPosition(Indices[Index])); };
+
+	// Render vertices are split along UV and normal seams, faces only share a corner by position
+	TArray<int32> WeldedVertices;
+	WeldedVertices.SetNumUninitialized(Positions.GetNumVertices());
+	{
+		TMap<FVector3f, int32> WeldedIds;
+		WeldedIds.Reserve(Positions.GetNumVertices());
+		for(uint32 Vertex = 0; Vertex < Positions.GetNumVertices(); ++Vertex)
+		{
+			WeldedVertices[Vertex] = WeldedIds.FindOrAdd(Positions.VertexPosition(Vertex), WeldedIds.Num());
+		}
+	}
+
+	TArray<FFace> Buckets[NumWallSectors + 1];
+	FVector BucketNormals[NumWallSectors + 1];
+	for(FVector& BucketNormal : BucketNormals)
+	{
+		BucketNormal = FVector::ZeroVector;
+	}
+
+	for(int32 FirstIndex = 0; FirstIndex + 2 < Indices.Num(); FirstIndex += 3)
+	{
+		const FVector A = GetVertex(FirstIndex);
+		const FVector Cross = FVector::CrossProduct(GetVertex(FirstIndex + 2) - A, GetVertex(FirstIndex + 1) - A);
+		const float DoubleArea = Cross.Size();
+		if(DoubleArea <= UE_KINDA_SMALL_NUMBER) continue;
+
+		const int32 Bucket = GetFaceBucket(Cross / DoubleArea);
+		if(Bucket == INDEX_NONE) continue;
+
+		// Area weighted, so the slab faces the way most of the surface does
+		BucketNormals[Bucket] += Cross;
+		Buckets[Bucket].Add({FirstIndex, 0.f, DoubleArea * 0.5f});
+	}
+
+	const int32 NumSlabsBefore = OutSlabs.Num();
+	TArray<int32> PatchParents;
+	TMap<int32, int32> FirstFaceAtVertex;
+	TMap<int32, TArray<int32>> Patches;
+	for(int32 Bucket = 0; Bucket <= NumWallSectors; ++Bucket)
+	{
+		TArray<FFace>& Faces = Buckets[Bucket];
+		if(Faces.IsEmpty()) continue;
+
+		const bool bTop = Bucket == TopBucket;
+		const FVector Facing = bTop ? FVector::UpVector : FVector(BucketNormals[Bucket].X, BucketNormals[Bucket].Y, 0.f).GetSafeNormal();
+		if(Facing.IsNearlyZero()) continue;
+
+		const FMatrix Frame = bTop ? FRotationMatrix::MakeFromXY(Facing, FVector::YAxisVector) : FRotationMatrix::MakeFromXZ(Facing, FVector::UpVector);
+		const FVector AxisY = Frame.GetScaledAxis(EAxis::Y);
+		const FVector AxisZ = Frame.GetScaledAxis(EAxis::Z);
+
+		for(FFace& Face : Faces)
+		{
+			for(int32 Corner = 0; Corner < 3; ++Corner)
+			{
+				const FVector Vertex = GetVertex(Face.FirstIndex + Corner);
+				Face.FrameCorners[Corner] = FVector(FVector::DotProduct(Vertex, Facing), FVector::DotProduct(Vertex, AxisY), FVector::DotProduct(Vertex, AxisZ));
+			}
+			Face.Depth = (Face.FrameCorners[0].X + Face.FrameCorners[1].X + Face.FrameCorners[2].X) / 3.f;
+		}
+		Faces.Sort([](const FFace& A, const FFace& B) { return A.Depth < B.Depth; });
+
+		// Faces more than a slab apart along the facing are separate walls, such as the front and back of a recess
+		int32 GroupStart = 0;
+		while(GroupStart < Faces.Num())
+		{
+			int32 GroupEnd = GroupStart + 1;
+			while(GroupEnd < Faces.Num() && Faces[GroupEnd].Depth - Faces[GroupEnd - 1].Depth <= Params.SlabThickness)
+			{
+				++GroupEnd;
+			}
+
+			// Within a depth, faces sharing a corner are one patch. Separate pillars or walls either side of a gap get a slab each
+			PatchParents.SetNumUninitialized(GroupEnd - GroupStart);
+			for(int32 Local = 0; Local < PatchParents.Num(); ++Local)
+			{
+				PatchParents[Local] = Local;
+			}
+			FirstFaceAtVertex.Reset();
+			for(int32 FaceIndex = GroupStart; FaceIndex < GroupEnd; ++FaceIndex)
+			{
+				for(int32 Corner = 0; Corner < 3; ++Corner)
+				{
+					const int32 WeldedVertex = WeldedVertices[Indices[Faces[FaceIndex].FirstIndex + Corner]];
+					const int32 OtherFace = FirstFaceAtVertex.FindOrAdd(WeldedVertex, FaceIndex - GroupStart);
+					PatchParents[FindPatch(PatchParents, OtherFace)] = FindPatch(PatchParents, FaceIndex - GroupStart);
+				}
+			}
+
+			Patches.Reset();
+			for(int32 FaceIndex = GroupStart; FaceIndex < GroupEnd; ++FaceIndex)
+			{
+				Patches.FindOrAdd(FindPatch(PatchParents, FaceIndex - GroupStart)).Add(FaceIndex);
+			}
+			for(TPair<int32, TArray<int32>>& Patch : Patches)
+			{
+				AddPatchSlabs(Faces, Patch.Value, Frame, Params, 0, OutSlabs);
+			}
+
+			GroupStart = GroupEnd;
+		}
+	}
+
+	return OutSlabs.Num() - NumSlabsBefore;
+}
+
+UWorld* ClimbProxyBuilder::LoadWorldForQueries(const FString& MapPath)
+{
+	UPackage* Package = LoadPackage(nullptr, *MapPath, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if(!World) return nullptr;
+
+	World->AddToRoot();
+	if(!World->bIsWorldInitialized)
+	{
+		World->WorldType = EWorldType::Editor;
+		World->InitWorld(UWorld::InitializationValues()
+			.AllowAudioPlayback(false)
+			.RequiresHitProxies(false)
+			.CreatePhysicsScene(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true));
+	}
+	World->UpdateWorldComponents(true, false);
+
+	return World;
+}
+
+void ClimbProxyBuilder::ReleaseWorld(UWorld* World)
+{
+	if(!World) return;
+
+	World->RemoveFromRoot();
+	World->DestroyWorld(false);
+}
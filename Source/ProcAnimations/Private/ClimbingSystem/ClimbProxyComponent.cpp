@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbProxyComponent.h"
+
+#include "PhysicsEngine/BodySetup.h"
+
+UClimbProxyComponent::UClimbProxyComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	SetCollisionProfileName(TEXT("ClimbProxy"));
+	SetGenerateOverlapEvents(false);
+	CanCharacterStepUpOn = ECB_No;
+	bHiddenInGame = true;
+}
+
+void UClimbProxyComponent::SetSlabs(TArray<FClimbProxySlab>&& InSlabs)
+{
+	Slabs = MoveTemp(InSlabs);
+	ProxyBodySetup = nullptr;
+
+	if(IsRegistered())
+	{
+		RecreatePhysicsState();
+		UpdateBounds();
+	}
+}
+
+UBodySetup* UClimbProxyComponent::GetBodySetup()
+{
+	if(!ProxyBodySetup)
+	{
+		UpdateProxyBodySetup();
+	}
+	return ProxyBodySetup;
+}
+
+FBoxSphereBounds UClimbProxyComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	FBox LocalBox(ForceInit);
+	for(const FClimbProxySlab& Slab : Slabs)
+	{
+		LocalBox += FBox(-Slab.Extent, Slab.Extent).TransformBy(FTransform(Slab.Rotation, Slab.Center));
+	}
+
+	if(!LocalBox.IsValid) return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+
+	return FBoxSphereBounds(LocalBox.TransformBy(LocalToWorld));
+}
+
+void UClimbProxyComponent::UpdateProxyBodySetup()
+{
+	// Boxes need no cooking, so the body is rebuilt from the slabs on load rather than saved
+	ProxyBodySetup = NewObject<UBodySetup>(this, NAME_None, RF_Transient);
+	ProxyBodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+	ProxyBodySetup->bNeverNeedsCookedCollisionData = true;
+	ProxyBodySetup->BodySetupGuid = FGuid::NewGuid();
+
+	for(const FClimbProxySlab& Slab : Slabs)
+	{
+		FKBoxElem BoxElem(Slab.Extent.X * 2.f, Slab.Extent.Y * 2.f, Slab.Extent.Z * 2.f);
+		BoxElem.Center = Slab.Center;
+		BoxElem.Rotation = Slab.Rotation;
+		ProxyBodySetup->AggGeom.BoxElems.Add(BoxElem);
+	}
+}
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbProxyGeneratorCommandlet.h"
+
+#include "ClimbingSystem/ClimbProxyBuilder.h"
+#include "ClimbingSystem/ClimbProxyComponent.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "UObject/SavePackage.h"
+
+UClimbProxyGeneratorCommandlet::UClimbProxyGeneratorCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UClimbProxyGeneratorCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapPath;
+	if(!FParse::Value(*Params, TEXT("Map="), MapPath))
+	{
+		UE_LOG(LogClimbing, Error, TEXT("ClimbProxyGenerator needs -Map="));
+		return 1;
+	}
+
+	FClimbProxyBuildParams BuildParams;
+	FParse::Value(*Params, TEXT("SlabThickness="), BuildParams.SlabThickness);
+	FParse::Value(*Params, TEXT("MinSlabArea="), BuildParams.MinSlabArea);
+	FParse::Value(*Params, TEXT("MinSlabCoverage="), BuildParams.MinSlabCoverage);
+
+	UWorld* World = ClimbProxyBuilder::LoadWorldForQueries(MapPath);
+	if(!World)
+	{
+		UE_LOG(LogClimbing, Error, TEXT("Could not load %s"), *MapPath);
+		return 1;
+	}
+
+	int32 NumRemoved = 0;
+	int32 NumProxies = 0;
+	int32 NumSlabs = 0;
+	TMap<const UStaticMesh*, TArray<FClimbProxySlab>> SlabsByMesh;
+
+	for(TActorIterator<AActor> ActorIt(World); ActorIt; ++ActorIt)
+	{
+		AActor* Actor = *ActorIt;
+
+		TInlineComponentArray<UClimbProxyComponent*> OldProxies(Actor);
+		for(UClimbProxyComponent* OldProxy : OldProxies)
+		{
+			Actor->RemoveInstanceComponent(OldProxy);
+			OldProxy->DestroyComponent();
+			++NumRemoved;
+		}
+
+		TInlineComponentArray<UStaticMeshComponent*> MeshComponents(Actor);
+		for(UStaticMeshComponent* MeshComponent : MeshComponents)
+		{
+			// Instances would need a proxy each, they are rarely climbable architecture
+			if(MeshComponent->IsA<UInstancedStaticMeshComponent>()) continue;
+			if(MeshComponent->Mobility != EComponentMobility::Static || !MeshComponent->IsCollisionEnabled()) continue;
+
+			const UStaticMesh* Mesh = MeshComponent->GetStaticMesh();
+			if(!Mesh) continue;
+
+			TArray<FClimbProxySlab>* Slabs = SlabsByMesh.Find(Mesh);
+			if(!Slabs)
+			{
+				Slabs = &SlabsByMesh.Add(Mesh);
+				ClimbProxyBuilder::BuildSlabs(*Mesh, BuildParams, *Slabs);
+			}
+			if(Slabs->IsEmpty()) continue;
+
+			UClimbProxyComponent* Proxy = NewObject<UClimbProxyComponent>(Actor, NAME_None, RF_Transactional);
+			Proxy->SetupAttachment(MeshComponent);
+			Proxy->SetSlabs(TArray<FClimbProxySlab>(*Slabs));
+			Actor->AddInstanceComponent(Proxy);
+			Proxy->RegisterComponent();
+
+			++NumProxies;
+			NumSlabs += Slabs->Num();
+		}
+	}
+
+	UE_LOG(LogClimbing, Display, TEXT("%s: removed %d climb proxies, added %d with %d slabs from %d meshes"),
+		*MapPath, NumRemoved, NumProxies, NumSlabs, SlabsByMesh.Num());
+
+	UPackage* Package = World->GetOutermost();
+	Package->MarkPackageDirty();
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Standalone;
+	const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetMapPackageExtension());
+	const bool bSaved = UPackage::SavePackage(Package, World, *Filename, SaveArgs);
+
+	ClimbProxyBuilder::ReleaseWorld(World);
+
+	if(!bSaved)
+	{
+		UE_LOG(LogClimbing, Error, TEXT("Could not save %s"), *Filename);
+		return 1;
+	}
+	return 0;
+#else
+	UE_LOG(LogClimbing, Error, TEXT("ClimbProxyGenerator needs an editor build"));
+	return 1;
+#endif
+}
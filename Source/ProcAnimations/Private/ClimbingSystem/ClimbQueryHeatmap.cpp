@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbQueryHeatmap.h"
+
+#include "Async/Async.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace ClimbQueryHeatmapCommands
+{
+	static FAutoConsoleCommand StartCommand(
+		TEXT("Climbing.QueryHeatmap.Start"),
+		TEXT("Starts recording where traversal queries cost the most. Args: [CellSize]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const float CellSize = Args.IsValidIndex(0) ? FCString::Atof(*Args[0]) : UClimbingSettings::Get()->QueryHeatmapCellSize;
+			FClimbQueryHeatmap::Get().Start(CellSize);
+			UE_LOG(LogClimbing, Display, TEXT("Climbing query heatmap recording, %.0f cm cells"), CellSize);
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs StopCommand(
+		TEXT("Climbing.QueryHeatmap.Stop"),
+		TEXT("Stops the traversal query heatmap and saves it to Saved/Climbing/QueryHeatmap"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			const FString FilePath = FClimbQueryHeatmap::Get().StopAndSave(World ? World->GetMapName() : TEXT("Unknown"));
+			if(FilePath.IsEmpty())
+			{
+				UE_LOG(LogClimbing, Display, TEXT("Climbing query heatmap recorded nothing"));
+				return;
+			}
+			UE_LOG(LogClimbing, Display, TEXT("Climbing query heatmap saved to %s"), *FilePath);
+		}));
+}
+
+FClimbQueryHeatmap& FClimbQueryHeatmap::Get()
+{
+	static FClimbQueryHeatmap Heatmap;
+	return Heatmap;
+}
+
+void FClimbQueryHeatmap::Start(float InCellSize)
+{
+	check(IsInGameThread());
+
+	Cells.Reset();
+	CellSize = FMath::Max(InCellSize, 1.f);
+	StartTime = FPlatformTime::Seconds();
+	bRecording = true;
+}
+
+FString FClimbQueryHeatmap::StopAndSave(const FString& MapName)
+{
+	check(IsInGameThread());
+
+	const bool bWasRecording = bRecording;
+	bRecording = false;
+	if(!bWasRecording || Cells.IsEmpty()) return FString();
+
+	FClimbQueryHeatmapHeader Header;
+	Header.CellSize = CellSize;
+	Header.NumCells = Cells.Num();
+	Header.RecordedSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TArray<FClimbQueryHeatmapCell> SavedCells;
+	Cells.GenerateValueArray(SavedCells);
+	Cells.Reset();
+
+	const FString FilePath = FPaths::ProjectSavedDir() / TEXT("Climbing/QueryHeatmap") /
+		FString::Printf(TEXT("%s_%s.cqh"), *MapName, *FDateTime::Now().ToString());
+
+	Async(EAsyncExecution::ThreadPool, [FilePath, Header, MapName, SavedCells = MoveTemp(SavedCells)]()
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		Writer.Serialize(const_cast<FClimbQueryHeatmapHeader*>(&Header), sizeof(Header));
+		FString Name = MapName;
+		Writer << Name;
+		Writer.Serialize(const_cast<FClimbQueryHeatmapCell*>(SavedCells.GetData()), SavedCells.Num() * sizeof(FClimbQueryHeatmapCell));
+
+		FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+	});
+
+	return FilePath;
+}
+
+void FClimbQueryHeatmap::Record(const FVector& Location, bool bCapsule, int32 Hits, uint64 Cycles)
+{
+	if(!bRecording) return;
+
+	const FIntPoint CellCoord(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+	FClimbQueryHeatmapCell* Cell = Cells.Find(CellCoord);
+	if(!Cell)
+	{
+		Cell = &Cells.Add(CellCoord);
+		Cell->CellX = CellCoord.X;
+		Cell->CellY = CellCoord.Y;
+	}
+
+	++(bCapsule ? Cell->CapsuleTraces : Cell->LineTraces);
+	Cell->Hits += Hits;
+	Cell->Microseconds += FPlatformTime::ToSeconds64(Cycles) * 1000000.0;
+}
+
+bool FClimbQueryHeatmap::LoadFromFile(const FString& FilePath, FClimbQueryHeatmapHeader& OutHeader, FString& OutMapName, TArray<FClimbQueryHeatmapCell>& OutCells)
+{
+	TArray<uint8> Bytes;
+	if(!FFileHelper::LoadFileToArray(Bytes, *FilePath)) return false;
+
+	FMemoryReader Reader(Bytes);
+	Reader.Serialize(&OutHeader, sizeof(OutHeader));
+	if(Reader.IsError() || OutHeader.Magic != FClimbQueryHeatmapHeader::ExpectedMagic || OutHeader.Version != FClimbQueryHeatmapHeader::CurrentVersion) return false;
+
+	Reader << OutMapName;
+	OutCells.SetNumUninitialized(OutHeader.NumCells);
+	Reader.Serialize(OutCells.GetData(), OutCells.Num() * sizeof(FClimbQueryHeatmapCell));
+
+	return !Reader.IsError();
+}
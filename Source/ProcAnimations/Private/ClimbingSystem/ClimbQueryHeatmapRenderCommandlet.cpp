@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbQueryHeatmapRenderCommandlet.h"
+
+#include "ClimbingSystem/ClimbQueryHeatmap.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace ClimbQueryHeatmapRender
+{
+	static float GetMetric(const FClimbQueryHeatmapCell& Cell, const FString& Metric)
+	{
+		const uint32 Traces = Cell.CapsuleTraces + Cell.LineTraces;
+		if(Metric == TEXT("Traces")) return Traces;
+		if(Metric == TEXT("HitsPerTrace")) return Traces > 0 ? (float)Cell.Hits / Traces : 0.f;
+		return Cell.Microseconds;
+	}
+
+	/** Dark blue through green and yellow to red */
+	static FColor GetHeatColor(float Alpha)
+	{
+		static const FLinearColor Stops[] = {
+			FLinearColor(0.f, 0.f, 0.3f), FLinearColor(0.f, 0.6f, 1.f), FLinearColor(0.f, 1.f, 0.f), FLinearColor(1.f, 1.f, 0.f), FLinearColor(1.f, 0.f, 0.f)};
+		static constexpr int32 NumSegments = UE_ARRAY_COUNT(Stops) - 1;
+
+		const float Scaled = FMath::Clamp(Alpha, 0.f, 1.f) * NumSegments;
+		const int32 Segment = FMath::Min((int32)Scaled, NumSegments - 1);
+		return FLinearColor::LerpUsingHSV(Stops[Segment], Stops[Segment + 1], Scaled - Segment).ToFColor(true);
+	}
+}
+
+UClimbQueryHeatmapRenderCommandlet::UClimbQueryHeatmapRenderCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UClimbQueryHeatmapRenderCommandlet::Main(const FString& Params)
+{
+	using namespace ClimbQueryHeatmapRender;
+
+	FString FilePath;
+	if(!FParse::Value(*Params, TEXT("File="), FilePath))
+	{
+		UE_LOG(LogClimbing, Error, TEXT("Usage: -run=ClimbQueryHeatmapRender -File=Path [-Out=Path] [-Metric=Time|Traces|HitsPerTrace] [-PixelsPerCell=8] [-Top=10]"));
+		return 1;
+	}
+
+	FString OutPath = FPaths::ChangeExtension(FilePath, TEXT("png"));
+	FString Metric = TEXT("Time");
+	int32 PixelsPerCell = 8;
+	int32 NumTop = 10;
+	FParse::Value(*Params, TEXT("Out="), OutPath);
+	FParse::Value(*Params, TEXT("Metric="), Metric);
+	FParse::Value(*Params, TEXT("PixelsPerCell="), PixelsPerCell);
+	FParse::Value(*Params, TEXT("Top="), NumTop);
+	PixelsPerCell = FMath::Max(PixelsPerCell, 1);
+
+	FClimbQueryHeatmapHeader Header;
+	FString MapName;
+	TArray<FClimbQueryHeatmapCell> Cells;
+	if(!FClimbQueryHeatmap::LoadFromFile(FilePath, Header, MapName, Cells))
+	{
+		UE_LOG(LogClimbing, Error, TEXT("%s is not a version %u climbing query heatmap"), *FilePath, FClimbQueryHeatmapHeader::CurrentVersion);
+		return 1;
+	}
+	if(Cells.IsEmpty())
+	{
+		UE_LOG(LogClimbing, Error, TEXT("%s has no cells"), *FilePath);
+		return 1;
+	}
+
+	FIntPoint MinCell(MAX_int32, MAX_int32);
+	FIntPoint MaxCell(MIN_int32, MIN_int32);
+	float MaxValue = 0.f;
+	for(const FClimbQueryHeatmapCell& Cell : Cells)
+	{
+		MinCell = FIntPoint(FMath::Min(MinCell.X, Cell.CellX), FMath::Min(MinCell.Y, Cell.CellY));
+		MaxCell = FIntPoint(FMath::Max(MaxCell.X, Cell.CellX), FMath::Max(MaxCell.Y, Cell.CellY));
+		MaxValue = FMath::Max(MaxValue, GetMetric(Cell, Metric));
+	}
+
+	// Top down with world X up and Y right, as in the editor's top view
+	const int64 Width = (int64)(MaxCell.Y - MinCell.Y + 1) * PixelsPerCell;
+	const int64 Height = (int64)(MaxCell.X - MinCell.X + 1) * PixelsPerCell;
+	if(Width * Height > 16384 * 16384)
+	{
+		UE_LOG(LogClimbing, Error, TEXT("%lld x %lld pixels is too large, lower -PixelsPerCell"), Width, Height);
+		return 1;
+	}
+
+	TArray<FColor> Pixels;
+	Pixels.Init(FColor::Black, Width * Height);
+	for(const FClimbQueryHeatmapCell& Cell : Cells)
+	{
+		// Square root keeps the cooler cells apart when one hotspot dominates
+		const FColor Color = GetHeatColor(MaxValue > 0.f ? FMath::Sqrt(GetMetric(Cell, Metric) / MaxValue) : 0.f);
+		const int64 Left = (int64)(Cell.CellY - MinCell.Y) * PixelsPerCell;
+		const int64 Top = (int64)(MaxCell.X - Cell.CellX) * PixelsPerCell;
+		for(int64 Row = Top; Row < Top + PixelsPerCell; ++Row)
+		{
+			for(int64 Column = Left; Column < Left + PixelsPerCell; ++Column)
+			{
+				Pixels[Row * Width + Column] = Color;
+			}
+		}
+	}
+
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+	TSharedPtr<IImageWrapper> PngWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+	if(!PngWrapper.IsValid() || !PngWrapper->SetRaw(Pixels.GetData(), Pixels.Num() * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8))
+	{
+		UE_LOG(LogClimbing, Error, TEXT("Could not encode the heatmap"));
+		return 1;
+	}
+	if(!FFileHelper::SaveArrayToFile(PngWrapper->GetCompressed(), *OutPath))
+	{
+		UE_LOG(LogClimbing, Error, TEXT("Could not write %s"), *OutPath);
+		return 1;
+	}
+
+	UE_LOG(LogClimbing, Display, TEXT("%s: %d cells of %.0f cm over %.1f s, %s max %.3f, wrote %s"),
+		*MapName, Cells.Num(), Header.CellSize, Header.RecordedSeconds, *Metric, MaxValue, *OutPath);
+
+	Cells.Sort([&Metric](const FClimbQueryHeatmapCell& A, const FClimbQueryHeatmapCell& B) { return GetMetric(A, Metric) > GetMetric(B, Metric); });
+	for(int32 Index = 0; Index < FMath::Min(NumTop, Cells.Num()); ++Index)
+	{
+		const FClimbQueryHeatmapCell& Cell = Cells[Index];
+		const uint32 Traces = Cell.CapsuleTraces + Cell.LineTraces;
+		UE_LOG(LogClimbing, Display, TEXT("  X %8.0f Y %8.0f: %8.1f us, %6u sweeps, %6u lines, %.2f hits per trace"),
+			(Cell.CellX + 0.5f) * Header.CellSize, (Cell.CellY + 0.5f) * Header.CellSize,
+			Cell.Microseconds, Cell.CapsuleTraces, Cell.LineTraces, Traces > 0 ? (float)Cell.Hits / Traces : 0.f);
+	}
+
+	return 0;
+}
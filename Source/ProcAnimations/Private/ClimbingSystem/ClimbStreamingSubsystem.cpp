@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbStreamingSubsystem.h"
+
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "ClimbingSystem/CustomMovementComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "WorldPartition/WorldPartitionRuntimeCell.h"
+#include "WorldPartition/WorldPartitionSubsystem.h"
+
+void UClimbStreamingSubsystem::RegisterClimber(UCustomMovementComponent* Climber)
+{
+	Climbers.AddUnique(Climber);
+}
+
+void UClimbStreamingSubsystem::UnregisterClimber(UCustomMovementComponent* Climber)
+{
+	Climbers.RemoveSwap(Climber);
+	HoldStartTimes.Remove(Climber);
+}
+
+bool UClimbStreamingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UClimbStreamingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbStreamingSubsystem, STATGROUP_Climbing);
+}
+
+void UClimbStreamingSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if(!InWorld.IsPartitionedWorld()) return;
+
+	if(UWorldPartitionSubsystem* WorldPartitionSubsystem = InWorld.GetSubsystem<UWorldPartitionSubsystem>())
+	{
+		WorldPartitionSubsystem->RegisterStreamingSourceProvider(this);
+		bRegisteredAsSourceProvider = true;
+	}
+}
+
+void UClimbStreamingSubsystem::Deinitialize()
+{
+	if(bRegisteredAsSourceProvider)
+	{
+		if(UWorldPartitionSubsystem* WorldPartitionSubsystem = GetWorld()->GetSubsystem<UWorldPartitionSubsystem>())
+		{
+			WorldPartitionSubsystem->UnregisterStreamingSourceProvider(this);
+		}
+		bRegisteredAsSourceProvider = false;
+	}
+
+	Super::Deinitialize();
+}
+
+bool UClimbStreamingSubsystem::GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const
+{
+	OutStreamingSources.Append(LookaheadSources);
+	return !LookaheadSources.IsEmpty();
+}
+
+void UClimbStreamingSubsystem::SetAllStreamedIn()
+{
+	LookaheadSources.Reset();
+	HoldStartTimes.Reset();
+	for(const TWeakObjectPtr<UCustomMovementComponent>& Climber : Climbers)
+	{
+		Climber->SetTraversalAreaStreamedIn(true);
+	}
+}
+
+void UClimbStreamingSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ClimbStreaming_Update);
+
+	Climbers.RemoveAllSwap([](const TWeakObjectPtr<UCustomMovementComponent>& Climber) { return !Climber.IsValid(); });
+	for(auto It = HoldStartTimes.CreateIterator(); It; ++It)
+	{
+		if(!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	UWorldPartitionSubsystem* WorldPartitionSubsystem = bRegisteredAsSourceProvider ? GetWorld()->GetSubsystem<UWorldPartitionSubsystem>() : nullptr;
+	if(!Settings->bClimbStreamingAwareness || !WorldPartitionSubsystem)
+	{
+		SetAllStreamedIn();
+		return;
+	}
+
+	TimeUntilCheck -= DeltaTime;
+	if(TimeUntilCheck > 0.f) return;
+	TimeUntilCheck = Settings->ClimbStreamingCheckInterval;
+
+	LookaheadSources.Reset();
+
+	int32 NumHolding = 0;
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	TArray<FWorldPartitionStreamingQuerySource> ProbeArea;
+	FWorldPartitionStreamingQuerySource& Query = ProbeArea.AddDefaulted_GetRef();
+	Query.Radius = Settings->ClimbStreamingProbeRadius;
+	Query.bUseGridLoadingRange = false;
+
+	for(int32 Index = 0; Index < Climbers.Num(); ++Index)
+	{
+		UCustomMovementComponent* Climber = Climbers[Index].Get();
+		const FVector Location = Climber->UpdatedComponent->GetComponentLocation();
+
+		// Only players stream the world in, a source per AI climber would keep most of the world loaded
+		const ACharacter* Character = Climber->GetCharacterOwner();
+		if(Character && Character->IsPlayerControlled() && Climber->Velocity.SizeSquared() > 1.f)
+		{
+			FWorldPartitionStreamingSource& Source = LookaheadSources.AddDefaulted_GetRef();
+			Source.Name = FName(TEXT("ClimbLookahead"), Index);
+			Source.Location = Location + Climber->Velocity * Settings->ClimbStreamingLookahead;
+			Source.Rotation = Climber->Velocity.Rotation();
+			Source.TargetState = EStreamingSourceTargetState::Activated;
+			Source.bBlockOnSlowLoading = false;
+			Source.Priority = EStreamingSourcePriority::High;
+			Source.Velocity = Climber->Velocity.Size();
+		}
+
+		// Any cell within probe reach that is not active yet could hide the wall or ledge being probed
+		ProbeArea[0].Location = Location;
+
+		bool bStreamedIn = WorldPartitionSubsystem->IsStreamingCompleted(EWorldPartitionRuntimeCellState::Activated, ProbeArea, false);
+		if(bStreamedIn)
+		{
+			HoldStartTimes.Remove(Climbers[Index]);
+		}
+		else
+		{
+			// AI stream nothing in themselves, a cell nobody requests would hold them forever
+			const double HoldStartTime = HoldStartTimes.FindOrAdd(Climbers[Index], WorldTime);
+			bStreamedIn = WorldTime - HoldStartTime >= Settings->ClimbStreamingHoldTimeout;
+		}
+		Climber->SetTraversalAreaStreamedIn(bStreamedIn);
+		NumHolding += !bStreamedIn;
+	}
+
+	SET_DWORD_STAT(STAT_ClimbStreaming_Sources, LookaheadSources.Num());
+	SET_DWORD_STAT(STAT_ClimbStreaming_Holding, NumHolding);
+}
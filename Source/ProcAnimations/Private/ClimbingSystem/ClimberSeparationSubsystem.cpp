@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimberSeparationSubsystem.h"
+
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "ClimbingSystem/CustomMovementComponent.h"
+#include "Engine/World.h"
+
+void UClimberSeparationSubsystem::RegisterClimber(UCustomMovementComponent* Climber)
+{
+	Climbers.AddUnique(Climber);
+}
+
+void UClimberSeparationSubsystem::UnregisterClimber(UCustomMovementComponent* Climber)
+{
+	Climbers.RemoveSwap(Climber);
+}
+
+bool UClimberSeparationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UClimberSeparationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UClimberSeparationSubsystem, STATGROUP_Climbing);
+}
+
+void UClimberSeparationSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ClimbSeparation_Update);
+
+	Climbers.RemoveAllSwap([](const TWeakObjectPtr<UCustomMovementComponent>& Climber) { return !Climber.IsValid(); });
+	SET_DWORD_STAT(STAT_ClimbSeparation_Climbers, Climbers.Num());
+
+	// Only the server steers, clients never move by it, see UCustomMovementComponent::CanApplyClimbSeparation
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	if(!Settings->bUseClimberSeparation || Climbers.Num() < 2 || GetWorld()->GetNetMode() == NM_Client)
+	{
+		for(const TWeakObjectPtr<UCustomMovementComponent>& Climber : Climbers)
+		{
+			Climber->SetClimbSeparationVelocity(FVector::ZeroVector);
+		}
+		return;
+	}
+
+	// A cell as wide as the separation radius means every neighbour within it sits in the surrounding 27 cells
+	const float Radius = Settings->ClimberSeparationRadius;
+	const float RadiusSq = FMath::Square(Radius);
+	auto GetCell = [Radius](const FVector& Location)
+	{
+		return FIntVector(FMath::FloorToInt(Location.X / Radius), FMath::FloorToInt(Location.Y / Radius), FMath::FloorToInt(Location.Z / Radius));
+	};
+
+	const int32 NumClimbers = Climbers.Num();
+	CellHeads.Reset();
+	NextInCell.SetNumUninitialized(NumClimbers);
+	Locations.SetNumUninitialized(NumClimbers);
+	SurfaceNormals.SetNumUninitialized(NumClimbers);
+
+	for(int32 Index = 0; Index < NumClimbers; ++Index)
+	{
+		const UCustomMovementComponent* Climber = Climbers[Index].Get();
+		Locations[Index] = Climber->UpdatedComponent->GetComponentLocation();
+		SurfaceNormals[Index] = Climber->GetClimbableSurfaceNormal();
+
+		int32& Head = CellHeads.FindOrAdd(GetCell(Locations[Index]), INDEX_NONE);
+		NextInCell[Index] = Head;
+		Head = Index;
+	}
+
+	int32 NeighbourPairs = 0;
+	for(int32 Index = 0; Index < NumClimbers; ++Index)
+	{
+		// Everyone is a neighbour, but only climbers whose moves the server authors get pushed
+		if(!Climbers[Index]->CanApplyClimbSeparation())
+		{
+			Climbers[Index]->SetClimbSeparationVelocity(FVector::ZeroVector);
+			continue;
+		}
+
+		const FVector& Location = Locations[Index];
+		const FVector& SurfaceNormal = SurfaceNormals[Index];
+		const FIntVector Cell = GetCell(Location);
+
+		FVector Push = FVector::ZeroVector;
+		for(int32 X = -1; X <= 1; ++X)
+		for(int32 Y = -1; Y <= 1; ++Y)
+		for(int32 Z = -1; Z <= 1; ++Z)
+		{
+			const int32* Head = CellHeads.Find(Cell + FIntVector(X, Y, Z));
+			for(int32 Other = Head ? *Head : INDEX_NONE; Other != INDEX_NONE; Other = NextInCell[Other])
+			{
+				if(Other == Index) continue;
+
+				// Climbers on a different face of a corner are not competing for the same wall space
+				if(FVector::DotProduct(SurfaceNormal, SurfaceNormals[Other]) < Settings->ClimberSeparationNormalDot) continue;
+
+				// Neighbours are found within the radius the cells cover, the push then stays in the surface plane.
+				// A climber on a parallel wall behind this one is in range within the plane but not of the hash
+				const FVector Offset = Location - Locations[Other];
+				if(Offset.SizeSquared() >= RadiusSq) continue;
+
+				const FVector Away = FVector::VectorPlaneProject(Offset, SurfaceNormal);
+				const float DistanceSq = Away.SizeSquared();
+
+				++NeighbourPairs;
+
+				// Exactly stacked climbers still need a direction, the index order keeps it symmetric
+				const FVector Direction = DistanceSq > KINDA_SMALL_NUMBER
+					? Away / FMath::Sqrt(DistanceSq)
+					: FVector::CrossProduct(SurfaceNormal, FVector::UpVector).GetSafeNormal() * (Index < Other ? 1.f : -1.f);
+
+				Push += Direction * (1.f - FMath::Sqrt(DistanceSq) / Radius);
+			}
+		}
+
+		Climbers[Index]->SetClimbSeparationVelocity(Push.GetClampedToMaxSize(1.f) * Settings->ClimberSeparationSpeed);
+	}
+
+	SET_DWORD_STAT(STAT_ClimbSeparation_NeighbourPairs, NeighbourPairs);
+}
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbingAnimationBudgetSubsystem.h"
+
+#include "AnimationBudgetAllocatorParameters.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "IAnimationBudgetAllocator.h"
+#include "SkeletalMeshComponentBudgeted.h"
+
+namespace ClimbingAnimationBudget
+{
+	static FAutoConsoleCommandWithWorldAndArgs SetBudgetCommand(
+		TEXT("Climbing.AnimBudget.BudgetMs"),
+		TEXT("Overrides the climber animation budget in milliseconds for this world. Args: <BudgetMs>"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(!World || !Args.IsValidIndex(0)) return;
+
+			UClimbingSettings* Settings = GetMutableDefault<UClimbingSettings>();
+			Settings->AnimationBudgetMs = FMath::Max(0.1f, FCString::Atof(*Args[0]));
+
+			if(const UClimbingAnimationBudgetSubsystem* BudgetSubsystem = World->GetSubsystem<UClimbingAnimationBudgetSubsystem>())
+			{
+				BudgetSubsystem->ApplyBudgetSettings();
+			}
+		}));
+}
+
+void UClimbingAnimationBudgetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if(!USkeletalMeshComponentBudgeted::OnCalculateSignificance().IsBound())
+	{
+		USkeletalMeshComponentBudgeted::OnCalculateSignificance().BindStatic(&UClimbingAnimationBudgetSubsystem::CalculateClimberSignificance);
+	}
+}
+
+bool UClimbingAnimationBudgetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UClimbingAnimationBudgetSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	ApplyBudgetSettings();
+}
+
+void UClimbingAnimationBudgetSubsystem::ApplyBudgetSettings() const
+{
+	IAnimationBudgetAllocator* AnimationBudgetAllocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if(!AnimationBudgetAllocator) return;
+
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+
+	FAnimationBudgetAllocatorParameters BudgetParameters;
+	BudgetParameters.BudgetInMs = Settings->AnimationBudgetMs;
+	BudgetParameters.MaxTickRate = Settings->AnimationBudgetMaxTickRate;
+	AnimationBudgetAllocator->SetParameters(BudgetParameters);
+	AnimationBudgetAllocator->SetEnabled(Settings->bUseAnimationBudget);
+}
+
+float UClimbingAnimationBudgetSubsystem::CalculateClimberSignificance(USkeletalMeshComponentBudgeted* Component)
+{
+	const UWorld* World = Component ? Component->GetWorld() : nullptr;
+	if(!World) return 1.f;
+
+	float ClosestDistanceSq = MAX_flt;
+	for(FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if(!PlayerController || !PlayerController->IsLocalController()) continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		ClosestDistanceSq = FMath::Min(ClosestDistanceSq, FVector::DistSquared(ViewLocation, Component->GetComponentLocation()));
+	}
+
+	if(ClosestDistanceSq == MAX_flt) return 0.f;
+
+	const float FalloffDistance = UClimbingSettings::Get()->AnimationSignificanceFalloffDistance;
+	return 1.f - FMath::Clamp(FMath::Sqrt(ClosestDistanceSq) / FalloffDistance, 0.f, 1.f);
+}
@@ -0,0 +1,508 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbingBenchmarkSubsystem.h"
+
+#include "ClimbingSystem/ClimbingAnimationBudgetSubsystem.h"
+#include "ClimbingSystem/ClimbInputLatency.h"
+#include "ClimbingSystem/ClimbingCharacter.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "ClimbingSystem/CustomMovementComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+
+namespace ClimbingBenchmark
+{
+	constexpr int32 WarmupFrames = 60;
+	constexpr float DropHeight = 600.f;
+
+	/** Input script, in frames: climb press, move up, move right, climb press again */
+	constexpr int32 InputScriptPeriod = 120;
+	constexpr int32 InputScriptClimbPress = 0;
+	constexpr int32 InputScriptMoveUpStart = 40;
+	constexpr int32 InputScriptMoveRightStart = 60;
+	constexpr int32 InputScriptMoveFrames = 15;
+	constexpr int32 InputScriptReleasePress = 90;
+
+	static FAutoConsoleCommandWithWorldAndArgs ServerFrameTimeCommand(
+		TEXT("Climbing.Bench.ServerFrameTime"),
+		TEXT("Spawns N climbers and reports world tick time per 100 climbers. Args: <NumClimbers=100> <NumFrames=600> [quit]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UClimbingBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UClimbingBenchmarkSubsystem>() : nullptr;
+			if(!Benchmark) return;
+
+			const int32 NumClimbers = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 100;
+			const int32 NumFrames = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 600;
+			const bool bQuit = Args.Contains(TEXT("quit"));
+			Benchmark->StartBenchmark(TEXT("ServerFrameTime"), NumClimbers, NumFrames, bQuit);
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs LedgeCatchCommand(
+		TEXT("Climbing.Bench.LedgeCatch"),
+		TEXT("Drops N climbers onto the spawn grid at the origin, fails if a falling climber issues more than one query in a tick or none catches a ledge. Args: <NumClimbers=100> <NumFrames=300> [quit]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UClimbingBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UClimbingBenchmarkSubsystem>() : nullptr;
+			if(!Benchmark) return;
+
+			const int32 NumClimbers = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 100;
+			const int32 NumFrames = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 300;
+			const bool bQuit = Args.Contains(TEXT("quit"));
+			Benchmark->StartBenchmark(TEXT("LedgeCatch"), NumClimbers, NumFrames, bQuit, EClimbingBenchmarkScenario::LedgeCatch);
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs InputLatencyCommand(
+		TEXT("Climbing.Bench.InputLatency"),
+		TEXT("Drives N climbers with scripted climb and move inputs, reports input to motion latency p50/p95/p99 per traversal action. Args: <NumClimbers=20> <NumFrames=1200> [quit]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UClimbingBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UClimbingBenchmarkSubsystem>() : nullptr;
+			if(!Benchmark) return;
+
+			const int32 NumClimbers = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 20;
+			const int32 NumFrames = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 1200;
+			const bool bQuit = Args.Contains(TEXT("quit"));
+			Benchmark->StartBenchmark(TEXT("InputLatency"), NumClimbers, NumFrames, bQuit, EClimbingBenchmarkScenario::InputLatency);
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs TransitionsCommand(
+		TEXT("Climbing.Bench.Transitions"),
+		TEXT("Drives N climbers with scripted climb and move inputs, fails if a traversal action changes movement mode or refreshes overlaps more than once. Args: <NumClimbers=20> <NumFrames=1200> [quit]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UClimbingBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UClimbingBenchmarkSubsystem>() : nullptr;
+			if(!Benchmark) return;
+
+			const int32 NumClimbers = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 20;
+			const int32 NumFrames = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 1200;
+			const bool bQuit = Args.Contains(TEXT("quit"));
+			Benchmark->StartBenchmark(TEXT("Transitions"), NumClimbers, NumFrames, bQuit, EClimbingBenchmarkScenario::Transitions);
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs NetDormancyCommand(
+		TEXT("Climbing.Bench.NetDormancy"),
+		TEXT("On a server with a connected client, leaves N climbers hanging until they go dormant, then wakes them with AI move requests halfway through. Fails if any dormant climber stays asleep. Args: <NumClimbers=100> <NumFrames=900> [quit]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UClimbingBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UClimbingBenchmarkSubsystem>() : nullptr;
+			if(!Benchmark) return;
+
+			const int32 NumClimbers = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 100;
+			const int32 NumFrames = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 900;
+			const bool bQuit = Args.Contains(TEXT("quit"));
+			Benchmark->StartBenchmark(TEXT("NetDormancy"), NumClimbers, NumFrames, bQuit, EClimbingBenchmarkScenario::NetDormancy);
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs AnimBudgetCommand(
+		TEXT("Climbing.Bench.AnimBudget"),
+		TEXT("Spawns N climbers under the animation budget allocator and reports world tick time. Args: <NumClimbers=200> <NumFrames=600> <BudgetMs> [quit]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UClimbingBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UClimbingBenchmarkSubsystem>() : nullptr;
+			if(!Benchmark) return;
+
+			if(Args.IsValidIndex(2) && Args[2].IsNumeric())
+			{
+				GetMutableDefault<UClimbingSettings>()->AnimationBudgetMs = FMath::Max(0.1f, FCString::Atof(*Args[2]));
+				if(const UClimbingAnimationBudgetSubsystem* BudgetSubsystem = World->GetSubsystem<UClimbingAnimationBudgetSubsystem>())
+				{
+					BudgetSubsystem->ApplyBudgetSettings();
+				}
+			}
+
+			UE_LOG(LogClimbing, Display, TEXT("Climbing animation budget %.2f ms (enabled: %d)"),
+				UClimbingSettings::Get()->AnimationBudgetMs, UClimbingSettings::Get()->bUseAnimationBudget);
+
+			const int32 NumClimbers = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 200;
+			const int32 NumFrames = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 600;
+			const bool bQuit = Args.Contains(TEXT("quit"));
+			Benchmark->StartBenchmark(TEXT("AnimBudget"), NumClimbers, NumFrames, bQuit);
+		}));
+}
+
+void UClimbingBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UClimbingBenchmarkSubsystem::OnWorldTickStart);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UClimbingBenchmarkSubsystem::OnWorldPostActorTick);
+}
+
+void UClimbingBenchmarkSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	Super::Deinitialize();
+}
+
+bool UClimbingBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UClimbingBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbingBenchmarkSubsystem, STATGROUP_Climbing);
+}
+
+void UClimbingBenchmarkSubsystem::StartBenchmark(const FString& InBenchmarkName, int32 NumClimbers, int32 NumFrames,
+	bool bInQuitWhenDone, EClimbingBenchmarkScenario InScenario)
+{
+	if(bIsRunning)
+	{
+		UE_LOG(LogClimbing, Warning, TEXT("Climbing benchmark %s is already running"), *BenchmarkName);
+		return;
+	}
+
+	BenchmarkName = InBenchmarkName;
+	bQuitWhenDone = bInQuitWhenDone;
+	Scenario = InScenario;
+	ScriptedInputFrame = 0;
+	FallingTicks = 0;
+	FallingTickQueries = 0;
+	MaxFallingTickQueries = 0;
+	NumLedgeCatches = 0;
+	WarmupFramesRemaining = ClimbingBenchmark::WarmupFrames;
+	FramesRemaining = FMath::Max(NumFrames, 1);
+	DormancyCheckFramesRemaining = FramesRemaining / 2;
+	DormantBeforeWake = 0;
+	WokenByMoveRequest = 0;
+	DormantOutBytesPerSecond = 0;
+	WorldTickTimesMs.Reset(FramesRemaining);
+
+	SpawnBenchmarkClimbers(NumClimbers);
+	bIsRunning = true;
+}
+
+void UClimbingBenchmarkSubsystem::SpawnBenchmarkClimbers(int32 NumClimbers)
+{
+	UWorld* World = GetWorld();
+	UClass* ClimberClass = UClimbingSettings::Get()->BenchmarkCharacterClass.LoadSynchronous();
+	if(!ClimberClass)
+	{
+		ClimberClass = AClimbingCharacter::StaticClass();
+	}
+
+	const float Spacing = UClimbingSettings::Get()->BenchmarkSpawnSpacing;
+	const int32 RowLength = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt((float)NumClimbers)));
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for(int32 Index = 0; Index < NumClimbers; ++Index)
+	{
+		const bool bDropClimber = Scenario == EClimbingBenchmarkScenario::LedgeCatch;
+		const float SpawnHeight = 100.f + (Index / RowLength) * Spacing + (bDropClimber ? ClimbingBenchmark::DropHeight : 0.f);
+		const FVector SpawnLocation(0.f, (Index % RowLength) * Spacing, SpawnHeight);
+		AClimbingCharacter* Climber = World->SpawnActor<AClimbingCharacter>(ClimberClass, SpawnLocation, FRotator::ZeroRotator, SpawnParams);
+		if(!Climber) continue;
+
+		// Benchmark climbers have no controller, they still need to simulate
+		Climber->GetCustomMovementComponent()->bRunPhysicsWithNoController = true;
+		if(bDropClimber)
+		{
+			Climber->GetCustomMovementComponent()->DisableMovement();
+		}
+
+		// Nothing is rendered headless, montages still have to advance for their first frame of motion to show
+		if(Scenario == EClimbingBenchmarkScenario::InputLatency || Scenario == EClimbingBenchmarkScenario::Transitions)
+		{
+			Climber->GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPose;
+		}
+		BenchmarkClimbers.Add(Climber);
+	}
+}
+
+void UClimbingBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	if(!bIsRunning || WarmupFramesRemaining <= 0) return;
+
+	// Once settled, put everyone that can climb on the wall, let the dropped climbers fall or hand over to the input script
+	if(--WarmupFramesRemaining == 0)
+	{
+		if(Scenario == EClimbingBenchmarkScenario::InputLatency)
+		{
+			FClimbInputLatency::Get().Start();
+			return;
+		}
+
+		// Landing from the spawn drop is not a traversal action, counting starts once everyone stands
+		if(Scenario == EClimbingBenchmarkScenario::Transitions)
+		{
+			TransitionStartCounters.Reset(BenchmarkClimbers.Num());
+			for(const TWeakObjectPtr<AClimbingCharacter>& Climber : BenchmarkClimbers)
+			{
+				TransitionStartCounters.Add(Climber.IsValid() ? Climber->GetCustomMovementComponent()->GetTransitionCounters() : FTraversalTransitionCounters());
+			}
+			return;
+		}
+
+		for(const TWeakObjectPtr<AClimbingCharacter>& Climber : BenchmarkClimbers)
+		{
+			if(!Climber.IsValid()) continue;
+
+			if(Scenario == EClimbingBenchmarkScenario::LedgeCatch)
+			{
+				Climber->GetCustomMovementComponent()->SetMovementMode(MOVE_Falling);
+			}
+			else
+			{
+				Climber->GetCustomMovementComponent()->ToggleClimbing(true);
+			}
+		}
+	}
+}
+
+void UClimbingBenchmarkSubsystem::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if(World != GetWorld() || !bIsRunning) return;
+
+	WorldTickStartSeconds = FPlatformTime::Seconds();
+
+	if(WarmupFramesRemaining > 0) return;
+
+	// Ahead of the actor ticks, where a player controller would have processed its input
+	if(Scenario == EClimbingBenchmarkScenario::InputLatency || Scenario == EClimbingBenchmarkScenario::Transitions)
+	{
+		InjectScriptedInputs();
+		return;
+	}
+	if(Scenario != EClimbingBenchmarkScenario::LedgeCatch) return;
+
+	FallingTickStartQueries.SetNum(BenchmarkClimbers.Num());
+	for(int32 Index = 0; Index < BenchmarkClimbers.Num(); ++Index)
+	{
+		const AClimbingCharacter* Climber = BenchmarkClimbers[Index].Get();
+		const UCustomMovementComponent* Movement = Climber ? Climber->GetCustomMovementComponent() : nullptr;
+		FallingTickStartQueries[Index] = Movement && Movement->IsFalling() ? Movement->GetQueryTraceCount() : INDEX_NONE;
+	}
+}
+
+void UClimbingBenchmarkSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if(World != GetWorld() || !bIsRunning || WarmupFramesRemaining > 0) return;
+
+	WorldTickTimesMs.Add((FPlatformTime::Seconds() - WorldTickStartSeconds) * 1000.0);
+
+	for(int32 Index = 0; Index < FallingTickStartQueries.Num(); ++Index)
+	{
+		const AClimbingCharacter* Climber = BenchmarkClimbers[Index].Get();
+		if(!Climber || FallingTickStartQueries[Index] == INDEX_NONE) continue;
+
+		// A tick that catches a ledge or lands counts its queries up to the mode change, what the new mode probes is not the fall's
+		const UCustomMovementComponent* Movement = Climber->GetCustomMovementComponent();
+		NumLedgeCatches += Movement->IsHanging();
+		const int32 EndQueries = Movement->IsFalling() ? Movement->GetQueryTraceCount() : Movement->GetFallEndQueryTraceCount();
+
+		const int32 Queries = EndQueries - FallingTickStartQueries[Index];
+		++FallingTicks;
+		FallingTickQueries += Queries;
+		MaxFallingTickQueries = FMath::Max(MaxFallingTickQueries, Queries);
+	}
+
+	if(Scenario == EClimbingBenchmarkScenario::NetDormancy && --DormancyCheckFramesRemaining == 0)
+	{
+		CheckDormancyWake();
+	}
+
+	if(--FramesRemaining <= 0)
+	{
+		FinishBenchmark();
+	}
+}
+
+void UClimbingBenchmarkSubsystem::CheckDormancyWake()
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	DormantOutBytesPerSecond = NetDriver ? NetDriver->OutBytesPerSecond : 0u;
+
+	// The way path following drives an AI pawn, with no controller input in between
+	for(const TWeakObjectPtr<AClimbingCharacter>& Climber : BenchmarkClimbers)
+	{
+		if(!Climber.IsValid() || Climber->GetClimbReplicationTier() != EClimbReplicationTier::Idle) continue;
+
+		++DormantBeforeWake;
+		Climber->GetCustomMovementComponent()->RequestDirectMove(Climber->GetActorRightVector() * 100.f, false);
+		if(Climber->GetClimbReplicationTier() == EClimbReplicationTier::Active)
+		{
+			++WokenByMoveRequest;
+		}
+	}
+}
+
+void UClimbingBenchmarkSubsystem::InjectScriptedInputs()
+{
+	using namespace ClimbingBenchmark;
+
+	for(int32 Index = 0; Index < BenchmarkClimbers.Num(); ++Index)
+	{
+		AClimbingCharacter* Climber = BenchmarkClimbers[Index].Get();
+		if(!Climber) continue;
+
+		// Staggered so a crowd does not press on the same frame
+		const int32 Phase = (ScriptedInputFrame + Index * 7) % InputScriptPeriod;
+		if(Phase == InputScriptClimbPress || Phase == InputScriptReleasePress)
+		{
+			Climber->InjectClimbAction();
+		}
+		else if(Phase >= InputScriptMoveUpStart && Phase < InputScriptMoveUpStart + InputScriptMoveFrames)
+		{
+			Climber->InjectMoveInput(FVector2D(0.f, 1.f));
+		}
+		else if(Phase >= InputScriptMoveRightStart && Phase < InputScriptMoveRightStart + InputScriptMoveFrames)
+		{
+			Climber->InjectMoveInput(FVector2D(1.f, 0.f));
+		}
+	}
+	++ScriptedInputFrame;
+}
+
+void UClimbingBenchmarkSubsystem::FinishBenchmark()
+{
+	bIsRunning = false;
+
+	int32 ClimbingCount = 0;
+	for(const TWeakObjectPtr<AClimbingCharacter>& Climber : BenchmarkClimbers)
+	{
+		if(Climber.IsValid() && (Climber->GetCustomMovementComponent()->IsClimbing() || Climber->GetCustomMovementComponent()->IsHanging()))
+		{
+			++ClimbingCount;
+		}
+	}
+
+	WorldTickTimesMs.Sort();
+	double TotalMs = 0.0;
+	for(const double FrameMs : WorldTickTimesMs)
+	{
+		TotalMs += FrameMs;
+	}
+
+	const int32 NumSamples = WorldTickTimesMs.Num();
+	const double AverageMs = NumSamples > 0 ? TotalMs / NumSamples : 0.0;
+	const double MedianMs = NumSamples > 0 ? WorldTickTimesMs[NumSamples / 2] : 0.0;
+	const double P95Ms = NumSamples > 0 ? WorldTickTimesMs[FMath::Min(NumSamples - 1, (NumSamples * 95) / 100)] : 0.0;
+	const double PerHundredMs = BenchmarkClimbers.Num() > 0 ? AverageMs * 100.0 / BenchmarkClimbers.Num() : 0.0;
+
+	UE_LOG(LogClimbing, Display, TEXT("Climbing benchmark %s: %d climbers (%d climbing), %d frames, world tick avg %.3f ms, median %.3f ms, p95 %.3f ms, %.3f ms per 100 climbers"),
+		*BenchmarkName, BenchmarkClimbers.Num(), ClimbingCount, NumSamples, AverageMs, MedianMs, P95Ms, PerHundredMs);
+
+	bool bFailed = false;
+	if(Scenario == EClimbingBenchmarkScenario::InputLatency)
+	{
+		FClimbInputLatency::Get().Stop();
+		FClimbInputLatency::Get().LogReport(BenchmarkName);
+
+		// The script presses climb twice and moves up and right on the wall every period, each of these must have shown
+		for(const EClimbLatencyAction Action : {EClimbLatencyAction::EnterClimb, EClimbLatencyAction::ClimbMove, EClimbLatencyAction::ExitClimb})
+		{
+			if(FClimbInputLatency::Get().GetReport(Action).NumSamples == 0)
+			{
+				UE_LOG(LogClimbing, Error, TEXT("Climbing benchmark %s: no %s latency samples, the scripted input never produced its motion"),
+					*BenchmarkName, FClimbInputLatency::GetActionName(Action));
+				bFailed = true;
+			}
+		}
+	}
+	else if(Scenario == EClimbingBenchmarkScenario::LedgeCatch)
+	{
+		UE_LOG(LogClimbing, Display, TEXT("Climbing benchmark %s: %lld falling ticks, %.3f queries per falling tick, at most %d, %d ledge catches"),
+			*BenchmarkName, FallingTicks, FallingTicks > 0 ? (double)FallingTickQueries / FallingTicks : 0.0, MaxFallingTickQueries, NumLedgeCatches);
+
+		if(MaxFallingTickQueries > 1)
+		{
+			UE_LOG(LogClimbing, Error, TEXT("A falling climber issued %d queries in one tick, the ledge catch allows one"), MaxFallingTickQueries);
+			bFailed = true;
+		}
+		if(NumLedgeCatches == 0)
+		{
+			UE_LOG(LogClimbing, Error, TEXT("No dropped climber caught a ledge, the catch was never exercised. Run on a level with ledges under the spawn grid"));
+			bFailed = true;
+		}
+	}
+	else if(Scenario == EClimbingBenchmarkScenario::NetDormancy)
+	{
+		const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+		const int32 NumConnections = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+		UE_LOG(LogClimbing, Display, TEXT("Climbing benchmark %s: %d connections, %d climbers dormant halfway at %u bytes/s out, %d woken by a move request, %u bytes/s out at the end"),
+			*BenchmarkName, NumConnections, DormantBeforeWake, DormantOutBytesPerSecond, WokenByMoveRequest,
+			NetDriver ? NetDriver->OutBytesPerSecond : 0u);
+
+		if(NumConnections == 0)
+		{
+			UE_LOG(LogClimbing, Error, TEXT("No client connected, dormancy only runs on a server replicating to someone"));
+			bFailed = true;
+		}
+		else if(DormantBeforeWake == 0)
+		{
+			UE_LOG(LogClimbing, Error, TEXT("No climber went dormant before the wake, give the run more frames than IdleClimberDormancyDelay"));
+			bFailed = true;
+		}
+		if(WokenByMoveRequest < DormantBeforeWake)
+		{
+			UE_LOG(LogClimbing, Error, TEXT("%d of %d dormant climbers stayed asleep through an AI move request"),
+				DormantBeforeWake - WokenByMoveRequest, DormantBeforeWake);
+			bFailed = true;
+		}
+	}
+	else if(Scenario == EClimbingBenchmarkScenario::Transitions)
+	{
+		FTraversalTransitionCounters Total;
+		for(int32 Index = 0; Index < TransitionStartCounters.Num(); ++Index)
+		{
+			const AClimbingCharacter* Climber = BenchmarkClimbers[Index].Get();
+			if(!Climber) continue;
+
+			const FTraversalTransitionCounters& Start = TransitionStartCounters[Index];
+			const FTraversalTransitionCounters& End = Climber->GetCustomMovementComponent()->GetTransitionCounters();
+			Total.TraversalStateChanges += End.TraversalStateChanges - Start.TraversalStateChanges;
+			Total.MovementModeChanges += End.MovementModeChanges - Start.MovementModeChanges;
+			Total.RedundantModeChangesSkipped += End.RedundantModeChangesSkipped - Start.RedundantModeChangesSkipped;
+			Total.OverlapRefreshes += End.OverlapRefreshes - Start.OverlapRefreshes;
+			Total.IgnoredMontageEvents += End.IgnoredMontageEvents - Start.IgnoredMontageEvents;
+			Total.RejectedTransitions += End.RejectedTransitions - Start.RejectedTransitions;
+		}
+
+		UE_LOG(LogClimbing, Display, TEXT("Climbing benchmark %s: %d traversal actions, %d movement mode changes (%d redundant skipped), %d overlap refreshes, %d montage events ignored, %d transitions rejected"),
+			*BenchmarkName, Total.TraversalStateChanges, Total.MovementModeChanges, Total.RedundantModeChangesSkipped,
+			Total.OverlapRefreshes, Total.IgnoredMontageEvents, Total.RejectedTransitions);
+
+		// Each traversal action settles in at most one movement mode, and a mode change resizes the capsule at most once
+		if(Total.TraversalStateChanges == 0)
+		{
+			UE_LOG(LogClimbing, Error, TEXT("No climber made a traversal action, the level has nothing to climb in front of the spawn grid"));
+			bFailed = true;
+		}
+		if(Total.MovementModeChanges > Total.TraversalStateChanges)
+		{
+			UE_LOG(LogClimbing, Error, TEXT("%d movement mode changes for %d traversal actions"), Total.MovementModeChanges, Total.TraversalStateChanges);
+			bFailed = true;
+		}
+		if(Total.OverlapRefreshes > Total.MovementModeChanges)
+		{
+			UE_LOG(LogClimbing, Error, TEXT("%d overlap refreshes for %d movement mode changes"), Total.OverlapRefreshes, Total.MovementModeChanges);
+			bFailed = true;
+		}
+	}
+
+	for(const TWeakObjectPtr<AClimbingCharacter>& Climber : BenchmarkClimbers)
+	{
+		if(Climber.IsValid())
+		{
+			Climber->Destroy();
+		}
+	}
+	BenchmarkClimbers.Reset();
+	FallingTickStartQueries.Reset();
+	TransitionStartCounters.Reset();
+
+	if(bQuitWhenDone)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bFailed ? 1 : 0);
+	}
+}
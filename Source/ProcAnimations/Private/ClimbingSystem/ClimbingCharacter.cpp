@@ -14,13 +14,24 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "MotionWarpingComponent.h"
+#include "ClimbingSystem/ClimbIKComponent.h"
+#include "ClimbingSystem/ClimbingAnimationBudgetSubsystem.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingMemory.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "IAnimationBudgetAllocator.h"
+#include "SkeletalMeshComponentBudgeted.h"
 
 
 
 AClimbingCharacter::AClimbingCharacter(const FObjectInitializer& ObjectInitializer)
-	: Super(ObjectInitializer.SetDefaultSubobjectClass<UCustomMovementComponent>(ACharacter::CharacterMovementComponentName))
+	: Super(ObjectInitializer
+		.SetDefaultSubobjectClass<UCustomMovementComponent>(ACharacter::CharacterMovementComponentName)
+		.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
 {
+	LLM_SCOPE_BYTAG(Climbing_Character);
 
+#if !UE_SERVER
 	/** Default Wide TP Camera */
 
 	TPWideCameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("TPWideCameraBoom"));
@@ -63,9 +74,15 @@ AClimbingCharacter::AClimbingCharacter(const FObjectInitializer& ObjectInitializ
 
 	CombatCameraBoom->SetActive(false);
 	CombatCamera->SetActive(false);
-	
+#endif // !UE_SERVER
 	
 
+	// The budget allocator asks UClimbingAnimationBudgetSubsystem for the mesh's significance every update
+	if(USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh()))
+	{
+		BudgetedMesh->SetAutoCalculateSignificance(true);
+	}
+
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
 
@@ -92,16 +109,21 @@ AClimbingCharacter::AClimbingCharacter(const FObjectInitializer& ObjectInitializ
 
 
 	MotionWarpingComponent = CreateDefaultSubobject<UMotionWarpingComponent>("MotionWarpingComp");
+
+	ClimbIKComponent = CreateDefaultSubobject<UClimbIKComponent>("ClimbIKComp");
 }
 
 void AClimbingCharacter::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(Climbing_Character);
+
 	// Call the base class  
 	Super::BeginPlay();
 
 	GetCharacterMovement()->MaxWalkSpeed = WalkSpeed;
 	GetCustomMovementComponent()->MaxWalkSpeed = WalkSpeed;
-	
+
+#if !UE_SERVER
 	//Add Input Mapping Context
 	if (APlayerController* PlayerController = Cast<APlayerController>(Controller))
 	{
@@ -110,13 +132,96 @@ void AClimbingCharacter::BeginPlay()
 			Subsystem->AddMappingContext(DefaultMappingContext, 0);
 		}
 	}
+#endif // !UE_SERVER
+
+	if(IsNetMode(NM_DedicatedServer))
+	{
+		ApplyServerClimbingConfiguration();
+	}
 
 	if(CustomMovementComponent)
 	{
 		CustomMovementComponent->OnEnterClimbStateDelegate.BindUObject(this, &ThisClass::OnPlayerEnterClimbState);
 		CustomMovementComponent->OnExitClimbStateDelegate.BindUObject(this, &ThisClass::OnPlayerExitClimbState);
+		CustomMovementComponent->OnTraversalStateChangedDelegate.BindUObject(this, &ThisClass::OnTraversalStateChanged);
 		
 	}
+
+	DefaultNetUpdateFrequency = NetUpdateFrequency;
+	if(HasAuthority())
+	{
+		if(UClimbingReplicationSubsystem* ReplicationSubsystem = GetWorld()->GetSubsystem<UClimbingReplicationSubsystem>())
+		{
+			ReplicationSubsystem->RegisterClimber(this);
+		}
+	}
+}
+
+void AClimbingCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(UClimbingReplicationSubsystem* ReplicationSubsystem = GetWorld()->GetSubsystem<UClimbingReplicationSubsystem>())
+	{
+		ReplicationSubsystem->UnregisterClimber(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Replication
+
+bool AClimbingCharacter::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	if(!Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation)) return false;
+
+	if(ClimbReplicationTier != EClimbReplicationTier::Idle || IsOwnedBy(ViewTarget) || IsOwnedBy(RealViewer)) return true;
+
+	// A motionless climber is only worth replicating to viewers close enough to care
+	return FVector::DistSquared(SrcLocation, GetActorLocation()) <= FMath::Square(UClimbingSettings::Get()->IdleClimberNetCullDistance);
+}
+
+void AClimbingCharacter::AddMovementInput(FVector WorldDirection, float ScaleValue, bool bForce)
+{
+	if(ScaleValue != 0.f)
+	{
+		WakeClimbReplication();
+	}
+
+	Super::AddMovementInput(WorldDirection, ScaleValue, bForce);
+}
+
+void AClimbingCharacter::SetClimbReplicationTier(EClimbReplicationTier NewTier)
+{
+	if(ClimbReplicationTier == NewTier) return;
+	ClimbReplicationTier = NewTier;
+
+	switch(NewTier)
+	{
+	case EClimbReplicationTier::Active:
+		NetUpdateFrequency = DefaultNetUpdateFrequency;
+		SetNetDormancy(DORM_Awake);
+		break;
+	case EClimbReplicationTier::Idle:
+		// Going dormant sends the final state before the channel closes
+		NetUpdateFrequency = DefaultNetUpdateFrequency;
+		SetNetDormancy(DORM_DormantAll);
+		break;
+	case EClimbReplicationTier::Distant:
+		NetUpdateFrequency = FMath::Min(DefaultNetUpdateFrequency, UClimbingSettings::Get()->DistantClimberNetUpdateFrequency);
+		SetNetDormancy(DORM_Awake);
+		break;
+	}
+}
+
+void AClimbingCharacter::WakeClimbReplication()
+{
+	if(!HasAuthority() || ClimbReplicationTier != EClimbReplicationTier::Idle) return;
+
+	++ClimbReplicationWakes;
+	INC_DWORD_STAT(STAT_ClimbNet_DormancyWakes);
+
+	ClimbStationarySince = -1.0;
+	SetClimbReplicationTier(EClimbReplicationTier::Active);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -125,8 +230,24 @@ void AClimbingCharacter::BeginPlay()
 
 
 
+void AClimbingCharacter::ApplyServerClimbingConfiguration()
+{
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	if(!Settings->bStripPresentationOnServer) return;
+
+	// Nothing is ever rendered on a dedicated server, so only montages tick. That keeps root motion authoritative
+	GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+
+	if(ClimbIKComponent)
+	{
+		ClimbIKComponent->SetComponentTickEnabled(false);
+	}
+}
+
 void AClimbingCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent)
 {
+#if !UE_SERVER
 	// Set up action bindings
 	if (UEnhancedInputComponent* EnhancedInputComponent = CastChecked<UEnhancedInputComponent>(PlayerInputComponent)) {
 		
@@ -157,14 +278,14 @@ void AClimbingCharacter::SetupPlayerInputComponent(class UInputComponent* Player
 		EnhancedInputComponent->BindAction(CrouchAction, ETriggerEvent::Started, this, &AClimbingCharacter::Crouching);
 
 	}
-
+#endif // !UE_SERVER
 }
 
 
 void AClimbingCharacter::Move(const FInputActionValue& Value)
 {
 	if(!CustomMovementComponent) return;
-	if(CustomMovementComponent->IsClimbing())
+	if(CustomMovementComponent->IsClimbing() || CustomMovementComponent->IsHanging())
 	{
 		HandleClimbMovementInput(Value);
 	}
@@ -211,6 +332,10 @@ void AClimbingCharacter::ToggleRun(const FInputActionValue& Value)
 		if (!Value.Get<bool>())
 			return;
 
+		// Cameras are never created on a dedicated server
+		if (!TPWideCameraBoom)
+			return;
+
 		// Increment camera index and loop back if it exceeds the limit
 		CurrentActiveCamera = (CurrentActiveCamera + 1) % 3;
 
@@ -299,14 +424,15 @@ void AClimbingCharacter::OnClimbActionStarted(const FInputActionValue& Value)
 	
 	if(!CustomMovementComponent)return;
 
-	if(!CustomMovementComponent->IsClimbing())
+	CustomMovementComponent->StampClimbInput();
+	if(!CustomMovementComponent->IsClimbing() && !CustomMovementComponent->IsHanging())
 	{
 		
-		CustomMovementComponent->ToggleClimbing(true);
+		CustomMovementComponent->RequestClimbToggle(true);
 	}
 	else
 	{
-		CustomMovementComponent->ToggleClimbing(false);
+		CustomMovementComponent->RequestClimbToggle(false);
 	}
 }
 
@@ -337,6 +463,10 @@ void AClimbingCharacter::HandleClimbMovementInput(const FInputActionValue& Value
 {
 	// input is a Vector2D
 	const FVector2D MovementVector = Value.Get<FVector2D>();
+	if(!MovementVector.IsZero())
+	{
+		CustomMovementComponent->StampMoveInput();
+	}
 
 	// get right vector
 	const FVector ForwardDirection = FVector::CrossProduct(
@@ -355,6 +485,16 @@ void AClimbingCharacter::HandleClimbMovementInput(const FInputActionValue& Value
 	AddMovementInput(RightDirection, MovementVector.X);
 }
 
+void AClimbingCharacter::InjectClimbAction()
+{
+	OnClimbActionStarted(FInputActionValue(true));
+}
+
+void AClimbingCharacter::InjectMoveInput(const FVector2D& MoveInput)
+{
+	Move(FInputActionValue(MoveInput));
+}
+
 void AClimbingCharacter::OnPlayerEnterClimbState()
 {
 }
@@ -363,7 +503,21 @@ void AClimbingCharacter::OnPlayerExitClimbState()
 {
 }
 
+void AClimbingCharacter::OnTraversalStateChanged(ETraversalState NewState)
+{
+	WakeClimbReplication();
 
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh());
+	IAnimationBudgetAllocator* AnimationBudgetAllocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if(!BudgetedMesh || !AnimationBudgetAllocator || BudgetedMesh->GetAnimationBudgetHandle() == INDEX_NONE) return;
 
+	// Montage driven transitions must not be skipped or they drift from the movement component state.
+	// Only the flags change here, the significance itself stays auto calculated from distance
+	const bool bPlayingTraversalMontage =
+		NewState == ETraversalState::Entering ||
+		NewState == ETraversalState::ToppingOut ||
+		NewState == ETraversalState::Vaulting;
 
-
+	AnimationBudgetAllocator->SetComponentSignificance(BudgetedMesh, UClimbingAnimationBudgetSubsystem::CalculateClimberSignificance(BudgetedMesh),
+		bPlayingTraversalMontage, bPlayingTraversalMontage, !bPlayingTraversalMontage);
+}
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbingMemory.h"
+
+#include "Animation/AnimInstance.h"
+#include "Camera/CameraComponent.h"
+#include "ClimbingSystem/ClimbIKComponent.h"
+#include "ClimbingSystem/ClimbingCharacter.h"
+#include "ClimbingSystem/CustomMovementComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "MotionWarpingComponent.h"
+
+LLM_DEFINE_TAG(Climbing);
+LLM_DEFINE_TAG(Climbing_Character, TEXT("Character"), TEXT("Climbing"));
+LLM_DEFINE_TAG(Climbing_Movement, TEXT("Movement"), TEXT("Climbing"));
+LLM_DEFINE_TAG(Climbing_Queries, TEXT("Queries"), TEXT("Climbing"));
+LLM_DEFINE_TAG(Climbing_IK, TEXT("IK"), TEXT("Climbing"));
+LLM_DEFINE_TAG(Climbing_TraversalIndex, TEXT("TraversalIndex"), TEXT("Climbing"));
+LLM_DEFINE_TAG(Climbing_FlightRecorder, TEXT("FlightRecorder"), TEXT("Climbing"));
+LLM_DEFINE_TAG(Climbing_Validation, TEXT("Validation"), TEXT("Climbing"));
+
+int64 FClimbingMemoryFootprint::GetTotal() const
+{
+	int64 Total = 0;
+	for(const int64 CategoryBytes : Bytes)
+	{
+		Total += CategoryBytes;
+	}
+	return Total;
+}
+
+void FClimbingMemoryFootprint::Accumulate(const FClimbingMemoryFootprint& Other)
+{
+	for(int32 Category = 0; Category < (int32)EClimbingMemoryCategory::Num; ++Category)
+	{
+		Bytes[Category] += Other.Bytes[Category];
+	}
+}
+
+void FClimbingMemoryFootprint::Max(const FClimbingMemoryFootprint& Other)
+{
+	for(int32 Category = 0; Category < (int32)EClimbingMemoryCategory::Num; ++Category)
+	{
+		Bytes[Category] = FMath::Max(Bytes[Category], Other.Bytes[Category]);
+	}
+}
+
+const TCHAR* ClimbingMemory::GetCategoryName(EClimbingMemoryCategory Category)
+{
+	switch(Category)
+	{
+	case EClimbingMemoryCategory::Actor: return TEXT("Actor");
+	case EClimbingMemoryCategory::Cameras: return TEXT("Cameras");
+	case EClimbingMemoryCategory::Movement: return TEXT("Movement");
+	case EClimbingMemoryCategory::MotionWarping: return TEXT("MotionWarping");
+	case EClimbingMemoryCategory::IK: return TEXT("IK");
+	case EClimbingMemoryCategory::Mesh: return TEXT("Mesh");
+	case EClimbingMemoryCategory::Animation: return TEXT("Animation");
+	case EClimbingMemoryCategory::OtherComponents: return TEXT("OtherComponents");
+	default: return TEXT("Unknown");
+	}
+}
+
+int64 ClimbingMemory::GetObjectBytes(const UObject* Object)
+{
+	if(!Object) return 0;
+
+	return Object->GetClass()->GetStructureSize() + const_cast<UObject*>(Object)->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+}
+
+void ClimbingMemory::GatherFootprint(const AClimbingCharacter* Character, FClimbingMemoryFootprint& OutFootprint)
+{
+	OutFootprint = FClimbingMemoryFootprint();
+	if(!Character) return;
+
+	auto Add = [&OutFootprint](EClimbingMemoryCategory Category, int64 Bytes)
+	{
+		OutFootprint.Bytes[(uint8)Category] += Bytes;
+	};
+
+	Add(EClimbingMemoryCategory::Actor, GetObjectBytes(Character));
+
+	for(const UActorComponent* Component : Character->GetComponents())
+	{
+		if(Component->IsA<USpringArmComponent>() || Component->IsA<UCameraComponent>())
+		{
+			Add(EClimbingMemoryCategory::Cameras, GetObjectBytes(Component));
+		}
+		else if(Component->IsA<UCustomMovementComponent>())
+		{
+			Add(EClimbingMemoryCategory::Movement, GetObjectBytes(Component));
+		}
+		else if(Component->IsA<UMotionWarpingComponent>())
+		{
+			Add(EClimbingMemoryCategory::MotionWarping, GetObjectBytes(Component));
+		}
+		else if(Component->IsA<UClimbIKComponent>())
+		{
+			Add(EClimbingMemoryCategory::IK, GetObjectBytes(Component));
+		}
+		else if(const USkeletalMeshComponent* MeshComponent = Cast<USkeletalMeshComponent>(Component))
+		{
+			// The pose buffers are per instance, the mesh asset's render data is shared and left out
+			Add(EClimbingMemoryCategory::Mesh, MeshComponent->GetClass()->GetStructureSize()
+				+ MeshComponent->GetComponentSpaceTransforms().GetAllocatedSize() * 2
+				+ MeshComponent->GetBoneSpaceTransforms().GetAllocatedSize());
+
+			if(const UAnimInstance* AnimInstance = MeshComponent->GetAnimInstance())
+			{
+				Add(EClimbingMemoryCategory::Animation, GetObjectBytes(AnimInstance)
+					+ AnimInstance->MontageInstances.GetAllocatedSize()
+					+ AnimInstance->MontageInstances.Num() * sizeof(FAnimMontageInstance)
+					+ AnimInstance->ActiveMontagesMap.GetAllocatedSize());
+			}
+		}
+		else
+		{
+			Add(EClimbingMemoryCategory::OtherComponents, GetObjectBytes(Component));
+		}
+	}
+}
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbingMemorySubsystem.h"
+
+#include "ClimbingSystem/ClimbingCharacter.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+namespace ClimbingMemoryReport
+{
+	static FAutoConsoleCommandWithWorldAndArgs ReportCommand(
+		TEXT("Climbing.MemReport"),
+		TEXT("Logs climber memory per class and category with high-water marks. Climbing.MemReport Instances also lists every climber"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(!World) return;
+
+			if(UClimbingMemorySubsystem* MemorySubsystem = World->GetSubsystem<UClimbingMemorySubsystem>())
+			{
+				const bool bListInstances = Args.Num() > 0 && Args[0].Equals(TEXT("Instances"), ESearchCase::IgnoreCase);
+				MemorySubsystem->LogMemoryReport(bListInstances);
+			}
+		}));
+
+	static FString FormatFootprint(const FClimbingMemoryFootprint& Footprint)
+	{
+		FString Line;
+		for(int32 Category = 0; Category < (int32)EClimbingMemoryCategory::Num; ++Category)
+		{
+			Line += FString::Printf(TEXT("%s %.1f KB  "), ClimbingMemory::GetCategoryName((EClimbingMemoryCategory)Category), Footprint.Bytes[Category] / 1024.0);
+		}
+		return Line;
+	}
+}
+
+bool UClimbingMemorySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UClimbingMemorySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbingMemorySubsystem, STATGROUP_Climbing);
+}
+
+void UClimbingMemorySubsystem::Tick(float DeltaTime)
+{
+	const float SampleInterval = UClimbingSettings::Get()->ClimbingMemorySampleInterval;
+	if(SampleInterval <= 0.f) return;
+
+	TimeUntilSample -= DeltaTime;
+	if(TimeUntilSample > 0.f) return;
+
+	TimeUntilSample = SampleInterval;
+	SampleFootprints();
+}
+
+void UClimbingMemorySubsystem::SampleFootprints()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ClimbingMemory_Sample);
+
+	for(TPair<FName, FClassMemoryRecord>& Pair : ClassRecords)
+	{
+		Pair.Value.Count = 0;
+		Pair.Value.Current = FClimbingMemoryFootprint();
+	}
+
+	int64 TotalBytes = 0;
+	for(TActorIterator<AClimbingCharacter> It(GetWorld()); It; ++It)
+	{
+		FClimbingMemoryFootprint Footprint;
+		ClimbingMemory::GatherFootprint(*It, Footprint);
+		TotalBytes += Footprint.GetTotal();
+
+		FClassMemoryRecord& Record = ClassRecords.FindOrAdd(It->GetClass()->GetFName());
+		++Record.Count;
+		Record.Current.Accumulate(Footprint);
+		Record.HighWaterInstance.Max(Footprint);
+	}
+
+	for(TPair<FName, FClassMemoryRecord>& Pair : ClassRecords)
+	{
+		Pair.Value.HighWaterCount = FMath::Max(Pair.Value.HighWaterCount, Pair.Value.Count);
+		Pair.Value.HighWaterTotal.Max(Pair.Value.Current);
+	}
+
+	SET_MEMORY_STAT(STAT_ClimbingMemory_Climbers, TotalBytes);
+}
+
+void UClimbingMemorySubsystem::LogMemoryReport(bool bListInstances)
+{
+	using namespace ClimbingMemoryReport;
+
+	SampleFootprints();
+
+	for(const TPair<FName, FClassMemoryRecord>& Pair : ClassRecords)
+	{
+		const FClassMemoryRecord& Record = Pair.Value;
+		const double AverageKB = Record.Count > 0 ? Record.Current.GetTotal() / 1024.0 / Record.Count : 0.0;
+
+		UE_LOG(LogClimbing, Display, TEXT("%s: %d instances (high-water %d), %.1f KB total, %.1f KB each"),
+			*Pair.Key.ToString(), Record.Count, Record.HighWaterCount, Record.Current.GetTotal() / 1024.0, AverageKB);
+		UE_LOG(LogClimbing, Display, TEXT("  current     %s"), *FormatFootprint(Record.Current));
+		UE_LOG(LogClimbing, Display, TEXT("  high-water  %s"), *FormatFootprint(Record.HighWaterTotal));
+		UE_LOG(LogClimbing, Display, TEXT("  largest one %s"), *FormatFootprint(Record.HighWaterInstance));
+	}
+
+	if(!bListInstances) return;
+
+	for(TActorIterator<AClimbingCharacter> It(GetWorld()); It; ++It)
+	{
+		FClimbingMemoryFootprint Footprint;
+		ClimbingMemory::GatherFootprint(*It, Footprint);
+		UE_LOG(LogClimbing, Display, TEXT("%s: %.1f KB  %s"), *It->GetName(), Footprint.GetTotal() / 1024.0, *FormatFootprint(Footprint));
+	}
+}
@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbingReplicationSubsystem.h"
+
+#include "Animation/AnimInstance.h"
+#include "ClimbingSystem/ClimbingCharacter.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "ClimbingSystem/CustomMovementComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+namespace ClimbingReplication
+{
+	static FAutoConsoleCommandWithWorldAndArgs ReportCommand(
+		TEXT("Climbing.Net.Report"),
+		TEXT("Logs climber replication tier counts, dormancy wakes and outgoing server bandwidth"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(!World) return;
+
+			if(const UClimbingReplicationSubsystem* ReplicationSubsystem = World->GetSubsystem<UClimbingReplicationSubsystem>())
+			{
+				ReplicationSubsystem->LogReplicationReport();
+			}
+		}));
+}
+
+void UClimbingReplicationSubsystem::RegisterClimber(AClimbingCharacter* Climber)
+{
+	Climbers.AddUnique(Climber);
+}
+
+void UClimbingReplicationSubsystem::UnregisterClimber(AClimbingCharacter* Climber)
+{
+	Climbers.RemoveSwap(Climber);
+}
+
+bool UClimbingReplicationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UClimbingReplicationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbingReplicationSubsystem, STATGROUP_Climbing);
+}
+
+void UClimbingReplicationSubsystem::Tick(float DeltaTime)
+{
+	const ENetMode NetMode = GetWorld()->GetNetMode();
+	if(NetMode == NM_Client || NetMode == NM_Standalone) return;
+
+	SET_DWORD_STAT(STAT_ClimbNet_ActiveClimbers, TierCounts[(uint8)EClimbReplicationTier::Active]);
+	SET_DWORD_STAT(STAT_ClimbNet_IdleClimbers, TierCounts[(uint8)EClimbReplicationTier::Idle]);
+	SET_DWORD_STAT(STAT_ClimbNet_DistantClimbers, TierCounts[(uint8)EClimbReplicationTier::Distant]);
+
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	if(!Settings->bUseClimberReplicationTiers) return;
+
+	TimeUntilEvaluation -= DeltaTime;
+	if(TimeUntilEvaluation > 0.f) return;
+	TimeUntilEvaluation = Settings->ClimberReplicationTierInterval;
+
+	SCOPE_CYCLE_COUNTER(STAT_ClimbNet_EvaluateTiers);
+
+	Climbers.RemoveAllSwap([](const TWeakObjectPtr<AClimbingCharacter>& Climber) { return !Climber.IsValid(); });
+
+	TArray<FVector> ViewLocations;
+	GatherViewLocations(ViewLocations);
+
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	FMemory::Memzero(TierCounts);
+	for(const TWeakObjectPtr<AClimbingCharacter>& WeakClimber : Climbers)
+	{
+		AClimbingCharacter* Climber = WeakClimber.Get();
+		const EClimbReplicationTier Tier = EvaluateTier(Climber, ViewLocations, WorldTime);
+		Climber->SetClimbReplicationTier(Tier);
+		++TierCounts[(uint8)Tier];
+	}
+}
+
+EClimbReplicationTier UClimbingReplicationSubsystem::EvaluateTier(AClimbingCharacter* Climber,
+	const TArray<FVector>& ViewLocations, double WorldTime)
+{
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	const UCustomMovementComponent* MovementComponent = Climber->GetCustomMovementComponent();
+	const UAnimInstance* AnimInstance = Climber->GetMesh() ? Climber->GetMesh()->GetAnimInstance() : nullptr;
+
+	const bool bHangingStill = MovementComponent &&
+		(MovementComponent->GetTraversalState() == ETraversalState::Climbing || MovementComponent->GetTraversalState() == ETraversalState::Hanging) &&
+		MovementComponent->GetUnrotatedClimbVelocity().IsNearlyZero() &&
+		!(AnimInstance && AnimInstance->IsAnyMontagePlaying());
+
+	if(!bHangingStill)
+	{
+		Climber->ClimbStationarySince = -1.0;
+	}
+	else if(Climber->ClimbStationarySince < 0.0)
+	{
+		Climber->ClimbStationarySince = WorldTime;
+	}
+
+	// Player pawns keep talking to their owning connection every move, so only AI climbers go dormant
+	const bool bCanGoDormant = Settings->bUseClimberNetDormancy && !Climber->IsPlayerControlled();
+	if(bHangingStill && bCanGoDormant && WorldTime - Climber->ClimbStationarySince >= Settings->IdleClimberDormancyDelay)
+	{
+		return EClimbReplicationTier::Idle;
+	}
+
+	float ClosestDistanceSq = MAX_flt;
+	const FVector ClimberLocation = Climber->GetActorLocation();
+	for(const FVector& ViewLocation : ViewLocations)
+	{
+		ClosestDistanceSq = FMath::Min(ClosestDistanceSq, FVector::DistSquared(ViewLocation, ClimberLocation));
+	}
+
+	return ClosestDistanceSq > FMath::Square(Settings->DistantClimberNetDistance)
+		? EClimbReplicationTier::Distant
+		: EClimbReplicationTier::Active;
+}
+
+void UClimbingReplicationSubsystem::GatherViewLocations(TArray<FVector>& OutViewLocations) const
+{
+	// On the server this covers every connected player, not just local ones
+	for(FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if(!PlayerController) continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		OutViewLocations.Add(ViewLocation);
+	}
+}
+
+void UClimbingReplicationSubsystem::LogReplicationReport() const
+{
+	int32 DormancyWakes = 0;
+	for(const TWeakObjectPtr<AClimbingCharacter>& Climber : Climbers)
+	{
+		if(Climber.IsValid())
+		{
+			DormancyWakes += Climber->GetClimbReplicationWakes();
+		}
+	}
+
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	UE_LOG(LogClimbing, Display, TEXT("Climb replication: %d climbers, %d active, %d idle (dormant), %d distant, %d dormancy wakes, %u bytes/s out to %d connections"),
+		Climbers.Num(),
+		TierCounts[(uint8)EClimbReplicationTier::Active],
+		TierCounts[(uint8)EClimbReplicationTier::Idle],
+		TierCounts[(uint8)EClimbReplicationTier::Distant],
+		DormancyWakes,
+		NetDriver ? NetDriver->OutBytesPerSecond : 0u,
+		NetDriver ? NetDriver->ClientConnections.Num() : 0);
+}
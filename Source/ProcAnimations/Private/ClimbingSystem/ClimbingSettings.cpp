@@ -0,0 +1,10 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbingSettings.h"
+
+UClimbingSettings::UClimbingSettings()
+{
+	CategoryName = TEXT("Game");
+	SectionName = TEXT("Climbing");
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/ClimbingStats.h"
+
+DEFINE_LOG_CATEGORY(LogClimbing);
+
+DEFINE_STAT(STAT_ClimbIK_Schedule);
+DEFINE_STAT(STAT_ClimbIK_Update);
+DEFINE_STAT(STAT_ClimbIK_LimbTraces);
+DEFINE_STAT(STAT_ClimbIK_ReusedSurfaceHits);
+DEFINE_STAT(STAT_ClimbIK_ActiveClimbers);
+DEFINE_STAT(STAT_ClimbIK_DegradedClimbers);
+
+DEFINE_STAT(STAT_TraversalQueries_Served);
+DEFINE_STAT(STAT_TraversalQueries_Deferred);
+DEFINE_STAT(STAT_TraversalQueries_Dropped);
+DEFINE_STAT(STAT_TraversalQueries_Traces);
+
+DEFINE_STAT(STAT_Coalescer_AgentQueries);
+DEFINE_STAT(STAT_Coalescer_SceneQueries);
+DEFINE_STAT(STAT_Coalescer_NarrowphaseQueries);
+DEFINE_STAT(STAT_Coalescer_QueriesSaved);
+
+DEFINE_STAT(STAT_ClimbNet_EvaluateTiers);
+DEFINE_STAT(STAT_ClimbNet_ActiveClimbers);
+DEFINE_STAT(STAT_ClimbNet_IdleClimbers);
+DEFINE_STAT(STAT_ClimbNet_DistantClimbers);
+DEFINE_STAT(STAT_ClimbNet_DormancyWakes);
+
+DEFINE_STAT(STAT_ClimbAsync_Step);
+
+DEFINE_STAT(STAT_ClimbSeparation_Update);
+DEFINE_STAT(STAT_ClimbSeparation_Climbers);
+DEFINE_STAT(STAT_ClimbSeparation_NeighbourPairs);
+DEFINE_STAT(STAT_ClimbSeparation_SweepImpacts);
+
+DEFINE_STAT(STAT_TraversalIndex_Streaming);
+DEFINE_STAT(STAT_TraversalIndex_ResidentCells);
+DEFINE_STAT(STAT_TraversalIndex_Queries);
+
+DEFINE_STAT(STAT_TraversalEQS_Test);
+DEFINE_STAT(STAT_TraversalEQS_Items);
+DEFINE_STAT(STAT_TraversalEQS_Traces);
+DEFINE_STAT(STAT_TraversalEQS_OverBudget);
+
+DEFINE_STAT(STAT_ClimbValidation_Update);
+DEFINE_STAT(STAT_ClimbValidation_Claims);
+DEFINE_STAT(STAT_ClimbValidation_Suspicious);
+DEFINE_STAT(STAT_ClimbValidation_GeometryTraces);
+DEFINE_STAT(STAT_ClimbValidation_Expired);
+DEFINE_STAT(STAT_ClimbValidation_Dropped);
+DEFINE_STAT(STAT_ClimbValidation_Pending);
+
+DEFINE_STAT(STAT_ClimbingMemory_Sample);
+DEFINE_STAT(STAT_ClimbingMemory_Climbers);
+
+DEFINE_STAT(STAT_ClimbTick_Climb);
+DEFINE_STAT(STAT_ClimbTick_Hang);
+
+DEFINE_STAT(STAT_WallRun_Tick);
+DEFINE_STAT(STAT_WallRun_Probes);
+
+DEFINE_STAT(STAT_ClimbStreaming_Update);
+DEFINE_STAT(STAT_ClimbStreaming_Sources);
+DEFINE_STAT(STAT_ClimbStreaming_Holding);
+DEFINE_STAT(STAT_ClimbStreaming_ProbesSuppressed);
+
+DEFINE_STAT(STAT_LedgeCatch_Probes);
+DEFINE_STAT(STAT_LedgeCatch_Catches);
@@ -8,55 +8,326 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "ClimbingSystem/ClimbingCharacter.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "KismetTraceUtils.h"
 #include "ProcAnimations/DebugHelper.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "ClimbingSystem/ClimbingMemory.h"
+#include "ClimbingSystem/ClimbFlightRecorder.h"
+#include "ClimbingSystem/ClimbQueryHeatmap.h"
+#include "ClimbingSystem/ClimberSeparationSubsystem.h"
+#include "ClimbingSystem/ClimbStreamingSubsystem.h"
+#include "ClimbingSystem/ClimbMoveValidationSubsystem.h"
+#include "ClimbingSystem/TraversalIndexSubsystem.h"
+#include "ClimbingSystem/TraversalIndexWriter.h"
+#include "ClimbingSystem/ClimbMath.h"
+#include "ClimbingSystem/RootMotionSource_BakedTraversal.h"
+#include "ClimbingSystem/TraversalMotionData.h"
+#include "ClimbingSystem/TraversalQueryCoalescer.h"
+#include "ClimbingSystem/ClimbProxyComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+namespace ClimbAsyncPhysicsCVars
+{
+	static bool bParityCheck = false;
+	static FAutoConsoleVariableRef CVarParityCheck(
+		TEXT("Climbing.AsyncPhysics.ParityCheck"),
+		bParityCheck,
+		TEXT("Runs the game thread climb step on every input handed to the async physics step and logs where the physics thread result diverges from it"));
+}
+
+namespace BakedTraversalCVars
+{
+	static bool bParityCheck = false;
+	static FAutoConsoleVariableRef CVarParityCheck(
+		TEXT("Climbing.BakedTraversal.ParityCheck"),
+		bParityCheck,
+		TEXT("Logs how far every finished traversal ends from where its montage's root motion ends, on whichever machine runs it"));
+}
+
+namespace ClimbTickCost
+{
+	struct FModeCost
+	{
+		uint64 Cycles = 0;
+		uint64 Ticks = 0;
+		uint64 Traces = 0;
+	};
+
+	/** Totals over every climber, game thread only */
+	static FModeCost ClimbCost;
+	static FModeCost HangCost;
+	static FModeCost WallRunCost;
+
+	struct FScope
+	{
+		FScope(FModeCost& InCost, const int32& InTraceCount)
+			: Cost(InCost), TraceCount(InTraceCount), StartTraceCount(InTraceCount), StartCycles(FPlatformTime::Cycles64())
+		{
+		}
+
+		~FScope()
+		{
+			Cost.Cycles += FPlatformTime::Cycles64() - StartCycles;
+			Cost.Traces += TraceCount - StartTraceCount;
+			++Cost.Ticks;
+		}
+
+		FModeCost& Cost;
+		const int32& TraceCount;
+		int32 StartTraceCount;
+		uint64 StartCycles;
+	};
+
+	static void LogModeCost(const TCHAR* Name, const FModeCost& Cost)
+	{
+		const double Ticks = FMath::Max<double>(Cost.Ticks, 1.0);
+		UE_LOG(LogClimbing, Log, TEXT("  %s: %llu ticks, %.2f us/tick, %.2f traces/tick"), Name, Cost.Ticks,
+			FPlatformTime::ToMilliseconds64(Cost.Cycles) * 1000.0 / Ticks, Cost.Traces / Ticks);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs ReportCommand(
+		TEXT("Climbing.TickCost.Report"),
+		TEXT("Logs the average cost of a climb, hang and wall run tick. Reset clears the totals"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(Args.Num() > 0 && Args[0] == TEXT("Reset"))
+			{
+				ClimbCost = FModeCost();
+				HangCost = FModeCost();
+				WallRunCost = FModeCost();
+				return;
+			}
+
+			UE_LOG(LogClimbing, Log, TEXT("Climb tick cost:"));
+			LogModeCost(TEXT("Climb"), ClimbCost);
+			LogModeCost(TEXT("Hang"), HangCost);
+			LogModeCost(TEXT("Wall Run"), WallRunCost);
+		}));
+}
 
 void UCustomMovementComponent::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(Climbing_Movement);
+
 	Super::BeginPlay();
 
 	OwningPlayerAnimInstance = CharacterOwner->GetMesh()->GetAnimInstance();
 
 	if(OwningPlayerAnimInstance)
 	{
-		OwningPlayerAnimInstance->OnMontageEnded.AddDynamic(this,&UCustomMovementComponent::OnClimbMontageEnded);
+		// Blending out always fires first, so it alone drives traversal transitions
 		OwningPlayerAnimInstance->OnMontageBlendingOut.AddDynamic(this,&UCustomMovementComponent::OnClimbMontageEnded);
 	}
 	OwningPlayerCharacter = Cast<AClimbingCharacter>(CharacterOwner);
+
+	TraversalQueryGovernor = GetWorld()->GetSubsystem<UTraversalQueryGovernor>();
+	TraversalQueryCoalescer = GetWorld()->GetSubsystem<UTraversalQueryCoalescer>();
+	ClimberSeparationSubsystem = GetWorld()->GetSubsystem<UClimberSeparationSubsystem>();
+	ClimbStreamingSubsystem = GetWorld()->GetSubsystem<UClimbStreamingSubsystem>();
+	if(ClimbStreamingSubsystem)
+	{
+		ClimbStreamingSubsystem->RegisterClimber(this);
+	}
+	TraversalIndex = GetWorld()->GetSubsystem<UTraversalIndexSubsystem>();
+	if(UClimbingSettings::Get()->bUseClimbProxyChannel)
+	{
+		ClimbTraceObjectTypes = {UEngineTypes::ConvertToObjectType(ECC_ClimbProxy)};
+	}
+	else
+	{
+		ClimbTraceObjectTypes = ClimbableSurfaceTraceTypes;
+	}
+	ClimbableSurfaceObjectQueryParams = FCollisionObjectQueryParams(ClimbTraceObjectTypes);
+	WorldObjectQueryParams = FCollisionObjectQueryParams(ClimbableSurfaceTraceTypes);
+
+	FallbackClimbGrip.MaxClimbSpeed = MaxClimbSpeed;
+	FallbackClimbGrip.CacheSlopeLimits();
+	CurrentClimbGrip = FallbackClimbGrip;
+
+	if(UClimbingSettings::Get()->bValidateClimbMoves && GetOwnerRole() == ROLE_Authority && GetNetMode() != NM_Standalone)
+	{
+		ClimbMoveValidator = GetWorld()->GetSubsystem<UClimbMoveValidationSubsystem>();
+		ClimbMoveHistory.Init(UClimbingSettings::Get()->ClimbMoveHistoryLength);
+	}
+
+	if(UClimbingSettings::Get()->bUseAsyncPhysicsClimb)
+	{
+		if(UPhysicsSettings::Get()->bTickPhysicsAsync)
+		{
+			SetAsyncPhysicsTickEnabled(true);
+			bAsyncPhysicsClimbActive = true;
+		}
+		else
+		{
+			UE_LOG(LogClimbing, Warning, TEXT("bUseAsyncPhysicsClimb needs Tick Physics Async enabled in the physics settings, climbing stays on the game thread"));
+		}
+	}
+}
+
+void UCustomMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(ClimbStreamingSubsystem)
+	{
+		ClimbStreamingSubsystem->UnregisterClimber(this);
+	}
+	if(ClimberSeparationSubsystem)
+	{
+		ClimberSeparationSubsystem->UnregisterClimber(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UCustomMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType,
                                              FActorComponentTickFunction* ThisTickFunction)
 {
+	LLM_SCOPE_BYTAG(Climbing_Movement);
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	// A baked traversal has no montage to watch, its root motion moved the climber in this tick
+	if(ActiveBakedTraversalID != 0 && GetInputLatencyMontage())
+	{
+		ResolveClimbInputLatency();
+	}
+	UpdateBakedTraversal();
 	CanClimbDownLedge();
 }
 
+void UCustomMovementComponent::AsyncPhysicsTickComponent(float DeltaTime, float SimTime)
+{
+	Super::AsyncPhysicsTickComponent(DeltaTime, SimTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_ClimbAsync_Step);
+
+	FClimbAsyncInput Input;
+	if(!AsyncClimbInput.Peek(Input) || !Input.bClimbing) return;
+
+	// A new game thread snapshot reseeds the step, otherwise keep integrating from our own last result
+	if(Input.Frame != AsyncSimulatedInputFrame)
+	{
+		AsyncSimulatedInputFrame = Input.Frame;
+		AsyncSimulatedVelocity = Input.Velocity;
+		AsyncSimulatedRotation = Input.Rotation;
+		AsyncSimulatedSteps = 0;
+	}
+
+	FClimbAsyncOutput Output;
+	ClimbAsyncPhysics::SimulateClimbStep(Input, AsyncSimulatedVelocity, AsyncSimulatedRotation, DeltaTime, Output);
+	Output.SimTime = SimTime;
+	Output.StepsSinceInput = ++AsyncSimulatedSteps;
+
+	AsyncSimulatedVelocity = Output.Velocity;
+	AsyncSimulatedRotation = Output.Rotation;
+	AsyncClimbOutput.Publish(Output);
+}
+
 void UCustomMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
 {
+	FClimbFlightRecorder::Get().Record(EClimbFlightEventType::MovementModeChanged, GetOwner(), MovementMode, CustomMovementMode);
+	++TransitionCounters.MovementModeChanges;
+	if(PreviousMovementMode == MOVE_Falling)
+	{
+		FallEndQueryTraceCount = QueryTraceCount;
+	}
 
-	if(IsClimbing())
+	bool bCapsuleResized = false;
 	{
-		bOrientRotationToMovement = false;
-		CharacterOwner->GetCapsuleComponent()->SetCapsuleHalfHeight(48.f);
+		// Capsule resize and stand up rotation share one overlap refresh at the end of this scope
+		FScopedMovementUpdate ScopedCapsuleUpdate(UpdatedComponent, EScopedUpdate::DeferredUpdates);
+
+		// Moving between climbing and hanging keeps the climb capsule and stays registered
+		const bool bWasOnWall = PreviousMovementMode == MOVE_Custom &&
+			(PreviousCustomMode == ECustomMovementMode::Move_Climb || PreviousCustomMode == ECustomMovementMode::Move_Hang);
+		const bool bIsOnWall = IsClimbing() || IsHanging();
+
+		if(bIsOnWall && !bWasOnWall)
+		{
+			bOrientRotationToMovement = false;
+			bCapsuleResized |= SetClimbCapsuleHalfHeight(48.f);
+
+			if(ClimberSeparationSubsystem)
+			{
+				ClimberSeparationSubsystem->RegisterClimber(this);
+			}
+
+			OnEnterClimbStateDelegate.ExecuteIfBound();
+		}
 
-		OnEnterClimbStateDelegate.ExecuteIfBound();
+		if(bWasOnWall && !bIsOnWall)
+		{
+			bOrientRotationToMovement = true;
+			bCapsuleResized |= SetClimbCapsuleHalfHeight(96.f);
+
+			const FRotator DirtyRotation = UpdatedComponent->GetComponentRotation();
+			const FRotator CleanStandRotation = FRotator(0.f,DirtyRotation.Yaw,0.f);
+			UpdatedComponent->SetRelativeRotation(CleanStandRotation);
+			
+			StopMovementImmediately();
+			bIsCornerWrapping = false;
+
+			ClimbSeparationVelocity = FVector::ZeroVector;
+			if(ClimberSeparationSubsystem)
+			{
+				ClimberSeparationSubsystem->UnregisterClimber(this);
+			}
+			LastWallReleaseTime = GetWorld()->GetTimeSeconds();
+			FClimbInputLatency::Get().Abandon(MoveInputStamp);
+
+			OnExitClimbStateDelegate.ExecuteIfBound();
+			
+		}
+	}
+
+	if(bCapsuleResized)
+	{
+		++TransitionCounters.OverlapRefreshes;
 	}
 
-	if(PreviousMovementMode == MOVE_Custom && PreviousCustomMode == ECustomMovementMode::Move_Climb)
+	// The run faces along the predicted path rather than the input
+	if(IsWallRunning())
+	{
+		bOrientRotationToMovement = false;
+	}
+	else if(PreviousMovementMode == MOVE_Custom && PreviousCustomMode == ECustomMovementMode::Move_WallRun)
 	{
 		bOrientRotationToMovement = true;
-		CharacterOwner->GetCapsuleComponent()->SetCapsuleHalfHeight(96.f);
+		LastWallRunEndTime = GetWorld()->GetTimeSeconds();
+	}
 
-		const FRotator DirtyRotation = UpdatedComponent->GetComponentRotation();
-		const FRotator CleanStandRotation = FRotator(0.f,DirtyRotation.Yaw,0.f);
-		UpdatedComponent->SetRelativeRotation(CleanStandRotation);
-		
-		StopMovementImmediately();
+	// Stepping off a floor rather than jumping, a ledge catch looks back at the floor's edge
+	if(IsFalling() && PreviousMovementMode == MOVE_Walking && Velocity.Z <= 0.f)
+	{
+		WalkOffTime = GetWorld()->GetTimeSeconds();
+		WalkOffFacing = -Velocity.GetSafeNormal2D();
+	}
 
-		OnExitClimbStateDelegate.ExecuteIfBound();
-		
+	if(IsClimbing() && (TraversalState == ETraversalState::Entering || TraversalState == ETraversalState::Hanging))
+	{
+		TryEnterTraversalState(ETraversalState::Climbing);
+	}
+	else if(IsHanging() && (TraversalState == ETraversalState::Entering || TraversalState == ETraversalState::Climbing ||
+		TraversalState == ETraversalState::Idle || TraversalState == ETraversalState::Dropping))
+	{
+		TryEnterTraversalState(ETraversalState::Hanging);
 	}
+	else if(IsWallRunning())
+	{
+		TryEnterTraversalState(ETraversalState::WallRunning);
+	}
+	else if(IsFalling() && (TraversalState == ETraversalState::Climbing || TraversalState == ETraversalState::Hanging ||
+		TraversalState == ETraversalState::WallRunning))
+	{
+		TryEnterTraversalState(ETraversalState::Dropping);
+	}
+	else if(IsMovingOnGround() && TraversalState != ETraversalState::Idle)
+	{
+		TryEnterTraversalState(ETraversalState::Idle);
+	}
+
 	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
 }
 
@@ -68,13 +339,67 @@ void UCustomMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 	{
 		PhysClimb(deltaTime,Iterations);
 	}
+	else if(IsHanging())
+	{
+		PhysHang(deltaTime,Iterations);
+	}
+	else if(IsWallRunning())
+	{
+		PhysWallRun(deltaTime,Iterations);
+	}
+	else if(MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::Move_Traversal)
+	{
+		PhysTraversal(deltaTime,Iterations);
+	}
+}
+
+void UCustomMovementComponent::RequestDirectMove(const FVector& MoveVelocity, bool bForceMaxSpeed)
+{
+	if(OwningPlayerCharacter && !MoveVelocity.IsNearlyZero())
+	{
+		OwningPlayerCharacter->WakeClimbReplication();
+	}
+
+	Super::RequestDirectMove(MoveVelocity, bForceMaxSpeed);
+}
+
+void UCustomMovementComponent::RequestPathMove(const FVector& MoveInput)
+{
+	if(OwningPlayerCharacter && !MoveInput.IsNearlyZero())
+	{
+		OwningPlayerCharacter->WakeClimbReplication();
+	}
+
+	Super::RequestPathMove(MoveInput);
+}
+
+void UCustomMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
+{
+	if(ClimbInputStamp.IsAwaitingMotion() && ClimbInputStamp.Action == EClimbLatencyAction::ExitClimb)
+	{
+		ResolveClimbInputLatency();
+	}
+
+	if(TryCatchLedge(deltaTime))
+	{
+		// The rest of this move hangs on the provisional edge, the next move verifies it
+		TGuardValue<bool> DeferVerification(bDeferHangEdgeVerification, true);
+		StartNewPhysics(deltaTime, Iterations);
+		return;
+	}
+
+	Super::PhysFalling(deltaTime, Iterations);
 }
 
 float UCustomMovementComponent::GetMaxSpeed() const
 {
 	if(IsClimbing())
 	{
-		return MaxClimbSpeed;
+		return CurrentClimbGrip.MaxClimbSpeed;
+	}
+	else if(IsHanging())
+	{
+		return MaxHangShimmySpeed;
 	}
 	else
 	{
@@ -86,7 +411,7 @@ float UCustomMovementComponent::GetMaxSpeed() const
 
 float UCustomMovementComponent::GetMaxAcceleration() const
 {
-	if(IsClimbing())
+	if(IsClimbing() || IsHanging())
 	{
 		return MaxClimbAcceleration;
 	}
@@ -97,6 +422,28 @@ float UCustomMovementComponent::GetMaxAcceleration() const
 	}
 }
 
+bool UCustomMovementComponent::CanAttemptJump() const
+{
+	return Super::CanAttemptJump() || (IsWallRunning() && IsJumpAllowed());
+}
+
+bool UCustomMovementComponent::DoJump(bool bReplayingMoves)
+{
+	// Runs on the replicated jump input. The run itself started from the climb flag in the same move stream,
+	// so server and client are both wall running and wall jump on the same move
+	if(IsWallRunning())
+	{
+		const FVector JumpVelocity = WallRunPath.RunDirection * WallRunPath.RunSpeed +
+			WallRunPath.WallNormal * WallJumpOffWallSpeed + FVector::UpVector * WallJumpUpSpeed;
+
+		SetMovementMode(MOVE_Falling);
+		Velocity = JumpVelocity;
+		return true;
+	}
+
+	return Super::DoJump(bReplayingMoves);
+}
+
 FVector UCustomMovementComponent::ConstrainAnimRootMotionVelocity(const FVector& RootMotionVelocity,
 	const FVector& CurrentVelocity) const
 {
@@ -111,169 +458,485 @@ FVector UCustomMovementComponent::ConstrainAnimRootMotionVelocity(const FVector&
 	}
 }
 
-#pragma region ClimbTraces
+void UCustomMovementComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
 
-	TArray<FHitResult> UCustomMovementComponent::DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End,
-																			 bool bShowDebugShape, bool bDrawPersistantShapes)
-	{
-		TArray<FHitResult> OutCapsuleTraceHitResults;
-		EDrawDebugTrace::Type DebugTraceType = EDrawDebugTrace::None;
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(ClimbableSurfacesTracedResults.GetAllocatedSize());
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(TraversalOpportunityCache.GetAllocatedSize());
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(MotionWarpTargets.GetAllocatedSize());
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(ClimbMoveHistory.GetAllocatedSize());
+}
 
-		if(bShowDebugShape)
-		{
-			DebugTraceType = EDrawDebugTrace::ForOneFrame;
-			if(bDrawPersistantShapes)
-			{
-				DebugTraceType = EDrawDebugTrace::Persistent;
-			}
-		}
-		UKismetSystemLibrary::CapsuleTraceMultiForObjects(
-			this,
-			Start,
-			End,
-			ClimbCapsuleTraceRadius,
-			ClimbCapsuleTraceHalfHeight,
-			ClimbableSurfaceTraceTypes,
-			false,
-			TArray<AActor*>(),
-			DebugTraceType,
-			OutCapsuleTraceHitResults,
-			false
-		);
+void UCustomMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity)
+{
+	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
 
-		return OutCapsuleTraceHitResults;
-		
-	}
+	// Only moves a remote client drives get claims to check
+	if(!ClimbMoveValidator || CharacterOwner->GetRemoteRole() != ROLE_AutonomousProxy) return;
 
-	FHitResult UCustomMovementComponent::DoLineTraceSingleByObject(const FVector& Start, const FVector& End,
-		bool bShowDebugShape, bool bDrawPersistantShapes )
+	const bool bClimbing = IsClimbing() || IsHanging();
+	const bool bRootMotion = HasAnimRootMotion() || HasRootMotionSources();
+	const bool bHasSurface = IsHanging() || (bClimbing && !ClimbableSurfacesTracedResults.IsEmpty());
+
+	ClimbMoveHistory.Record(DeltaSeconds, UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentRotation().Yaw,
+		bClimbing, bRootMotion,
+		bHasSurface ? &CurrentClimbableSurfaceLocation : nullptr,
+		bHasSurface ? &CurrentClimbableSurfaceNormal : nullptr);
+}
+
+bool UCustomMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel,
+	const FVector& ClientLoc, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName,
+	uint8 ClientMovementMode)
+{
+	const bool bClientError = Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientLoc, RelativeClientLocation,
+		ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+
+	if(!ClimbMoveValidator || !ClimbMoveHistory.IsInitialized()) return bClientError;
+
+	TEnumAsByte<EMovementMode> ClientMode;
+	TEnumAsByte<EMovementMode> ClientGroundMode;
+	uint8 ClientCustomMode;
+	UnpackNetworkMovementMode(ClientMovementMode, ClientMode, ClientCustomMode, ClientGroundMode);
+
+	const bool bClaimsClimb = ClientMode == MOVE_Custom &&
+		(ClientCustomMode == ECustomMovementMode::Move_Climb || ClientCustomMode == ECustomMovementMode::Move_Hang);
+	if(bClaimsClimb)
 	{
-		FHitResult OutHit;
-		EDrawDebugTrace::Type DebugTraceType = EDrawDebugTrace::None;
+		// Queued against the sample just recorded for this same move, checked later within the validation budget
+		FClimbMoveClaim Claim;
+		Claim.Sequence = ClimbMoveHistory.GetLastSequence();
+		Claim.ClaimedLocation = ClientLoc;
+		Claim.bStartsClimb = !bLastClientMoveClaimedClimb;
+		ClimbMoveValidator->SubmitClaim(this, Claim);
+	}
+	bLastClientMoveClaimedClimb = bClaimsClimb;
 
-		if(bShowDebugShape)
-		{
-			DebugTraceType = EDrawDebugTrace::ForOneFrame;
-			if(bDrawPersistantShapes)
-			{
-				DebugTraceType = EDrawDebugTrace::Persistent;
-			}
-		}
-		UKismetSystemLibrary::LineTraceSingleForObjects(
-			this,
-			Start,
-			End,
-			ClimbableSurfaceTraceTypes,
-			false,
-			TArray<AActor*>(),
-			DebugTraceType,
-			OutHit,
-			false
-		);
-		return OutHit;
+	// Until its suspicion decays a flagged climber gets the server's position back for every climb move it sends
+	if(bClaimsClimb && ClimbMoveHistory.IsFlagged())
+	{
+		ClimbMoveHistory.NoteFlaggedClaim(IsClimbing() || IsHanging());
+		return true;
 	}
-#pragma endregion
 
-#pragma region ClimbCore
+	return bClientError;
+}
 
-bool UCustomMovementComponent::TraceClimbableSurfaces()
+bool UCustomMovementComponent::ServerShouldUseAuthoritativePosition(float ClientTimeStamp, float DeltaTime, const FVector& Accel,
+	const FVector& ClientLoc, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName,
+	uint8 ClientMovementMode)
 {
-	const FVector StartOffset = UpdatedComponent->GetForwardVector() * 30.f;
-	const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
-	const FVector End = Start + UpdatedComponent->GetForwardVector();
-	ClimbableSurfacesTracedResults = DoCapsuleTraceMultiByObject(Start,End,true);
+	// Only reached once ServerCheckClientError asked for a correction, a flagged climber never talks its way out of it
+	if(ClimbMoveHistory.IsFlagged())
+	{
+		ClimbMoveHistory.NoteForcedCorrection();
+		return false;
+	}
 
-	return !ClimbableSurfacesTracedResults.IsEmpty();
+	return Super::ServerShouldUseAuthoritativePosition(ClientTimeStamp, DeltaTime, Accel, ClientLoc, RelativeClientLocation,
+		ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
 }
 
-FHitResult UCustomMovementComponent::TraceFromEyeHeight(float TraceDistance, float TraceStartOffset)
+void UCustomMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
 {
-	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-	const FVector EyeHeightOffset = UpdatedComponent->GetUpVector() * (CharacterOwner->BaseEyeHeight + TraceStartOffset);
-	const FVector Start = ComponentLocation + EyeHeightOffset;
-	const FVector End = Start + UpdatedComponent->GetForwardVector() * TraceDistance;
+	Super::UpdateFromCompressedFlags(Flags);
 
-	return DoLineTraceSingleByObject(Start,End,true);
+	bWantsToStartClimb = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+	bWantsToStopClimb = (Flags & FSavedMove_Character::FLAG_Custom_1) != 0;
 }
 
-
-bool UCustomMovementComponent::CanStartClimbing()
+void UCustomMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
 {
-	if(IsFalling()) return false;
-	if(!TraceClimbableSurfaces()) return false;
-	if(!TraceFromEyeHeight(100.f).bBlockingHit) return false;
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
 
-	
+	// Replayed moves still carry their toggle, but the montage it started is already part of the state the server sent back
+	if(!CharacterOwner->bClientUpdating)
+	{
+		if(bWantsToStartClimb) ToggleClimbing(true);
+		else if(bWantsToStopClimb) ToggleClimbing(false);
+	}
 
-	return true;
+	bWantsToStartClimb = false;
+	bWantsToStopClimb = false;
 }
 
-bool UCustomMovementComponent::CanClimbDownLedge()
+void UCustomMovementComponent::RequestClimbToggle(bool bEnableClimb)
 {
-	if(IsFalling()) return false;
+	bWantsToStartClimb = bEnableClimb;
+	bWantsToStopClimb = !bEnableClimb;
+}
 
-	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
-	const FVector DownVector = -UpdatedComponent->GetUpVector();
+FNetworkPredictionData_Client* UCustomMovementComponent::GetPredictionData_Client() const
+{
+	if(!ClientPredictionData)
+	{
+		UCustomMovementComponent* MutableThis = const_cast<UCustomMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Climbing(*this);
+	}
 
-	const FVector WalkableSurfaceTraceStart =
-		ComponentLocation + ComponentForward * ClimbDownWalkableSurfaceTraceOffset;
-	const FVector  WalkableSurfaceTraceEnd =
-		WalkableSurfaceTraceStart + DownVector * 100.f;
+	return ClientPredictionData;
+}
 
-	FHitResult WalkableSurfaceHit = DoLineTraceSingleByObject(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd, false);
+void FSavedMove_Climbing::Clear()
+{
+	Super::Clear();
 
-	const FVector LedgeTraceStart = WalkableSurfaceHit.TraceStart + ComponentForward * ClimbDownLedgeTraceOffset;
-	const FVector LedgeTraceEnd = LedgeTraceStart + DownVector * 200.f;
+	bWantsToStartClimb = false;
+	bWantsToStopClimb = false;
+}
 
-	FHitResult LedgeTraceHit = DoLineTraceSingleByObject(LedgeTraceStart, LedgeTraceEnd, false);
+uint8 FSavedMove_Climbing::GetCompressedFlags() const
+{
+	uint8 Flags = Super::GetCompressedFlags();
+	if(bWantsToStartClimb) Flags |= FLAG_Custom_0;
+	if(bWantsToStopClimb) Flags |= FLAG_Custom_1;
+	return Flags;
+}
 
-	if(WalkableSurfaceHit.bBlockingHit && !LedgeTraceHit.bBlockingHit)
-		return true;
+bool FSavedMove_Climbing::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	// A combined move would send the toggle once for two moves, or lose it
+	const FSavedMove_Climbing* NewClimbMove = static_cast<const FSavedMove_Climbing*>(NewMove.Get());
+	if(bWantsToStartClimb || bWantsToStopClimb || NewClimbMove->bWantsToStartClimb || NewClimbMove->bWantsToStopClimb) return false;
 
-	return false;
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
 }
 
-void UCustomMovementComponent::StartClimbing()
+void FSavedMove_Climbing::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
 {
-	SetMovementMode(MOVE_Custom,ECustomMovementMode::Move_Climb);
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	// Captured before the move runs and consumes the request
+	if(const UCustomMovementComponent* MovementComponent = Cast<UCustomMovementComponent>(C->GetCharacterMovement()))
+	{
+		bWantsToStartClimb = MovementComponent->WantsToStartClimb();
+		bWantsToStopClimb = MovementComponent->WantsToStopClimb();
+	}
 }
 
-void UCustomMovementComponent::StopClimbing()
+FNetworkPredictionData_Client_Climbing::FNetworkPredictionData_Client_Climbing(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
 {
-	SetMovementMode(MOVE_Falling);
 }
 
-void UCustomMovementComponent::PhysClimb(float deltaTime, int32 Iterations)
+FSavedMovePtr FNetworkPredictionData_Client_Climbing::AllocateNewMove()
 {
-	if (deltaTime < MIN_TICK_TIME)
-	{
-		return;
-	}
+	return FSavedMovePtr(new FSavedMove_Climbing());
+}
 
-	//Process all the climbable surfaces info
-	TraceClimbableSurfaces();
-	ProcessClimbableSurfaceInfo();
-	
+FClimbMoveValidationParams UCustomMovementComponent::GetClimbMoveValidationParams() const
+{
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+
+	FClimbMoveValidationParams Params;
+	const float FastestClimbSpeed = ClimbGripTable ? FMath::Max(MaxClimbSpeed, ClimbGripTable->GetMaxClimbSpeed()) : MaxClimbSpeed;
+	// Remotely controlled climbers, the only ones validated, are never pushed by separation
+	Params.MaxClimbSpeed = FMath::Max(FastestClimbSpeed, MaxHangShimmySpeed);
+	Params.RootMotionSpeed = Settings->ClimbValidationRootMotionSpeed;
+	Params.SpeedSlack = Settings->ClimbValidationSpeedSlack;
+	Params.Tolerance = Settings->ClimbValidationTolerance;
+	Params.AnchorReach = Settings->ClimbValidationAnchorReach;
+	Params.AnchorWindow = Settings->ClimbValidationAnchorWindow;
+	Params.MaxTraversalDisplacement = Settings->ClimbValidationMaxTraversalDisplacement;
+	return Params;
+}
 
-	//check if we should start climbiung
-	if(CheckShouldStopClimbing() || CheckHasReachedFloor())
-	{
+#pragma region ClimbTraces
+
+	TArray<FHitResult> UCustomMovementComponent::DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End,
+																			 bool bShowDebugShape, bool bDrawPersistantShapes, bool bClimbSurface)
+	{
+		TArray<FHitResult> OutCapsuleTraceHitResults;
+		EDrawDebugTrace::Type DebugTraceType = EDrawDebugTrace::None;
+		++QueryTraceCount;
+
+		if(bShowDebugShape)
+		{
+			DebugTraceType = EDrawDebugTrace::ForOneFrame;
+			if(bDrawPersistantShapes)
+			{
+				DebugTraceType = EDrawDebugTrace::Persistent;
+			}
+		}
+
+		FClimbQueryHeatmap::FScope HeatmapScope(Start, true);
+		if(TraversalQueryCoalescer)
+		{
+			TraversalQueryCoalescer->CapsuleSweepMulti(this, OutCapsuleTraceHitResults, Start, End,
+				ClimbCapsuleTraceRadius, ClimbCapsuleTraceHalfHeight, bClimbSurface ? ClimbableSurfaceObjectQueryParams : WorldObjectQueryParams);
+		}
+		else
+		{
+			// Drawn below instead, so the heatmap times the query alone
+			UKismetSystemLibrary::CapsuleTraceMultiForObjects(
+				this,
+				Start,
+				End,
+				ClimbCapsuleTraceRadius,
+				ClimbCapsuleTraceHalfHeight,
+				bClimbSurface ? ClimbTraceObjectTypes : ClimbableSurfaceTraceTypes,
+				false,
+				TArray<AActor*>(),
+				EDrawDebugTrace::None,
+				OutCapsuleTraceHitResults,
+				false
+			);
+		}
+		HeatmapScope.Stop(OutCapsuleTraceHitResults.Num());
+
+#if ENABLE_DRAW_DEBUG
+		DrawDebugCapsuleTraceMulti(GetWorld(), Start, End, ClimbCapsuleTraceRadius, ClimbCapsuleTraceHalfHeight,
+			DebugTraceType, !OutCapsuleTraceHitResults.IsEmpty(), OutCapsuleTraceHitResults, FLinearColor::Red, FLinearColor::Green, 5.f);
+#endif
+		FClimbFlightRecorder::Get().Record(EClimbFlightEventType::Trace, GetOwner(), 0, OutCapsuleTraceHitResults.Num());
+		return OutCapsuleTraceHitResults;
+	}
+
+	FHitResult UCustomMovementComponent::DoLineTraceSingleByObject(const FVector& Start, const FVector& End,
+		bool bShowDebugShape, bool bDrawPersistantShapes )
+	{
+		FHitResult OutHit;
+		EDrawDebugTrace::Type DebugTraceType = EDrawDebugTrace::None;
+		++QueryTraceCount;
+
+		if(bShowDebugShape)
+		{
+			DebugTraceType = EDrawDebugTrace::ForOneFrame;
+			if(bDrawPersistantShapes)
+			{
+				DebugTraceType = EDrawDebugTrace::Persistent;
+			}
+		}
+
+		FClimbQueryHeatmap::FScope HeatmapScope(Start, false);
+		bool bHit;
+		if(TraversalQueryCoalescer)
+		{
+			bHit = TraversalQueryCoalescer->LineTraceSingle(this, OutHit, Start, End, WorldObjectQueryParams);
+		}
+		else
+		{
+			bHit = UKismetSystemLibrary::LineTraceSingleForObjects(
+				this,
+				Start,
+				End,
+				ClimbableSurfaceTraceTypes,
+				false,
+				TArray<AActor*>(),
+				EDrawDebugTrace::None,
+				OutHit,
+				false
+			);
+		}
+		HeatmapScope.Stop(bHit);
+
+#if ENABLE_DRAW_DEBUG
+		DrawDebugLineTraceSingle(GetWorld(), Start, End, DebugTraceType, bHit, OutHit, FLinearColor::Red, FLinearColor::Green, 5.f);
+#endif
+		FClimbFlightRecorder::Get().Record(EClimbFlightEventType::Trace, GetOwner(), 1, bHit);
+		return OutHit;
+	}
+#pragma endregion
+
+#pragma region ClimbQueryBudget
+
+bool UCustomMovementComponent::AcquireTraversalQuery(ETraversalProbe Probe, int32 TraceCost)
+{
+	FTraversalProbeCache& ProbeCache = TraversalProbeCaches[(uint8)Probe];
+
+	// Geometry that has not streamed in yet would read as nothing there. Probes of the current climb keep their last
+	// answer, probes that would start a traversal say no until the cells arrive
+	if(!bTraversalAreaStreamedIn)
+	{
+		INC_DWORD_STAT(STAT_ClimbStreaming_ProbesSuppressed);
+		if(Probe == ETraversalProbe::StartClimbing || Probe == ETraversalProbe::ClimbDownLedge || Probe == ETraversalProbe::StartVaulting ||
+			Probe == ETraversalProbe::LedgeCatch)
+		{
+			ProbeCache.bResult = false;
+		}
+		return false;
+	}
+
+	// Worlds without a governor (editor previews) run every probe
+	if(!TraversalQueryGovernor) return true;
+
+	// An answer probed from somewhere else says nothing about here, and vault results double as warp targets
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	const FVector Facing = UpdatedComponent->GetForwardVector();
+	if(ProbeCache.bHasResult && !ProbeCache.IsValidAt(Location, Facing))
+	{
+		ProbeCache.bHasResult = false;
+	}
+
+	const ETraversalQueryDecision Decision =
+		TraversalQueryGovernor->RequestQuery(GetTraversalQueryPriority(), TraceCost, ProbeCache);
+
+	if(Decision == ETraversalQueryDecision::Drop)
+	{
+		ProbeCache.bResult = false;
+	}
+	else if(Decision == ETraversalQueryDecision::Serve)
+	{
+		ProbeCache.StampPose(Location, Facing);
+	}
+
+	return Decision == ETraversalQueryDecision::Serve;
+}
+
+ETraversalQueryPriority UCustomMovementComponent::GetTraversalQueryPriority() const
+{
+	if(CharacterOwner->IsLocallyControlled()) return ETraversalQueryPriority::LocallyControlled;
+	if(CharacterOwner->WasRecentlyRendered(0.2f)) return ETraversalQueryPriority::OnScreen;
+
+	return ETraversalQueryPriority::OffScreen;
+}
+
+#pragma endregion
+
+#pragma region ClimbCore
+
+bool UCustomMovementComponent::TraceClimbableSurfaces()
+{
+	const FVector StartOffset = UpdatedComponent->GetForwardVector() * 30.f;
+	const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
+	const FVector End = Start + UpdatedComponent->GetForwardVector();
+	ClimbableSurfacesTracedResults = DoCapsuleTraceMultiByObject(Start,End,true,false,true);
+
+	return !ClimbableSurfacesTracedResults.IsEmpty();
+}
+
+FHitResult UCustomMovementComponent::TraceFromEyeHeight(float TraceDistance, float TraceStartOffset)
+{
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector EyeHeightOffset = UpdatedComponent->GetUpVector() * (CharacterOwner->BaseEyeHeight + TraceStartOffset);
+	const FVector Start = ComponentLocation + EyeHeightOffset;
+	const FVector End = Start + UpdatedComponent->GetForwardVector() * TraceDistance;
+
+	return DoLineTraceSingleByObject(Start,End,true);
+}
+
+
+bool UCustomMovementComponent::CanStartClimbing()
+{
+	if(IsFalling()) return false;
+
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
+
+	FVector UnusedStart, UnusedLand;
+	const ETraversalIndexResult IndexResult = QueryTraversalIndex(ETraversalOpportunity::Climb, ComponentLocation, ComponentForward, UnusedStart, UnusedLand);
+	if(IndexResult != ETraversalIndexResult::NotIndexed) return IndexResult == ETraversalIndexResult::Found;
+
+	FTraversalProbeCache& ProbeCache = TraversalProbeCaches[(uint8)ETraversalProbe::StartClimbing];
+	if(!AcquireTraversalQuery(ETraversalProbe::StartClimbing, GetTraversalOpportunityTraceCost(ETraversalOpportunity::Climb))) return ProbeCache.bResult;
+
+	// Same geometry as the Climb case of TraceTraversalOpportunity, but keeps the sweep hits for StartClimbing
+	if(!TraceClimbableSurfaces()) return ProbeCache.Store(false);
+	RemoveUngrippableHits(ClimbableSurfacesTracedResults);
+	if(ClimbableSurfacesTracedResults.IsEmpty()) return ProbeCache.Store(false);
+	if(!TraceFromEyeHeight(100.f).bBlockingHit) return ProbeCache.Store(false);
+
+	return ProbeCache.Store(true);
+}
+
+bool UCustomMovementComponent::CanClimbDownLedge()
+{
+	if(IsFalling()) return false;
+
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
+
+	FVector UnusedStart, UnusedLand;
+	const ETraversalIndexResult IndexResult = QueryTraversalIndex(ETraversalOpportunity::DropDown, ComponentLocation, ComponentForward, UnusedStart, UnusedLand);
+	if(IndexResult != ETraversalIndexResult::NotIndexed) return IndexResult == ETraversalIndexResult::Found;
+
+	FTraversalProbeCache& ProbeCache = TraversalProbeCaches[(uint8)ETraversalProbe::ClimbDownLedge];
+	if(!AcquireTraversalQuery(ETraversalProbe::ClimbDownLedge, GetTraversalOpportunityTraceCost(ETraversalOpportunity::DropDown))) return ProbeCache.bResult;
+
+	return ProbeCache.Store(TraceTraversalOpportunity(ETraversalOpportunity::DropDown, ComponentLocation, ComponentForward, UnusedStart, UnusedLand));
+}
+
+void UCustomMovementComponent::StartClimbing()
+{
+	if(IsClimbing())
+	{
+		++TransitionCounters.RedundantModeChangesSkipped;
+		return;
+	}
+
+	// Async physics results from an earlier climb must not move this one
+	AsyncClimbStartFrame = AsyncClimbInputFrame + 1;
+
+	SetMovementMode(MOVE_Custom,ECustomMovementMode::Move_Climb);
+}
+
+void UCustomMovementComponent::StopClimbing()
+{
+	if(IsFalling())
+	{
+		++TransitionCounters.RedundantModeChangesSkipped;
+		return;
+	}
+
+	SetMovementMode(MOVE_Falling);
+}
+
+void UCustomMovementComponent::PhysClimb(float deltaTime, int32 Iterations)
+{
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	FClimbFlightScopeTimer FlightTimer(EClimbFlightEventType::ClimbTick, GetOwner());
+	SCOPE_CYCLE_COUNTER(STAT_ClimbTick_Climb);
+	ClimbTickCost::FScope TickCost(ClimbTickCost::ClimbCost, QueryTraceCount);
+	const FVector PreviousVelocity = Velocity;
+
+	//Process all the climbable surfaces info, a deferred probe keeps holding the last traced surface
+	if(AcquireTraversalQuery(ETraversalProbe::ClimbableSurfaces, 1))
+	{
+		TraversalProbeCaches[(uint8)ETraversalProbe::ClimbableSurfaces].Store(TraceClimbableSurfaces());
+	}
+	ProcessClimbableSurfaceInfo();
+	UpdateCornerWrap(deltaTime);
+
+	// The wall ahead may not be loaded yet, stay put on the last traced surface rather than let go of it
+	if(!bTraversalAreaStreamedIn && !HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+	{
+		Velocity = FVector::ZeroVector;
+		return;
+	}
+	
+
+	//check if we should start climbiung
+	if(CheckShouldStopClimbing() || CheckHasReachedFloor())
+	{
 		StopClimbing();
 	}
 	RestorePreAdditiveRootMotionVelocity();
 
+	// Velocity, rotation and snap come from the physics thread, only the sweep itself stays here
+	const bool bHasRootMotion = HasAnimRootMotion() || CurrentRootMotion.HasOverrideVelocity();
+	if(bAsyncPhysicsClimbActive && !bHasRootMotion && ApplyAsyncClimbStep(deltaTime))
+	{
+		ResolveMoveInputLatency(PreviousVelocity);
+		TryClimbToTop();
+		return;
+	}
+
 	if( !HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() )
 	{
 		//define the max climb speed and acceleration
 		CalcVelocity(deltaTime, 0.f, true, MaxBreakClimbDeceleration);
+		ResolveMoveInputLatency(PreviousVelocity);
 	}
 
 	ApplyRootMotionToVelocity(deltaTime);
 	
 
 	FVector OldLocation = UpdatedComponent->GetComponentLocation();
-	const FVector Adjusted = Velocity * deltaTime;
+	const FVector Adjusted = (Velocity + ClimbSeparationVelocity) * deltaTime;
 	FHitResult Hit(1.f);
 
 	//handle climb rotation
@@ -281,6 +944,8 @@ void UCustomMovementComponent::PhysClimb(float deltaTime, int32 Iterations)
 
 	if (Hit.Time < 1.f)
 	{
+		INC_DWORD_STAT(STAT_ClimbSeparation_SweepImpacts);
+
 		//adjust and try again
 		HandleImpact(Hit, deltaTime, Adjusted);
 		SlideAlongSurface(Adjusted, (1.f - Hit.Time), Hit.Normal, Hit, true);
@@ -293,45 +958,717 @@ void UCustomMovementComponent::PhysClimb(float deltaTime, int32 Iterations)
 
 	//snap movement to climbable surfaces
 	SnapMovementToClimbableSurfaces(deltaTime);
-	if(CheckHasReachedLedge())
+
+	TryClimbToTop();
+}
+
+void UCustomMovementComponent::TryClimbToTop()
+{
+	// Once the top out has started there is no need to keep probing for the ledge
+	if(CanEnterTraversalState(ETraversalState::ToppingOut) && CheckHasReachedLedge())
 	{
-		PlayClimbMontage(ClimbToTopMontage);
+		if(PlayClimbMontage(ClimbToTopMontage))
+		{
+			TryEnterTraversalState(ETraversalState::ToppingOut);
+		}
+	}
+}
+
+#pragma region LedgeHang
+
+bool UCustomMovementComponent::TraceLedgeEdge(FClimbLedgeEdge& OutEdge)
+{
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
+
+	const FHitResult WallHit = DoLineTraceSingleByObject(ComponentLocation, ComponentLocation + ComponentForward * 100.f);
+	if(!WallHit.bBlockingHit) return false;
+
+	const FVector WallNormal = FVector(WallHit.ImpactNormal.X, WallHit.ImpactNormal.Y, 0.f).GetSafeNormal();
+	if(WallNormal.IsNearlyZero()) return false;
+
+	// Open above the ledge, then the walkable top whose edge the hands hold
+	const FHitResult LedgeHit = TraceFromEyeHeight(100.f, 50.f);
+	if(LedgeHit.bBlockingHit) return false;
+
+	const FVector TopTraceEnd = LedgeHit.TraceEnd - FVector::UpVector * (CharacterOwner->BaseEyeHeight + 50.f);
+	const FHitResult TopHit = DoLineTraceSingleByObject(LedgeHit.TraceEnd, TopTraceEnd);
+	if(!TopHit.bBlockingHit || !IsWalkable(TopHit)) return false;
+
+	OutEdge = FClimbLedgeEdge();
+	OutEdge.Origin = FVector(WallHit.ImpactPoint.X, WallHit.ImpactPoint.Y, TopHit.ImpactPoint.Z);
+	OutEdge.Direction = FVector::CrossProduct(FVector::UpVector, WallNormal);
+	OutEdge.WallNormal = WallNormal;
+	return true;
+}
+
+bool UCustomMovementComponent::StartHanging()
+{
+	if(IsHanging())
+	{
+		++TransitionCounters.RedundantModeChangesSkipped;
+		return true;
+	}
+
+	FClimbLedgeEdge Edge;
+	if(!TraceLedgeEdge(Edge)) return false;
+
+	// Hang where the climber already is relative to the edge
+	const FVector ToClimber = UpdatedComponent->GetComponentLocation() - Edge.Origin;
+	SetHangEdge(Edge);
+	HangWallOffset = FMath::Max(FVector::DotProduct(ToClimber, Edge.WallNormal), CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius());
+	HangDropBelowEdge = -ToClimber.Z;
+	bHangEdgeProvisional = false;
+
+	SetMovementMode(MOVE_Custom, ECustomMovementMode::Move_Hang);
+	return true;
+}
+
+void UCustomMovementComponent::SetHangEdge(const FClimbLedgeEdge& Edge)
+{
+	HangEdge = Edge;
+	HangEdgeDistance = FVector::DotProduct(UpdatedComponent->GetComponentLocation() - Edge.Origin, Edge.Direction);
+	HangEdge.VerifiedMin = HangEdgeDistance;
+	HangEdge.VerifiedMax = HangEdgeDistance;
+
+	CurrentClimbableSurfaceLocation = HangEdge.PointAt(HangEdgeDistance) - FVector::UpVector * HangEdgeProbeDepth;
+	CurrentClimbableSurfaceNormal = HangEdge.WallNormal;
+}
+
+void UCustomMovementComponent::PhysHang(float deltaTime, int32 Iterations)
+{
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	FClimbFlightScopeTimer FlightTimer(EClimbFlightEventType::ClimbTick, GetOwner());
+	SCOPE_CYCLE_COUNTER(STAT_ClimbTick_Hang);
+	ClimbTickCost::FScope TickCost(ClimbTickCost::HangCost, QueryTraceCount);
+	const FVector PreviousVelocity = Velocity;
+
+	// A caught ledge was only seen by the catch probe, find the real edge from the next move on before shimmying along it
+	if(bHangEdgeProvisional && !bDeferHangEdgeVerification && AcquireTraversalQuery(ETraversalProbe::HangEdge, 3))
+	{
+		bHangEdgeProvisional = false;
+
+		FClimbLedgeEdge Edge;
+		if(!TraceLedgeEdge(Edge))
+		{
+			StopClimbing();
+			return;
+		}
+		SetHangEdge(Edge);
+		SetMotionWarpTarget(FName("LedgeCatchPoint"), GetHangLocation());
+	}
+
+	RestorePreAdditiveRootMotionVelocity();
+
+	// Pulling up runs on root motion, which moves the climber off the edge
+	const bool bHasRootMotion = HasAnimRootMotion() || CurrentRootMotion.HasOverrideVelocity();
+	float TargetDistance = HangEdgeDistance;
+	if(!bHasRootMotion && !bHangEdgeProvisional)
+	{
+		if(TryLeaveHang()) return;
+
+		// Only input along the edge shimmies
+		Acceleration = HangEdge.Direction * FVector::DotProduct(Acceleration, HangEdge.Direction);
+		CalcVelocity(deltaTime, 0.f, true, MaxBreakClimbDeceleration);
+
+		const float EdgeSpeed = FVector::DotProduct(Velocity, HangEdge.Direction);
+		const float ShimmyDistance = HangEdgeDistance + EdgeSpeed * deltaTime;
+		const float LeadDistance = ShimmyDistance + FMath::Sign(EdgeSpeed) * HangHandReach;
+
+		const bool bLeadVerified = LeadDistance >= HangEdge.VerifiedMin && LeadDistance <= HangEdge.VerifiedMax;
+		if(bLeadVerified || ExtendHangEdge(LeadDistance))
+		{
+			Velocity = HangEdge.Direction * EdgeSpeed;
+			TargetDistance = ShimmyDistance;
+		}
+		else
+		{
+			Velocity = FVector::ZeroVector;
+		}
+		ResolveMoveInputLatency(PreviousVelocity);
+	}
+
+	ApplyRootMotionToVelocity(deltaTime);
+
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FQuat CurrentQuat = UpdatedComponent->GetComponentQuat();
+	const FVector Adjusted = bHasRootMotion ? Velocity * deltaTime : GetHangLocationAt(TargetDistance) - OldLocation;
+	const FQuat HangRotation = bHasRootMotion ? CurrentQuat : ClimbMath::ComputeClimbRotation(CurrentQuat, HangEdge.WallNormal, deltaTime, 5.f);
+	FHitResult Hit(1.f);
+
+	SafeMoveUpdatedComponent(Adjusted, HangRotation, true, Hit);
+
+	if (Hit.Time < 1.f)
+	{
+		HandleImpact(Hit, deltaTime, Adjusted);
+		SlideAlongSurface(Adjusted, (1.f - Hit.Time), Hit.Normal, Hit, true);
+	}
+
+	// Where the move actually got to along the edge, a blocked shimmy must not leave the hang point ahead of the climber
+	HangEdgeDistance = FVector::DotProduct(UpdatedComponent->GetComponentLocation() - HangEdge.Origin, HangEdge.Direction);
+
+	if( HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() )
+	{
+		Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / deltaTime;
+	}
+}
+
+bool UCustomMovementComponent::ExtendHangEdge(float LeadDistance)
+{
+	const bool bExtendsMax = LeadDistance > HangEdge.VerifiedMax;
+	if(bExtendsMax ? HangEdge.bMaxIsEnd : HangEdge.bMinIsEnd) return false;
+
+	// A deferred probe holds the climber at the verified stretch until the next tick
+	FTraversalProbeCache& ProbeCache = TraversalProbeCaches[(uint8)ETraversalProbe::HangEdge];
+	if(!AcquireTraversalQuery(ETraversalProbe::HangEdge, 1)) return false;
+
+	// Probing past the lead lets the following ticks shimmy without tracing. The end is placed at the last verified
+	// point, so a climber can stop up to HangEdgeProbeSpacing short of where the wall really ends
+	const float ProbeDistance = LeadDistance + (bExtendsMax ? HangEdgeProbeSpacing : -HangEdgeProbeSpacing);
+	const FVector ProbeStart = HangEdge.PointAt(ProbeDistance) + HangEdge.WallNormal * 30.f - FVector::UpVector * HangEdgeProbeDepth;
+	const FVector ProbeEnd = ProbeStart - HangEdge.WallNormal * 60.f;
+	const FHitResult WallHit = DoLineTraceSingleByObject(ProbeStart, ProbeEnd);
+
+	const float MinWallNormalDot = FMath::Cos(FMath::DegreesToRadians(CornerDetectionAngle));
+	const bool bWallContinues = WallHit.bBlockingHit && FVector::DotProduct(WallHit.ImpactNormal, HangEdge.WallNormal) > MinWallNormalDot;
+	ProbeCache.Store(bWallContinues);
+
+	if(!bWallContinues)
+	{
+		(bExtendsMax ? HangEdge.bMaxIsEnd : HangEdge.bMinIsEnd) = true;
+		return false;
+	}
+
+	(bExtendsMax ? HangEdge.VerifiedMax : HangEdge.VerifiedMin) = ProbeDistance;
+	CurrentClimbableSurfaceLocation = WallHit.ImpactPoint;
+	return true;
+}
+
+bool UCustomMovementComponent::TryLeaveHang()
+{
+	const float VerticalInput = Acceleration.GetSafeNormal().Z;
+
+	if(VerticalInput > 0.5f && CanEnterTraversalState(ETraversalState::ToppingOut))
+	{
+		if(PlayClimbMontage(ClimbToTopMontage))
+		{
+			TryEnterTraversalState(ETraversalState::ToppingOut);
+			return true;
+		}
+	}
+	else if(VerticalInput < -0.5f)
+	{
+		// Back onto the wall below, the climb sweep lets go if there is nothing there to hold
+		StartClimbing();
+		return true;
+	}
+
+	return false;
+}
+
+FVector UCustomMovementComponent::GetHangLocation() const
+{
+	return GetHangLocationAt(HangEdgeDistance);
+}
+
+FVector UCustomMovementComponent::GetHangLocationAt(float EdgeDistance) const
+{
+	return HangEdge.PointAt(EdgeDistance) + HangEdge.WallNormal * HangWallOffset - FVector::UpVector * HangDropBelowEdge;
+}
+
+#pragma endregion
+
+#pragma region LedgeCatch
+
+bool UCustomMovementComponent::TryCatchLedge(float DeltaTime)
+{
+	if(!bEnableLedgeCatch || !bEnableLedgeHang || Velocity.Z >= 0.f) return false;
+	if(HasAnimRootMotion() || CurrentRootMotion.HasOverrideVelocity()) return false;
+	if(!CanEnterTraversalState(ETraversalState::Hanging)) return false;
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if(Now - LastWallReleaseTime < LedgeCatchReentryDelay) return false;
+
+	FVector Facing = UpdatedComponent->GetForwardVector().GetSafeNormal2D();
+	if(Now - WalkOffTime <= LedgeCatchWalkOffWindow)
+	{
+		Facing = WalkOffFacing;
+	}
+	if(Facing.IsNearlyZero()) return false;
+
+	// The hands' path over this move, gravity included
+	const FVector HandStart = UpdatedComponent->GetComponentLocation() + FVector::UpVector * LedgeCatchHandHeight + Facing * LedgeCatchReach;
+	const FVector HandEnd = HandStart + Velocity * DeltaTime + FVector::UpVector * (0.5f * GetGravityZ() * DeltaTime * DeltaTime);
+
+	FClimbLedgeEdge Edge;
+	Edge.WallNormal = -Facing;
+
+	FVector IndexEdgeLocation, IndexWallNormal;
+	const ETraversalIndexResult IndexResult = TraversalIndex ?
+		TraversalIndex->FindCatchLedge(HandStart, HandEnd, Facing, IndexEdgeLocation, IndexWallNormal) : ETraversalIndexResult::NotIndexed;
+	// Resident cells were baked without movable geometry, so a miss there is as good as the trace's
+	if(IndexResult == ETraversalIndexResult::NotFound) return false;
+
+	if(IndexResult == ETraversalIndexResult::Found)
+	{
+		Edge.Origin = IndexEdgeLocation;
+		Edge.WallNormal = IndexWallNormal;
+	}
+	else
+	{
+		if(!AcquireTraversalQuery(ETraversalProbe::LedgeCatch, 1)) return false;
+		INC_DWORD_STAT(STAT_LedgeCatch_Probes);
+
+		// A walkable top under the hands, reached this move from above
+		const FHitResult TopHit = DoLineTraceSingleByObject(HandStart, HandEnd);
+		if(!TopHit.bBlockingHit || TopHit.bStartPenetrating || !IsWalkable(TopHit)) return TraversalProbeCaches[(uint8)ETraversalProbe::LedgeCatch].Store(false);
+
+		TraversalProbeCaches[(uint8)ETraversalProbe::LedgeCatch].Store(true);
+		Edge.Origin = TopHit.ImpactPoint;
+	}
+	Edge.Direction = FVector::CrossProduct(FVector::UpVector, Edge.WallNormal);
+
+	// Face the wall so the edge trace of the first hang tick looks at it
+	FHitResult RotateHit;
+	SafeMoveUpdatedComponent(FVector::ZeroVector, (-Edge.WallNormal).ToOrientationQuat(), false, RotateHit);
+
+	SetHangEdge(Edge);
+	HangWallOffset = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	HangDropBelowEdge = LedgeCatchHandHeight;
+	bHangEdgeProvisional = true;
+	Velocity = FVector::ZeroVector;
+
+	INC_DWORD_STAT(STAT_LedgeCatch_Catches);
+	SetMovementMode(MOVE_Custom, ECustomMovementMode::Move_Hang);
+
+	SetMotionWarpTarget(FName("LedgeCatchPoint"), GetHangLocation());
+	PlayClimbMontage(LedgeCatchMontage);
+	return true;
+}
+
+#pragma endregion
+
+#pragma region WallRun
+
+bool UCustomMovementComponent::TryStartWallRun()
+{
+	if(!IsFalling() || HasAnimRootMotion() || !CanEnterTraversalState(ETraversalState::WallRunning)) return false;
+	if(LastWallRunEndTime >= 0.0 && GetWorld()->GetTimeSeconds() - LastWallRunEndTime < WallRunReentryDelay) return false;
+	if(Velocity.Size2D() < MinWallRunSpeed) return false;
+
+	// Wall detection on each side and the path probes
+	FTraversalProbeCache& ProbeCache = TraversalProbeCaches[(uint8)ETraversalProbe::WallRun];
+	if(!AcquireTraversalQuery(ETraversalProbe::WallRun, 2 + GetWallRunPlanTraceCost(MaxWallRunDuration, Velocity.Size2D()))) return false;
+
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector SideOffset = UpdatedComponent->GetRightVector() * WallRunDetectionDistance;
+
+	FHitResult WallHit = DoLineTraceSingleByObject(ComponentLocation, ComponentLocation + SideOffset);
+	if(!WallHit.bBlockingHit)
+	{
+		WallHit = DoLineTraceSingleByObject(ComponentLocation, ComponentLocation - SideOffset);
+	}
+	if(!WallHit.bBlockingHit) return ProbeCache.Store(false);
+
+	const FVector EntryVelocity(Velocity.X, Velocity.Y, FMath::Max<float>(Velocity.Z, WallRunEntryVerticalSpeed));
+	FWallRunPath Path;
+	if(!PlanWallRun(WallHit, EntryVelocity, MaxWallRunDuration, Path)) return ProbeCache.Store(false);
+
+	WallRunPath = Path;
+	WallRunTime = 0.f;
+	WallRunElapsedTime = 0.f;
+	SetMovementMode(MOVE_Custom, ECustomMovementMode::Move_WallRun);
+	return ProbeCache.Store(true);
+}
+
+bool UCustomMovementComponent::PlanWallRun(const FHitResult& WallHit, const FVector& InVelocity, float MaxDuration, FWallRunPath& OutPath)
+{
+	// Only near vertical walls are run
+	if(FMath::Abs(WallHit.ImpactNormal.Z) > 0.3f) return false;
+
+	const FVector WallNormal = FVector(WallHit.ImpactNormal.X, WallHit.ImpactNormal.Y, 0.f).GetSafeNormal();
+	const FVector HorizontalVelocity(InVelocity.X, InVelocity.Y, 0.f);
+	const FVector AlongWall = HorizontalVelocity - WallNormal * FVector::DotProduct(HorizontalVelocity, WallNormal);
+	const float RunSpeed = AlongWall.Size();
+	if(WallNormal.IsNearlyZero() || RunSpeed < MinWallRunSpeed) return false;
+
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const float WallDistance = FVector::DotProduct(ComponentLocation - WallHit.ImpactPoint, WallNormal);
+	const float WallOffset = FMath::Max(WallDistance, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius());
+
+	OutPath = FWallRunPath();
+	OutPath.Start = ComponentLocation + WallNormal * (WallOffset - WallDistance);
+	OutPath.RunDirection = AlongWall / RunSpeed;
+	OutPath.WallNormal = WallNormal;
+	OutPath.RunSpeed = RunSpeed;
+	OutPath.StartVerticalSpeed = InVelocity.Z;
+	OutPath.GravityZ = GetGravityZ() * WallRunGravityScale;
+
+	// Out of run once falling faster than WallRunMaxFallSpeed
+	const float FallLimitTime = OutPath.GravityZ < 0.f ? (InVelocity.Z + WallRunMaxFallSpeed) / -OutPath.GravityZ : MaxDuration;
+	OutPath.EndTime = FMath::Clamp(FallLimitTime, 0.f, MaxDuration);
+	if(OutPath.EndTime < MinWallRunDuration) return false;
+
+	// Walked forward along the path with short probes into the wall, a capsule width apart. The run ends at the first
+	// probe that finds no wall, later stretches of wall past a gap are left to the re-probe at the predicted end
+	const FVector IntoWall = -WallNormal * (WallOffset + WallRunProbeDepth);
+	const float StepTime = 2.f * CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius() / RunSpeed;
+	float LastWallTime = 0.f;
+	while(LastWallTime < OutPath.EndTime)
+	{
+		const float ProbeTime = FMath::Min(LastWallTime + StepTime, OutPath.EndTime);
+		const FVector ProbeLocation = OutPath.PositionAt(ProbeTime);
+		INC_DWORD_STAT(STAT_WallRun_Probes);
+		if(DoLineTraceSingleByObject(ProbeLocation, ProbeLocation + IntoWall).bBlockingHit)
+		{
+			LastWallTime = ProbeTime;
+			continue;
+		}
+
+		// Swept back just behind the wall face from the gap it starts in the open and hits the end face of the wall
+		const FHitResult WallEndHit = DoLineTraceSingleByObject(ProbeLocation + IntoWall, OutPath.PositionAt(LastWallTime) + IntoWall);
+		INC_DWORD_STAT(STAT_WallRun_Probes);
+
+		OutPath.EndTime = LastWallTime;
+		if(WallEndHit.bBlockingHit && !WallEndHit.bStartPenetrating)
+		{
+			const float WallEndTime = FVector::DotProduct(WallEndHit.ImpactPoint - OutPath.Start, OutPath.RunDirection) / RunSpeed;
+			OutPath.EndTime = FMath::Clamp(WallEndTime, LastWallTime, ProbeTime);
+		}
+		OutPath.bEndsAtDiscontinuity = true;
+		break;
+	}
+
+	return OutPath.EndTime >= MinWallRunDuration;
+}
+
+int32 UCustomMovementComponent::GetWallRunPlanTraceCost(float MaxDuration, float HorizontalSpeed) const
+{
+	// The run speed along the wall is at most the horizontal speed, so this many steps cover the longest path,
+	// plus the trace back to the end face of the wall
+	const float StepDistance = 2.f * CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	return FMath::CeilToInt(MaxDuration * HorizontalSpeed / FMath::Max(StepDistance, 1.f)) + 1;
+}
+
+void UCustomMovementComponent::PhysWallRun(float deltaTime, int32 Iterations)
+{
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_WallRun_Tick);
+	ClimbTickCost::FScope TickCost(ClimbTickCost::WallRunCost, QueryTraceCount);
+
+	if(ClimbInputStamp.IsAwaitingMotion() && ClimbInputStamp.Action == EClimbLatencyAction::WallRun)
+	{
+		ResolveClimbInputLatency();
+	}
+
+	RestorePreAdditiveRootMotionVelocity();
+
+	// The path was checked on entry, the move sweep is all the collision a tick needs
+	WallRunTime = FMath::Min(WallRunTime + deltaTime, WallRunPath.EndTime);
+
+	const FVector Adjusted = WallRunPath.PositionAt(WallRunTime) - UpdatedComponent->GetComponentLocation();
+	const FQuat RunQuat = FRotationMatrix::MakeFromX(WallRunPath.RunDirection).ToQuat();
+	FHitResult Hit(1.f);
+
+	SafeMoveUpdatedComponent(Adjusted, FMath::QInterpTo(UpdatedComponent->GetComponentQuat(), RunQuat, deltaTime, 10.f), true, Hit);
+	Velocity = WallRunPath.VelocityAt(WallRunTime);
+
+	// Something the prediction did not see, or the floor
+	if (Hit.Time < 1.f)
+	{
+		HandleImpact(Hit, deltaTime, Adjusted);
+		StopWallRun();
+		return;
+	}
+
+	if(WallRunTime >= WallRunPath.EndTime && !(WallRunPath.bEndsAtDiscontinuity && ReprobeWallRun()))
+	{
+		StopWallRun();
+	}
+}
+
+bool UCustomMovementComponent::ReprobeWallRun()
+{
+	const float RemainingTime = MaxWallRunDuration - (WallRunElapsedTime + WallRunTime);
+	if(RemainingTime < MinWallRunDuration) return false;
+	if(!AcquireTraversalQuery(ETraversalProbe::WallRun, 1 + GetWallRunPlanTraceCost(RemainingTime, Velocity.Size2D()))) return false;
+
+	// Just past the end of the wall, toward where the next one would carry on the run
+	const FVector ProbeStart = UpdatedComponent->GetComponentLocation() + WallRunPath.RunDirection * CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	const FVector ProbeEnd = ProbeStart - WallRunPath.WallNormal * WallRunDetectionDistance;
+	const FHitResult WallHit = DoLineTraceSingleByObject(ProbeStart, ProbeEnd);
+	INC_DWORD_STAT(STAT_WallRun_Probes);
+	if(!WallHit.bBlockingHit) return false;
+
+	FWallRunPath NextPath;
+	if(!PlanWallRun(WallHit, Velocity, RemainingTime, NextPath)) return false;
+
+	WallRunElapsedTime += WallRunTime;
+	WallRunTime = 0.f;
+	WallRunPath = NextPath;
+	return true;
+}
+
+void UCustomMovementComponent::StopWallRun()
+{
+	SetMovementMode(MOVE_Falling);
+}
+
+#pragma endregion
+
+FClimbAsyncInput UCustomMovementComponent::MakeClimbAsyncInput() const
+{
+	FClimbAsyncInput Input;
+	Input.Frame = AsyncClimbInputFrame;
+	Input.bClimbing = IsClimbing();
+	Input.Location = UpdatedComponent->GetComponentLocation();
+	Input.Rotation = UpdatedComponent->GetComponentQuat();
+	Input.Velocity = Velocity;
+	Input.Acceleration = Acceleration;
+	Input.SurfaceLocation = CurrentClimbableSurfaceLocation;
+	Input.SurfaceNormal = CurrentClimbableSurfaceNormal;
+	Input.MaxSpeed = GetMaxSpeed();
+	Input.MaxInputSpeed = FMath::Max(Input.MaxSpeed * AnalogInputModifier, GetMinAnalogSpeed());
+	Input.BrakingDeceleration = MaxBreakClimbDeceleration;
+	return Input;
+}
+
+bool UCustomMovementComponent::ApplyAsyncClimbStep(float deltaTime)
+{
+	++AsyncClimbInputFrame;
+	const FClimbAsyncInput Input = MakeClimbAsyncInput();
+	AsyncClimbInput.Publish(Input);
+
+	if(ClimbAsyncPhysicsCVars::bParityCheck)
+	{
+		RecordAsyncClimbParityReference(Input);
+	}
+
+	// Each physics result moves the climber once, a frame without a fresh one runs the game thread step instead
+	FClimbAsyncOutput Output;
+	if(!AsyncClimbOutput.Consume(Output) || Output.InputFrame < AsyncClimbStartFrame) return false;
+
+	if(ClimbAsyncPhysicsCVars::bParityCheck)
+	{
+		CheckAsyncClimbParity(Output);
+	}
+
+	Velocity = Output.Velocity;
+
+	const FVector Adjusted = (Velocity + ClimbSeparationVelocity) * deltaTime;
+	FHitResult Hit(1.f);
+	SafeMoveUpdatedComponent(Adjusted, Output.Rotation, true, Hit);
+
+	if (Hit.Time < 1.f)
+	{
+		INC_DWORD_STAT(STAT_ClimbSeparation_SweepImpacts);
+
+		HandleImpact(Hit, deltaTime, Adjusted);
+		SlideAlongSurface(Adjusted, (1.f - Hit.Time), Hit.Normal, Hit, true);
+	}
+
+	UpdatedComponent->MoveComponent(Output.SnapVelocity * deltaTime, UpdatedComponent->GetComponentQuat(), true);
+	return true;
+}
+
+void UCustomMovementComponent::RecordAsyncClimbParityReference(const FClimbAsyncInput& Input)
+{
+	// The game thread climb step on the same input, over the step the physics thread integrates with
+	const float StepTime = UPhysicsSettings::Get()->AsyncFixedTimeStepSize;
+	const FVector FrameVelocity = Velocity;
+
+	FClimbAsyncOutput& Reference = AsyncClimbParityReferences[Input.Frame % NumAsyncClimbParityReferences];
+	CalcVelocity(StepTime, 0.f, true, MaxBreakClimbDeceleration);
+	Reference.InputFrame = Input.Frame;
+	Reference.Velocity = Velocity;
+	Reference.Rotation = GetClimbRotation(StepTime);
+
+	Velocity = FrameVelocity;
+}
+
+void UCustomMovementComponent::CheckAsyncClimbParity(const FClimbAsyncOutput& Output)
+{
+	// Only the first step off a snapshot is comparable, later ones integrate from the physics thread's own result
+	const FClimbAsyncOutput& Reference = AsyncClimbParityReferences[Output.InputFrame % NumAsyncClimbParityReferences];
+	if(Output.StepsSinceInput != 1 || Reference.InputFrame != Output.InputFrame) return;
+
+	const float VelocityError = FVector::Dist(Output.Velocity, Reference.Velocity);
+	const float RotationError = FMath::RadiansToDegrees(Output.Rotation.AngularDistance(Reference.Rotation));
+	const float ParityError = FMath::Max(VelocityError, RotationError);
+	MaxAsyncClimbParityError = FMath::Max(MaxAsyncClimbParityError, ParityError);
+
+	if(ParityError > UClimbingSettings::Get()->AsyncClimbParityTolerance)
+	{
+		UE_LOG(LogClimbing, Warning, TEXT("%s async climb step diverged: velocity %.3f cm/s, rotation %.3f deg"),
+			*GetNameSafe(GetOwner()), VelocityError, RotationError);
 	}
-	
 }
 
 void UCustomMovementComponent::ProcessClimbableSurfaceInfo()
 {
-	CurrentClimbableSurfaceLocation = FVector::ZeroVector;
-	CurrentClimbableSurfaceNormal = FVector::ZeroVector;
+	RemoveUngrippableHits(ClimbableSurfacesTracedResults);
+	ClimbMath::AverageSurfaceHits(ClimbableSurfacesTracedResults, CurrentClimbableSurfaceLocation, CurrentClimbableSurfaceNormal);
 
 	if(ClimbableSurfacesTracedResults.IsEmpty()) return;
 
-	for(const FHitResult& TracedHitResult:ClimbableSurfacesTracedResults)
+	// The sweep hits come nearest first, the hands are on the first one
+	CurrentClimbGrip = ResolveClimbGrip(ClimbableSurfacesTracedResults[0]);
+
+	DetectClimbCorner();
+}
+
+const FClimbGrip& UCustomMovementComponent::ResolveClimbGrip(const FHitResult& Hit) const
+{
+	if(!ClimbGripTable) return FallbackClimbGrip;
+
+	// Sweeps that skip material lookups still know the body they hit
+	const UPhysicalMaterial* PhysicalMaterial = Hit.PhysMaterial.Get();
+	if(!PhysicalMaterial)
 	{
-		CurrentClimbableSurfaceLocation += TracedHitResult.ImpactPoint;
-		CurrentClimbableSurfaceNormal += TracedHitResult.ImpactNormal;
+		const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+		const FBodyInstance* HitBody = HitComponent ? HitComponent->GetBodyInstance(Hit.BoneName) : nullptr;
+		PhysicalMaterial = HitBody ? HitBody->GetSimplePhysicalMaterial() : nullptr;
+	}
+
+	return ClimbGripTable->FindGrip(PhysicalMaterial);
+}
+
+void UCustomMovementComponent::RemoveUngrippableHits(TArray<FHitResult>& Hits) const
+{
+	if(!ClimbGripTable) return;
+
+	Hits.RemoveAll([this](const FHitResult& Hit)
+	{
+		return !ResolveClimbGrip(Hit).bClimbable;
+	});
+}
+
+void UCustomMovementComponent::DetectClimbCorner()
+{
+	bIsAtClimbCorner = false;
+	ClimbSurfaceCurvature = 0.f;
+
+	if(ClimbableSurfacesTracedResults.Num() < 2) return;
+
+	// Corners turn around the vertical. Ledge tops and overhang undersides would read as one against any wall
+	static constexpr float MaxCornerFaceNormalZ = 0.7f;
+
+	TArray<FVector, TInlineAllocator<8>> PlanarNormals;
+	PlanarNormals.Reserve(ClimbableSurfacesTracedResults.Num());
+	for(const FHitResult& Hit : ClimbableSurfacesTracedResults)
+	{
+		PlanarNormals.Add(FMath::Abs(Hit.ImpactNormal.Z) > MaxCornerFaceNormalZ ? FVector::ZeroVector : Hit.ImpactNormal.GetSafeNormal2D());
+	}
+
+	// The two most divergent wall hits of the sweep are the faces either side of the corner
+	int32 FaceIndexA = INDEX_NONE;
+	int32 FaceIndexB = INDEX_NONE;
+	float MinNormalDot = FMath::Cos(FMath::DegreesToRadians(CornerDetectionAngle));
+
+	for(int32 i = 0; i < ClimbableSurfacesTracedResults.Num(); ++i)
+	{
+		if(PlanarNormals[i].IsZero()) continue;
+
+		for(int32 j = i + 1; j < ClimbableSurfacesTracedResults.Num(); ++j)
+		{
+			if(PlanarNormals[j].IsZero()) continue;
+
+			const float NormalDot = FVector::DotProduct(PlanarNormals[i], PlanarNormals[j]);
+
+			if(NormalDot < MinNormalDot)
+			{
+				MinNormalDot = NormalDot;
+				FaceIndexA = i;
+				FaceIndexB = j;
+			}
+		}
+	}
+
+	if(FaceIndexA == INDEX_NONE) return;
+
+	// Face A is the one the character is facing, face B the one it could wrap onto
+	const FVector FacingNormal = -UpdatedComponent->GetForwardVector();
+	if(FVector::DotProduct(PlanarNormals[FaceIndexB], FacingNormal) > FVector::DotProduct(PlanarNormals[FaceIndexA], FacingNormal))
+	{
+		Swap(FaceIndexA, FaceIndexB);
+	}
+
+	const FHitResult& CurrentFace = ClimbableSurfacesTracedResults[FaceIndexA];
+	const FHitResult& NextFace = ClimbableSurfacesTracedResults[FaceIndexB];
+
+	bIsAtClimbCorner = true;
+	bIsOutsideCorner = FVector::DotProduct(NextFace.ImpactPoint - CurrentFace.ImpactPoint, PlanarNormals[FaceIndexA]) < 0.f;
+	ClimbSurfaceCurvature = FMath::Acos(MinNormalDot) / FMath::Max(FVector::Dist(CurrentFace.ImpactPoint, NextFace.ImpactPoint), 1.f);
+
+	CornerNextFaceLocation = NextFace.ImpactPoint;
+	CornerNextFaceNormal = NextFace.ImpactNormal;
+
+	// Hold on to our own face instead of the diagonal average until a wrap starts
+	CurrentClimbableSurfaceLocation = CurrentFace.ImpactPoint;
+	CurrentClimbableSurfaceNormal = CurrentFace.ImpactNormal;
+}
+
+void UCustomMovementComponent::UpdateCornerWrap(float DeltaTime)
+{
+	if(!bIsCornerWrapping)
+	{
+		if(!bIsAtClimbCorner) return;
+
+		const FVector LateralVelocity = FVector::VectorPlaneProject(Velocity, CurrentClimbableSurfaceNormal);
+		const FVector ToNextFace = CornerNextFaceLocation - UpdatedComponent->GetComponentLocation();
+
+		if(LateralVelocity.SizeSquared() < FMath::Square(10.f)) return;
+		if(FVector::DotProduct(LateralVelocity, ToNextFace) <= 0.f) return;
+
+		bIsCornerWrapping = true;
+		CornerWrapAlpha = 0.f;
+		CornerWrapFromLocation = CurrentClimbableSurfaceLocation;
+		CornerWrapFromNormal = CurrentClimbableSurfaceNormal;
+		CornerWrapToLocation = CornerNextFaceLocation;
+		CornerWrapToNormal = CornerNextFaceNormal;
+	}
+	else if(bIsAtClimbCorner)
+	{
+		// Keep the target face fresh from this tick's sweep, no extra probe needed
+		CornerWrapToLocation = CornerNextFaceLocation;
+		CornerWrapToNormal = CornerNextFaceNormal;
+	}
+
+	// Moving back along the edge unwinds the wrap
+	const FVector WrapDirection = (CornerWrapToLocation - CornerWrapFromLocation).GetSafeNormal();
+	const float WrapSpeed = FVector::DotProduct(Velocity, WrapDirection);
+	CornerWrapAlpha = FMath::Clamp(CornerWrapAlpha + WrapSpeed * DeltaTime / CornerWrapDistance, 0.f, 1.f);
+
+	const float BlendAlpha = FMath::InterpEaseInOut(0.f, 1.f, CornerWrapAlpha, 2.f);
+	CurrentClimbableSurfaceLocation = FMath::Lerp(CornerWrapFromLocation, CornerWrapToLocation, BlendAlpha);
+	CurrentClimbableSurfaceNormal = FMath::Lerp(CornerWrapFromNormal, CornerWrapToNormal, BlendAlpha).GetSafeNormal();
+
+	if(CornerWrapAlpha >= 1.f || CornerWrapAlpha <= 0.f)
+	{
+		bIsCornerWrapping = false;
 	}
-	
-	CurrentClimbableSurfaceLocation /= ClimbableSurfacesTracedResults.Num();
-	CurrentClimbableSurfaceNormal = CurrentClimbableSurfaceNormal.GetSafeNormal();
-	
 }
 
 bool UCustomMovementComponent::CheckShouldStopClimbing()
 {
 	if(ClimbableSurfacesTracedResults.IsEmpty()) return true;
 
-	const float DotResult = FVector::DotProduct(CurrentClimbableSurfaceNormal, FVector::UpVector);
-	const float DegreeDiff = FMath::RadiansToDegrees(FMath::Acos(DotResult));
-
-	if(DegreeDiff <= 60.f)	return true;
-	
-	return false;
+	return CurrentClimbGrip.IsOutsideSlopeLimits(CurrentClimbableSurfaceNormal);
 }
 
 bool UCustomMovementComponent::CheckHasReachedFloor()
 {
+	FTraversalProbeCache& ProbeCache = TraversalProbeCaches[(uint8)ETraversalProbe::ReachedFloor];
+	if(!AcquireTraversalQuery(ETraversalProbe::ReachedFloor, 1)) return ProbeCache.bResult;
+
 	const FVector DownVector = -UpdatedComponent->GetUpVector();
 	const FVector StartOffset = DownVector * 50.f;
 
@@ -340,7 +1677,7 @@ bool UCustomMovementComponent::CheckHasReachedFloor()
 
 	TArray<FHitResult> PossibleFloorHits = DoCapsuleTraceMultiByObject(Start, End, false);
 
-	if(PossibleFloorHits.IsEmpty()) return false;
+	if(PossibleFloorHits.IsEmpty()) return ProbeCache.Store(false);
 
 	for(const FHitResult& PossibleFloorHit : PossibleFloorHits)
 	{
@@ -349,10 +1686,10 @@ bool UCustomMovementComponent::CheckHasReachedFloor()
 			GetUnrotatedClimbVelocity().Z < -10.f;
 
 		if(bFloorReached)
-			return true;
+			return ProbeCache.Store(true);
 	}
 
-	return false;
+	return ProbeCache.Store(false);
 }
 
 FQuat UCustomMovementComponent::GetClimbRotation(float DeltaTime)
@@ -364,26 +1701,25 @@ FQuat UCustomMovementComponent::GetClimbRotation(float DeltaTime)
 		return CurrentQuat;
 	}
 
-	const FQuat TargetQuat = FRotationMatrix::MakeFromX(-CurrentClimbableSurfaceNormal).ToQuat();
-	return FMath::QInterpTo(CurrentQuat, TargetQuat, DeltaTime, 5.f);
-	
+	return ClimbMath::ComputeClimbRotation(CurrentQuat, CurrentClimbableSurfaceNormal, DeltaTime, 5.f);
 }
 
 void UCustomMovementComponent::SnapMovementToClimbableSurfaces(float deltaTime)
 {
-	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
-	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-
-	const FVector ProjectedCharacterToSurface =
-		(CurrentClimbableSurfaceLocation-ComponentLocation).ProjectOnTo(ComponentForward);
-
-	const FVector SnapVector = -CurrentClimbableSurfaceNormal * ProjectedCharacterToSurface.Length();
+	const FVector SnapVector = ClimbMath::ComputeSnapVector(
+		UpdatedComponent->GetComponentLocation(),
+		UpdatedComponent->GetForwardVector(),
+		CurrentClimbableSurfaceLocation,
+		CurrentClimbableSurfaceNormal);
 
 	UpdatedComponent->MoveComponent(SnapVector*deltaTime*MaxClimbSpeed,UpdatedComponent->GetComponentQuat(),true);
 }
 
 bool UCustomMovementComponent::CheckHasReachedLedge()
 {
+	FTraversalProbeCache& ProbeCache = TraversalProbeCaches[(uint8)ETraversalProbe::ReachedLedge];
+	if(!AcquireTraversalQuery(ETraversalProbe::ReachedLedge, 2)) return ProbeCache.bResult;
+
 	FHitResult LedgeHitResult = TraceFromEyeHeight(100.f,50.f);
 
 	if(!LedgeHitResult.bBlockingHit)
@@ -396,25 +1732,34 @@ bool UCustomMovementComponent::CheckHasReachedLedge()
 		DoLineTraceSingleByObject(WalkableSurfaceTraceStart,WalkableSurfaceTraceEnd, true);
 
 		if(WalkableSurfaceHitResult.bBlockingHit && GetUnrotatedClimbVelocity().Z > 10.f)
-			return true;
+			return ProbeCache.Store(true);
 		
 	}
 
-	return false;
+	return ProbeCache.Store(false);
 }
 
 void UCustomMovementComponent::TryStartVaulting()
 {
 	FVector VaultStartPosition;
 	FVector VaultLandPosition;
+	if(!CanEnterTraversalState(ETraversalState::Vaulting)) return;
+
 	if(CanStartVaulting(VaultStartPosition,VaultLandPosition))
 	{
 		SetMotionWarpTarget(FName("VaultStartPoint"), VaultStartPosition);
 		SetMotionWarpTarget(FName("VaultEndPoint"), VaultLandPosition);
 
+		TryEnterTraversalState(ETraversalState::Vaulting);
 		StartClimbing();
-		PlayClimbMontage(VaultMontage);
-		
+		if(!PlayClimbMontage(VaultMontage))
+		{
+			SetMovementMode(MOVE_Walking);
+		}
+		else
+		{
+			ClaimClimbInput(EClimbLatencyAction::Vault);
+		}
 	}
 	
 }
@@ -423,67 +1768,102 @@ bool UCustomMovementComponent::CanStartVaulting(FVector& OutVaultStartPosition,
 {
 	if(IsFalling()) return false;
 
-	OutVaultStartPosition = FVector::ZeroVector;
-	OutVaultLandPosition = FVector::ZeroVector;
 	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
 	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
-	const FVector UpVector = UpdatedComponent->GetUpVector();
-	const FVector DownVector = -UpdatedComponent->GetUpVector();
 
-	for (int i = 0; i< 5; i++)
+	const ETraversalIndexResult IndexResult = QueryTraversalIndex(ETraversalOpportunity::Vault, ComponentLocation, ComponentForward, OutVaultStartPosition, OutVaultLandPosition);
+	if(IndexResult != ETraversalIndexResult::NotIndexed) return IndexResult == ETraversalIndexResult::Found;
+
+	FTraversalProbeCache& ProbeCache = TraversalProbeCaches[(uint8)ETraversalProbe::StartVaulting];
+	if(!AcquireTraversalQuery(ETraversalProbe::StartVaulting, GetTraversalOpportunityTraceCost(ETraversalOpportunity::Vault)))
 	{
-		const FVector Start = ComponentLocation + UpVector*100.f + ComponentForward * 100.f * (i+1);
+		OutVaultStartPosition = CachedVaultStartPosition;
+		OutVaultLandPosition = CachedVaultLandPosition;
+		return ProbeCache.bResult;
+	}
 
-		const FVector End = Start + DownVector * 100.f * (i+1);
+	const bool bCanVault = TraceTraversalOpportunity(ETraversalOpportunity::Vault, ComponentLocation, ComponentForward, OutVaultStartPosition, OutVaultLandPosition);
 
-		FHitResult VaultTraceResult = DoLineTraceSingleByObject(Start,End);
+	CachedVaultStartPosition = OutVaultStartPosition;
+	CachedVaultLandPosition = OutVaultLandPosition;
 
-		if(i == 0 && VaultTraceResult.bBlockingHit)
-		{
-			OutVaultStartPosition = VaultTraceResult.ImpactPoint;
-		}
-		if(i == 3 && VaultTraceResult.bBlockingHit)
-		{
-			OutVaultLandPosition = VaultTraceResult.ImpactPoint;
-		}
-	}
+	return ProbeCache.Store(bCanVault);
+}
 
-	if(OutVaultStartPosition != FVector::ZeroVector && OutVaultLandPosition != FVector::ZeroVector)
-	{
-		return true;
-	}
-	else
+bool UCustomMovementComponent::PlayClimbMontage(UAnimMontage* MontageToPlay)
+{
+	if(!MontageToPlay) return false;
+	if(ActiveBakedTraversalID != 0) return false;
+
+	if(ShouldUseBakedTraversal(MontageToPlay))
 	{
-		return false;
+		return StartBakedTraversal(MontageToPlay);
 	}
-	
-}
 
-void UCustomMovementComponent::PlayClimbMontage(UAnimMontage* MontageToPlay)
-{
-	if(!MontageToPlay) return;
-	if(!OwningPlayerAnimInstance) return;
-	if(OwningPlayerAnimInstance->IsAnyMontagePlaying()) return;
+	if(!OwningPlayerAnimInstance) return false;
+	if(OwningPlayerAnimInstance->IsAnyMontagePlaying()) return false;
+
+	BeginTraversalParityCheck();
+	if(OwningPlayerAnimInstance->Montage_Play(MontageToPlay) <= 0.f) return false;
 
-	OwningPlayerAnimInstance->Montage_Play(MontageToPlay);
+	FClimbFlightRecorder::Get().Record(EClimbFlightEventType::MontageEvent, GetOwner(), 1, 0.f, MontageToPlay);
+	PendingTraversalMontage = MontageToPlay;
+	return true;
 }
 
 void UCustomMovementComponent::OnClimbMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 {
+	FClimbFlightRecorder::Get().Record(EClimbFlightEventType::MontageEvent, GetOwner(), bInterrupted ? 2 : 0, 0.f, Montage);
+
+	// A baked traversal's montage only poses the mesh, the root motion source decides when the traversal ends
+	const bool bBakedTraversalPose = ActiveBakedTraversalID != 0 && Montage == ActiveBakedTraversalMontage;
+	if(!Montage || Montage != PendingTraversalMontage || bBakedTraversalPose)
+	{
+		++TransitionCounters.IgnoredMontageEvents;
+		return;
+	}
+
+	if(!bInterrupted && BakedTraversalCVars::bParityCheck)
+	{
+		CheckTraversalParity(Montage);
+	}
+
+	// Cut short before its first frame of motion
+	if(GetInputLatencyMontage() == Montage)
+	{
+		FClimbInputLatency::Get().Abandon(ClimbInputStamp);
+	}
+	PendingTraversalMontage = nullptr;
+
 	if(Montage == IdleToClimbMontage || Montage==ClimbDownLedgeMontage)
 	{
-		StartClimbing();
+		// Climbing down over a ledge ends holding its edge, unless there is no edge to hold
+		const bool bHangsFromLedge = Montage == ClimbDownLedgeMontage && bEnableLedgeHang && StartHanging();
+		if(!bHangsFromLedge)
+		{
+			StartClimbing();
+		}
 		StopMovementImmediately();
 	}
 
 	if(Montage == ClimbToTopMontage || Montage == VaultMontage)
 	{
-		SetMovementMode(MOVE_Walking);
+		if(IsMovingOnGround())
+		{
+			++TransitionCounters.RedundantModeChangesSkipped;
+			TryEnterTraversalState(ETraversalState::Idle);
+		}
+		else
+		{
+			SetMovementMode(MOVE_Walking);
+		}
 	}
 }
 
 void UCustomMovementComponent::SetMotionWarpTarget(const FName& InWarpTargetName, const FVector& InTargetPosition)
 {
+	MotionWarpTargets.Add(InWarpTargetName, InTargetPosition);
+
 	if(!OwningPlayerCharacter) return;
 
 	OwningPlayerCharacter->GetMotionWarpingComponent()->AddOrUpdateWarpTargetFromLocation(
@@ -493,18 +1873,219 @@ void UCustomMovementComponent::SetMotionWarpTarget(const FName& InWarpTargetName
 }
 
 
+bool UCustomMovementComponent::ShouldUseBakedTraversal(const UAnimMontage* Montage) const
+{
+	if(!BakedTraversalMotionData || !BakedTraversalMotionData->FindMotion(Montage)) return false;
+
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	// The server and the owning client have to move the character the same way, so a networked game bakes on both
+	if(GetNetMode() != NM_Standalone) return Settings->bUseBakedTraversalOnServer;
+
+	return Settings->bUseBakedTraversalForUnrenderedAI &&
+		!CharacterOwner->IsPlayerControlled() &&
+		!CharacterOwner->WasRecentlyRendered(1.f);
+}
+
+bool UCustomMovementComponent::StartBakedTraversal(UAnimMontage* Montage)
+{
+	int32 MotionIndex = INDEX_NONE;
+	if(!BakedTraversalMotionData->FindMotion(Montage, &MotionIndex)) return false;
+
+	TSharedPtr<FRootMotionSource_BakedTraversal> BakedTraversalSource = MakeShared<FRootMotionSource_BakedTraversal>();
+	BakedTraversalSource->InstanceName = Montage->GetFName();
+	BakedTraversalSource->MotionData = BakedTraversalMotionData;
+	BakedTraversalSource->MotionIndex = MotionIndex;
+	BakedTraversalSource->StartLocation = UpdatedComponent->GetComponentLocation();
+	BakedTraversalSource->StartBasis = CharacterOwner->GetMesh()->GetComponentQuat();
+	BakedTraversalSource->ResolveWarpTargets(MotionWarpTargets, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+
+	BeginTraversalParityCheck();
+
+	// Walking would flatten the curve onto the floor, the traversal mode follows it until it hands over to the next mode
+	if(!IsClimbing() && !IsHanging())
+	{
+		SetMovementMode(MOVE_Custom, ECustomMovementMode::Move_Traversal);
+	}
+
+	ActiveBakedTraversalID = ApplyRootMotionSource(BakedTraversalSource);
+	if(ActiveBakedTraversalID == (uint16)ERootMotionSourceID::Invalid) return false;
+
+	ActiveBakedTraversalMontage = Montage;
+	PendingTraversalMontage = Montage;
+
+	// Where the character is seen the montage still plays for the pose, its root motion left to the curve
+	if(OwningPlayerAnimInstance && !IsNetMode(NM_DedicatedServer) && CharacterOwner->WasRecentlyRendered(1.f))
+	{
+		PreBakedTraversalRootMotionMode = OwningPlayerAnimInstance->RootMotionMode;
+		OwningPlayerAnimInstance->SetRootMotionMode(ERootMotionMode::IgnoreRootMotion);
+		bPlayingBakedTraversalPose = OwningPlayerAnimInstance->Montage_Play(Montage) > 0.f;
+		if(!bPlayingBakedTraversalPose)
+		{
+			OwningPlayerAnimInstance->SetRootMotionMode(PreBakedTraversalRootMotionMode);
+		}
+	}
+	return true;
+}
+
+void UCustomMovementComponent::UpdateBakedTraversal()
+{
+	if(ActiveBakedTraversalID == 0) return;
+
+	const TSharedPtr<FRootMotionSource> BakedTraversalSource = GetRootMotionSourceByID(ActiveBakedTraversalID);
+	if(BakedTraversalSource.IsValid() && !BakedTraversalSource->Status.HasFlag(ERootMotionSourceStatusFlags::Finished)) return;
+
+	UAnimMontage* FinishedMontage = ActiveBakedTraversalMontage;
+	ActiveBakedTraversalID = 0;
+	ActiveBakedTraversalMontage = nullptr;
+
+	if(bPlayingBakedTraversalPose)
+	{
+		bPlayingBakedTraversalPose = false;
+		OwningPlayerAnimInstance->SetRootMotionMode(PreBakedTraversalRootMotionMode);
+	}
+
+	// Same hand over as a montage blending out
+	OnClimbMontageEnded(FinishedMontage, false);
+}
+
+void UCustomMovementComponent::PhysTraversal(float deltaTime, int32 Iterations)
+{
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	// No input, gravity or friction, the baked root motion is the whole move
+	RestorePreAdditiveRootMotionVelocity();
+	if(!CurrentRootMotion.HasOverrideVelocity())
+	{
+		Velocity = FVector::ZeroVector;
+	}
+	ApplyRootMotionToVelocity(deltaTime);
+
+	const FVector Adjusted = Velocity * deltaTime;
+	FHitResult Hit(1.f);
+	SafeMoveUpdatedComponent(Adjusted, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+	if(Hit.Time < 1.f)
+	{
+		HandleImpact(Hit, deltaTime, Adjusted);
+		SlideAlongSurface(Adjusted, (1.f - Hit.Time), Hit.Normal, Hit, true);
+	}
+}
+
+void UCustomMovementComponent::BeginTraversalParityCheck()
+{
+	if(!BakedTraversalCVars::bParityCheck) return;
+
+	TraversalParityStartLocation = UpdatedComponent->GetComponentLocation();
+	TraversalParityStartBasis = CharacterOwner->GetMesh()->GetComponentQuat();
+	TraversalParityRootHeightOffset = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	TraversalParityWarpTargets = MotionWarpTargets;
+}
+
+void UCustomMovementComponent::CheckTraversalParity(const UAnimMontage* Montage) const
+{
+	const FVector ExpectedLocation = UTraversalMotionData::PredictMontageEndLocation(Montage, TraversalParityStartLocation,
+		TraversalParityStartBasis, TraversalParityWarpTargets, TraversalParityRootHeightOffset);
+	const float ParityError = FVector::Dist(UpdatedComponent->GetComponentLocation(), ExpectedLocation);
+	const bool bPassed = ParityError <= UClimbingSettings::Get()->BakedTraversalParityTolerance;
+
+	UE_LOG(LogClimbing, Display, TEXT("%s %s on the %s ended %.2f cm from its montage root motion: %s"),
+		*GetNameSafe(GetOwner()), *Montage->GetName(), IsNetMode(NM_Client) ? TEXT("client") : TEXT("server"),
+		ParityError, bPassed ? TEXT("passed") : TEXT("FAILED"));
+}
+
+bool UCustomMovementComponent::SetClimbCapsuleHalfHeight(float NewHalfHeight)
+{
+	UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+	if(FMath::IsNearlyEqual(Capsule->GetUnscaledCapsuleHalfHeight(), NewHalfHeight)) return false;
+
+	// Inside a deferred scoped movement update this only flags the overlap refresh for the end of the scope
+	Capsule->SetCapsuleHalfHeight(NewHalfHeight);
+	return true;
+}
+
+bool UCustomMovementComponent::IsValidTraversalTransition(ETraversalState From, ETraversalState To)
+{
+	switch (From)
+	{
+	case ETraversalState::Idle:
+		return To == ETraversalState::Entering || To == ETraversalState::Vaulting || To == ETraversalState::WallRunning || To == ETraversalState::Hanging;
+	case ETraversalState::Entering:
+		return To == ETraversalState::Climbing || To == ETraversalState::Hanging || To == ETraversalState::Idle;
+	case ETraversalState::Climbing:
+		return To == ETraversalState::ToppingOut || To == ETraversalState::Dropping || To == ETraversalState::Hanging || To == ETraversalState::Idle;
+	case ETraversalState::Hanging:
+		return To == ETraversalState::ToppingOut || To == ETraversalState::Dropping || To == ETraversalState::Climbing || To == ETraversalState::Idle;
+	case ETraversalState::ToppingOut:
+	case ETraversalState::Vaulting:
+		return To == ETraversalState::Idle || To == ETraversalState::Dropping;
+	case ETraversalState::Dropping:
+		return To == ETraversalState::Idle || To == ETraversalState::WallRunning || To == ETraversalState::Hanging;
+	case ETraversalState::WallRunning:
+		return To == ETraversalState::Idle || To == ETraversalState::Dropping;
+	default:
+		return false;
+	}
+}
+
+bool UCustomMovementComponent::CanEnterTraversalState(ETraversalState NewState) const
+{
+	return IsValidTraversalTransition(TraversalState, NewState);
+}
+
+bool UCustomMovementComponent::TryEnterTraversalState(ETraversalState NewState)
+{
+	if(!CanEnterTraversalState(NewState))
+	{
+		++TransitionCounters.RejectedTransitions;
+		return false;
+	}
+
+	if(TraversalState != NewState)
+	{
+		FClimbFlightRecorder::Get().Record(EClimbFlightEventType::TraversalStateChanged, GetOwner(), (uint8)NewState);
+		TraversalState = NewState;
+		++TransitionCounters.TraversalStateChanges;
+		OnTraversalStateChangedDelegate.ExecuteIfBound(NewState);
+	}
+	return true;
+}
+
 void UCustomMovementComponent::ToggleClimbing(bool bEnableClimb)
 {
+	FClimbFlightRecorder::Get().Record(EClimbFlightEventType::ToggleClimbing, GetOwner(), bEnableClimb, (float)TraversalState);
+
 	if(bEnableClimb)
 	{
+		// Nothing below can start in the air
+		if(IsFalling())
+		{
+			if(TryStartWallRun())
+			{
+				ClaimClimbInput(EClimbLatencyAction::WallRun);
+			}
+			return;
+		}
+
+		if(!CanEnterTraversalState(ETraversalState::Entering) && !CanEnterTraversalState(ETraversalState::Vaulting)) return;
+
 		if(CanStartClimbing())
 		{
-			PlayClimbMontage(IdleToClimbMontage);
+			if(PlayClimbMontage(IdleToClimbMontage))
+			{
+				TryEnterTraversalState(ETraversalState::Entering);
+				ClaimClimbInput(EClimbLatencyAction::EnterClimb);
+			}
 		}
 		else if(CanClimbDownLedge())
 		{
-			
-			PlayClimbMontage(ClimbDownLedgeMontage);
+			if(PlayClimbMontage(ClimbDownLedgeMontage))
+			{
+				TryEnterTraversalState(ETraversalState::Entering);
+				ClaimClimbInput(EClimbLatencyAction::ClimbDownLedge);
+			}
 		}
 		else
 		{
@@ -514,19 +2095,294 @@ void UCustomMovementComponent::ToggleClimbing(bool bEnableClimb)
 	}
 	if(!bEnableClimb)
 	{
+		const bool bWasOnWall = IsClimbing() || IsHanging();
 		StopClimbing();
+		if(bWasOnWall && IsFalling())
+		{
+			ClaimClimbInput(EClimbLatencyAction::ExitClimb);
+		}
+	}
+}
+
+#pragma region InputLatency
+
+void UCustomMovementComponent::StampClimbInput()
+{
+	if(!FClimbInputLatency::Get().IsRecording()) return;
+
+	// A new press replaces one whose motion has not shown yet
+	FClimbInputLatency::Get().Abandon(ClimbInputStamp);
+	ClimbInputStamp = FClimbInputStamp::Now();
+}
+
+void UCustomMovementComponent::StampMoveInput()
+{
+	// Move input arrives every frame it is held, only its first frame is an input event
+	const bool bInputOnset = LastMoveInputFrame + 1 < GFrameCounter;
+	LastMoveInputFrame = GFrameCounter;
+	if(!bInputOnset || !FClimbInputLatency::Get().IsRecording()) return;
+
+	FClimbInputLatency::Get().Abandon(MoveInputStamp);
+	MoveInputStamp = FClimbInputStamp::Now();
+	MoveInputStamp.Action = IsHanging() ? EClimbLatencyAction::HangShimmy : EClimbLatencyAction::ClimbMove;
+}
+
+void UCustomMovementComponent::ClaimClimbInput(EClimbLatencyAction Action)
+{
+	// Only the input handed over since the last move, RequestClimbToggle waits for the next one. Other ToggleClimbing calls have none
+	if(ClimbInputStamp.Frame + 1 < GFrameCounter || ClimbInputStamp.IsAwaitingMotion()) return;
+	ClimbInputStamp.Action = Action;
+}
+
+const UAnimMontage* UCustomMovementComponent::GetInputLatencyMontage() const
+{
+	if(!ClimbInputStamp.IsAwaitingMotion()) return nullptr;
+
+	const EClimbLatencyAction Action = ClimbInputStamp.Action;
+	const bool bMontageAction = Action == EClimbLatencyAction::EnterClimb || Action == EClimbLatencyAction::ClimbDownLedge ||
+		Action == EClimbLatencyAction::Vault;
+	return bMontageAction ? PendingTraversalMontage : nullptr;
+}
+
+void UCustomMovementComponent::ResolveClimbInputLatency()
+{
+	FClimbInputLatency::Get().Resolve(ClimbInputStamp);
+}
+
+void UCustomMovementComponent::ResolveMoveInputLatency(const FVector& PreviousVelocity)
+{
+	if(!MoveInputStamp.IsAwaitingMotion() || Velocity.Equals(PreviousVelocity, KINDA_SMALL_NUMBER)) return;
+
+	// Only motion the input asked for, separation pushes or the climber slowing from an earlier input are not it
+	const FVector InputDirection = Acceleration.GetSafeNormal();
+	if(FVector::DotProduct(Velocity, InputDirection) > KINDA_SMALL_NUMBER)
+	{
+		FClimbInputLatency::Get().Resolve(MoveInputStamp);
 	}
 }
 
+#pragma endregion
+
 bool UCustomMovementComponent::IsClimbing() const
 {
 	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::Move_Climb;
 }
 
+bool UCustomMovementComponent::IsHanging() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::Move_Hang;
+}
+
+bool UCustomMovementComponent::IsWallRunning() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::Move_WallRun;
+}
+
+ETraversalIndexResult UCustomMovementComponent::QueryTraversalIndex(ETraversalOpportunity Opportunity, const FVector& CharacterLocation,
+	const FVector& Forward, FVector& OutVaultStart, FVector& OutVaultLand) const
+{
+	if(!TraversalIndex) return ETraversalIndexResult::NotIndexed;
+
+	const FVector FeetLocation = CharacterLocation - FVector::UpVector * CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	switch(Opportunity)
+	{
+	case ETraversalOpportunity::Climb:
+	{
+		// Baked climb surfaces already passed a grip table, only trust them when it is ours
+		if(TraversalIndex->GetGripTableHash() != GetClimbGripTableHash()) return ETraversalIndexResult::NotIndexed;
+
+		// The eye trace reaches 100, the climbable surface sweep only its offset plus the capsule radius
+		const float Reach = FMath::Min(100.f, 31.f + ClimbCapsuleTraceRadius);
+		return TraversalIndex->FindClimbSurface(CharacterLocation + FVector::UpVector * CharacterOwner->BaseEyeHeight, Forward, Reach);
+	}
+	case ETraversalOpportunity::DropDown:
+		return TraversalIndex->FindLedge(FeetLocation, Forward, ClimbDownWalkableSurfaceTraceOffset, ClimbDownWalkableSurfaceTraceOffset + ClimbDownLedgeTraceOffset);
+	case ETraversalOpportunity::Vault:
+		return TraversalIndex->FindVaultPoint(FeetLocation, Forward, OutVaultStart, OutVaultLand);
+	default:
+		return ETraversalIndexResult::NotIndexed;
+	}
+}
+
+bool UCustomMovementComponent::TraceTraversalOpportunity(ETraversalOpportunity Opportunity, const FVector& CharacterLocation,
+	const FVector& Forward, FVector& OutVaultStart, FVector& OutVaultLand)
+{
+	const FVector UpVector = FVector::UpVector;
+	const FVector DownVector = -FVector::UpVector;
+
+	switch(Opportunity)
+	{
+	case ETraversalOpportunity::Climb:
+	{
+		// A grippable surface right in front, tall enough to still be there at eye height
+		const FVector SweepStart = CharacterLocation + Forward * 30.f;
+		TArray<FHitResult> SweepHits = DoCapsuleTraceMultiByObject(SweepStart, SweepStart + Forward, false, false, true);
+		RemoveUngrippableHits(SweepHits);
+		if(SweepHits.IsEmpty()) return false;
+
+		const FVector EyeStart = CharacterLocation + UpVector * CharacterOwner->BaseEyeHeight;
+		return DoLineTraceSingleByObject(EyeStart, EyeStart + Forward * 100.f, false).bBlockingHit;
+	}
+	case ETraversalOpportunity::DropDown:
+	{
+		// Floor just ahead, then nothing below a step further out
+		const FVector WalkableSurfaceTraceStart = CharacterLocation + Forward * ClimbDownWalkableSurfaceTraceOffset;
+		if(!DoLineTraceSingleByObject(WalkableSurfaceTraceStart, WalkableSurfaceTraceStart + DownVector * 100.f, false).bBlockingHit) return false;
+
+		const FVector LedgeTraceStart = WalkableSurfaceTraceStart + Forward * ClimbDownLedgeTraceOffset;
+		return !DoLineTraceSingleByObject(LedgeTraceStart, LedgeTraceStart + DownVector * 200.f, false).bBlockingHit;
+	}
+	case ETraversalOpportunity::Vault:
+	{
+		OutVaultStart = FVector::ZeroVector;
+		OutVaultLand = FVector::ZeroVector;
+
+		for (int i = 0; i< 5; i++)
+		{
+			const FVector Start = CharacterLocation + UpVector*100.f + Forward * 100.f * (i+1);
+			const FVector End = Start + DownVector * 100.f * (i+1);
+
+			FHitResult VaultTraceResult = DoLineTraceSingleByObject(Start,End);
+
+			if(i == 0 && VaultTraceResult.bBlockingHit)
+			{
+				OutVaultStart = VaultTraceResult.ImpactPoint;
+			}
+			if(i == 3 && VaultTraceResult.bBlockingHit)
+			{
+				OutVaultLand = VaultTraceResult.ImpactPoint;
+			}
+		}
+
+		return OutVaultStart != FVector::ZeroVector && OutVaultLand != FVector::ZeroVector;
+	}
+	default:
+		return false;
+	}
+}
+
+int32 UCustomMovementComponent::GetTraversalOpportunityTraceCost(ETraversalOpportunity Opportunity)
+{
+	return Opportunity == ETraversalOpportunity::Vault ? 5 : 2;
+}
+
+ETraversalProbeOutcome UCustomMovementComponent::ProbeTraversalOpportunity(ETraversalOpportunity Opportunity,
+	const FVector& FeetLocation, const FVector& Forward, int32& InOutTraceBudget)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	const float CacheLifetime = Settings->TraversalOpportunityCacheLifetime;
+
+	// Neighbouring candidates within a few centimetres and facing the same octant share one result
+	FTraversalOpportunityCacheKey CacheKey;
+	CacheKey.Cell = FIntVector(
+		FMath::RoundToInt(FeetLocation.X / 25.f),
+		FMath::RoundToInt(FeetLocation.Y / 25.f),
+		FMath::RoundToInt(FeetLocation.Z / 25.f));
+	CacheKey.FacingOctant = FMath::RoundToInt(FMath::RadiansToDegrees(FMath::Atan2(Forward.Y, Forward.X)) / 45.f) & 7;
+	CacheKey.Opportunity = Opportunity;
+
+	if(const FTraversalOpportunityCacheEntry* Cached = TraversalOpportunityCache.Find(CacheKey))
+	{
+		if(Now - Cached->Time <= CacheLifetime)
+		{
+			return Cached->bFound ? ETraversalProbeOutcome::Found : ETraversalProbeOutcome::NotFound;
+		}
+	}
+
+	const FVector CharacterLocation = FeetLocation + FVector::UpVector * CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	FVector VaultStart, VaultLand;
+	bool bFound;
+	const ETraversalIndexResult IndexResult = QueryTraversalIndex(Opportunity, CharacterLocation, Forward, VaultStart, VaultLand);
+	if(IndexResult != ETraversalIndexResult::NotIndexed)
+	{
+		bFound = IndexResult == ETraversalIndexResult::Found;
+	}
+	else
+	{
+		const int32 TraceCost = GetTraversalOpportunityTraceCost(Opportunity);
+		if(InOutTraceBudget < TraceCost) return ETraversalProbeOutcome::OutOfBudget;
+
+		InOutTraceBudget -= TraceCost;
+		bFound = TraceTraversalOpportunity(Opportunity, CharacterLocation, Forward, VaultStart, VaultLand);
+	}
+
+	// A full cache drops what expired, or its oldest entry when everything in it is still fresh
+	const int32 MaxEntries = FMath::Max(Settings->TraversalOpportunityCacheMaxEntries, 1);
+	if(TraversalOpportunityCache.Num() >= MaxEntries && !TraversalOpportunityCache.Contains(CacheKey))
+	{
+		bool bRemovedExpired = false;
+		FTraversalOpportunityCacheKey OldestKey;
+		double OldestTime = TNumericLimits<double>::Max();
+		for(auto It = TraversalOpportunityCache.CreateIterator(); It; ++It)
+		{
+			if(Now - It.Value().Time > CacheLifetime)
+			{
+				It.RemoveCurrent();
+				bRemovedExpired = true;
+			}
+			else if(It.Value().Time < OldestTime)
+			{
+				OldestTime = It.Value().Time;
+				OldestKey = It.Key();
+			}
+		}
+		if(!bRemovedExpired)
+		{
+			TraversalOpportunityCache.Remove(OldestKey);
+		}
+	}
+	TraversalOpportunityCache.Add(CacheKey, {bFound, Now});
+
+	return bFound ? ETraversalProbeOutcome::Found : ETraversalProbeOutcome::NotFound;
+}
+
+FTraversalIndexBakeParams UCustomMovementComponent::GetTraversalIndexBakeParams() const
+{
+	// Also called on the character's default object, so everything comes from its defaults rather than BeginPlay state
+	const ACharacter* Character = Cast<ACharacter>(GetOwner());
+
+	FTraversalIndexBakeParams Params;
+	if(Character)
+	{
+		Params.StandingHalfHeight = Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+		Params.EyeHeight = Character->BaseEyeHeight;
+	}
+	Params.ClimbSweepOffset = 30.f;
+	Params.ClimbCapsuleRadius = ClimbCapsuleTraceRadius;
+	Params.ClimbCapsuleHalfHeight = ClimbCapsuleTraceHalfHeight;
+	Params.ClimbEyeReach = 100.f;
+	Params.WalkableSurfaceTraceOffset = ClimbDownWalkableSurfaceTraceOffset;
+	Params.LedgeTraceOffset = ClimbDownLedgeTraceOffset;
+	Params.ClimbObjectQueryParams = UClimbingSettings::Get()->bUseClimbProxyChannel ?
+		FCollisionObjectQueryParams(ECC_ClimbProxy) : FCollisionObjectQueryParams(ClimbableSurfaceTraceTypes);
+	Params.ObjectQueryParams = FCollisionObjectQueryParams(ClimbableSurfaceTraceTypes);
+	if(ClimbGripTable)
+	{
+		Params.IsGrippable = [this](const FHitResult& Hit) { return ResolveClimbGrip(Hit).bClimbable; };
+	}
+	Params.GripTableHash = GetClimbGripTableHash();
+	return Params;
+}
+
+uint32 UCustomMovementComponent::GetClimbGripTableHash() const
+{
+	return ClimbGripTable ? ClimbGripTable->GetContentHash() : 0;
+}
+
+bool UCustomMovementComponent::CanApplyClimbSeparation() const
+{
+	// A remote client's moves are replayed from what it sent, which the server's separation never was part of.
+	// Applying it there, or on the client, would make the two machines move the climber differently
+	return CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_Authority && CharacterOwner->GetRemoteRole() != ROLE_AutonomousProxy;
+}
+
 FVector UCustomMovementComponent::GetUnrotatedClimbVelocity() const
 {
 
-	return UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(),Velocity);
+	return ClimbMath::UnrotateClimbVelocity(UpdatedComponent->GetComponentQuat(),Velocity);
 }
 
 
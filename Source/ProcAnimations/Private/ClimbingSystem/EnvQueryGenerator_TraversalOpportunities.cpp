@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/EnvQueryGenerator_TraversalOpportunities.h"
+
+#include "Components/CapsuleComponent.h"
+#include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/Controller.h"
+#include "ClimbingSystem/TraversalIndexSubsystem.h"
+
+#define LOCTEXT_NAMESPACE "EnvQueryGenerator"
+
+UEnvQueryGenerator_TraversalOpportunities::UEnvQueryGenerator_TraversalOpportunities(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	GenerateAround = UEnvQueryContext_Querier::StaticClass();
+	SearchRadius.DefaultValue = 1500.f;
+	SpaceBetween.DefaultValue = 200.f;
+}
+
+void UEnvQueryGenerator_TraversalOpportunities::GenerateItems(FEnvQueryInstance& QueryInstance) const
+{
+	UObject* BindOwner = QueryInstance.Owner.Get();
+	SearchRadius.BindData(BindOwner, QueryInstance.QueryID);
+	SpaceBetween.BindData(BindOwner, QueryInstance.QueryID);
+
+	const float Radius = SearchRadius.GetValue();
+	const float Spacing = FMath::Max(SpaceBetween.GetValue(), 10.f);
+
+	TArray<FVector> ContextLocations;
+	QueryInstance.PrepareContext(GenerateAround, ContextLocations);
+
+	// Index climb points are at eye height, the querier's own dimensions turn them into a place to stand
+	const AController* QuerierController = Cast<AController>(BindOwner);
+	const ACharacter* QuerierCharacter = Cast<ACharacter>(QuerierController ? QuerierController->GetPawn() : BindOwner);
+	const float EyeHeightAboveFeet = QuerierCharacter
+		? QuerierCharacter->BaseEyeHeight + QuerierCharacter->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()
+		: 160.f;
+
+	const UTraversalIndexSubsystem* TraversalIndex = QueryInstance.World ? QueryInstance.World->GetSubsystem<UTraversalIndexSubsystem>() : nullptr;
+
+	TArray<FNavLocation> Points;
+	for(const FVector& Center : ContextLocations)
+	{
+		if(TraversalIndex && TraversalIndex->IsAreaResident(Center, Radius))
+		{
+			TArray<FVector> Approaches;
+			if(bClimb) TraversalIndex->GatherApproachLocations(ETraversalOpportunity::Climb, Center, Radius, EyeHeightAboveFeet, Approaches);
+			if(bVault) TraversalIndex->GatherApproachLocations(ETraversalOpportunity::Vault, Center, Radius, EyeHeightAboveFeet, Approaches);
+			if(bDropDown) TraversalIndex->GatherApproachLocations(ETraversalOpportunity::DropDown, Center, Radius, EyeHeightAboveFeet, Approaches);
+
+			for(const FVector& Approach : Approaches)
+			{
+				Points.Add(FNavLocation(Approach));
+			}
+			continue;
+		}
+
+		const int32 ItemsPerSide = FMath::FloorToInt(Radius / Spacing);
+		for(int32 X = -ItemsPerSide; X <= ItemsPerSide; ++X)
+		{
+			for(int32 Y = -ItemsPerSide; Y <= ItemsPerSide; ++Y)
+			{
+				const FVector Offset(X * Spacing, Y * Spacing, 0.f);
+				if(Offset.SizeSquared2D() > FMath::Square(Radius)) continue;
+
+				Points.Add(FNavLocation(Center + Offset));
+			}
+		}
+	}
+
+	ProjectAndFilterNavPoints(Points, QueryInstance);
+	StoreNavPoints(Points, QueryInstance);
+}
+
+FText UEnvQueryGenerator_TraversalOpportunities::GetDescriptionTitle() const
+{
+	return FText::Format(LOCTEXT("TraversalOpportunitiesDescriptionGenerateAroundContext", "{0}: generate around {1}"),
+		Super::GetDescriptionTitle(), UEnvQueryTypes::DescribeContext(GenerateAround));
+}
+
+FText UEnvQueryGenerator_TraversalOpportunities::GetDescriptionDetails() const
+{
+	FText Desc = FText::Format(LOCTEXT("TraversalOpportunitiesDescription", "radius: {0}, grid spacing where not indexed: {1}"),
+		FText::FromString(SearchRadius.ToString()), FText::FromString(SpaceBetween.ToString()));
+
+	const FText ProjDesc = ProjectionData.ToText(FEnvTraceData::Brief);
+	if(!ProjDesc.IsEmpty())
+	{
+		Desc = FText::Format(LOCTEXT("TraversalOpportunitiesDescriptionWithProjection", "{0}, {1}"), Desc, ProjDesc);
+	}
+
+	return Desc;
+}
+
+#undef LOCTEXT_NAMESPACE
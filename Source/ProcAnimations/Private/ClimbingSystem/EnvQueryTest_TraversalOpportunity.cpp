@@ -0,0 +1,238 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/EnvQueryTest_TraversalOpportunity.h"
+
+#include "EnvironmentQuery/Items/EnvQueryItemType_VectorBase.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/Controller.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "ClimbingSystem/CustomMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+#define LOCTEXT_NAMESPACE "EnvQueryTest"
+
+namespace TraversalOpportunityCommands
+{
+	/**
+	 * Probes a grid of distinct cache keys around the climber, each opportunity and facing octant, several times the
+	 * cache cap. Every answer from the shared cache has to match a probe into an empty one, the cache never grows
+	 * past its cap, and the most recent probes are answered again without a trace.
+	 */
+	static bool CheckProbeCache(UCustomMovementComponent* MovementComponent)
+	{
+		// ProbeTraversalOpportunity quantizes to 25cm and 45 degrees, one probe per key
+		static constexpr int32 GridHalfSize = 10;
+		static constexpr float KeyCellSize = 25.f;
+
+		struct FProbe
+		{
+			ETraversalOpportunity Opportunity;
+			FVector FeetLocation;
+			FVector Facing;
+			ETraversalProbeOutcome FreshOutcome;
+		};
+
+		const ACharacter* Character = MovementComponent->GetCharacterOwner();
+		const FVector Feet = Character->GetActorLocation() - FVector::UpVector * Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+		const FVector Origin = FVector(FMath::RoundToFloat(Feet.X / KeyCellSize), FMath::RoundToFloat(Feet.Y / KeyCellSize), FMath::RoundToFloat(Feet.Z / KeyCellSize)) * KeyCellSize;
+
+		TArray<FProbe> Probes;
+		for(int32 X = -GridHalfSize; X <= GridHalfSize; ++X)
+		for(int32 Y = -GridHalfSize; Y <= GridHalfSize; ++Y)
+		for(int32 Octant = 0; Octant < 8; ++Octant)
+		for(const ETraversalOpportunity Opportunity : {ETraversalOpportunity::Climb, ETraversalOpportunity::Vault, ETraversalOpportunity::DropDown})
+		{
+			const float Angle = FMath::DegreesToRadians(45.f * Octant);
+			Probes.Add({Opportunity, Origin + FVector(X, Y, 0.f) * KeyCellSize, FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f), ETraversalProbeOutcome::NotFound});
+		}
+
+		for(FProbe& Probe : Probes)
+		{
+			MovementComponent->ResetTraversalOpportunityCache();
+			int32 TraceBudget = MAX_int32;
+			Probe.FreshOutcome = MovementComponent->ProbeTraversalOpportunity(Probe.Opportunity, Probe.FeetLocation, Probe.Facing, TraceBudget);
+		}
+
+		const int32 MaxEntries = UClimbingSettings::Get()->TraversalOpportunityCacheMaxEntries;
+		int32 Mismatches = 0;
+		int32 LargestCache = 0;
+		MovementComponent->ResetTraversalOpportunityCache();
+		for(const FProbe& Probe : Probes)
+		{
+			int32 TraceBudget = MAX_int32;
+			Mismatches += MovementComponent->ProbeTraversalOpportunity(Probe.Opportunity, Probe.FeetLocation, Probe.Facing, TraceBudget) != Probe.FreshOutcome;
+			LargestCache = FMath::Max(LargestCache, MovementComponent->GetNumCachedTraversalOpportunities());
+		}
+
+		int32 Misses = 0;
+		for(int32 Index = FMath::Max(Probes.Num() - MaxEntries, 0); Index < Probes.Num(); ++Index)
+		{
+			const FProbe& Probe = Probes[Index];
+			int32 NoTraces = 0;
+			Misses += MovementComponent->ProbeTraversalOpportunity(Probe.Opportunity, Probe.FeetLocation, Probe.Facing, NoTraces) != Probe.FreshOutcome;
+		}
+		MovementComponent->ResetTraversalOpportunityCache();
+
+		const bool bPassed = Mismatches == 0 && Misses == 0 && LargestCache <= MaxEntries;
+		UE_LOG(LogClimbing, Display, TEXT("Traversal opportunity cache check %s: %d probes, %d wrong answers, %d recent probes not cached, at most %d of %d entries"),
+			bPassed ? TEXT("passed") : TEXT("FAILED"), Probes.Num(), Mismatches, Misses, LargestCache, MaxEntries);
+		return bPassed;
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs CheckCacheCommand(
+		TEXT("Climbing.TraversalOpportunity.CheckCache"),
+		TEXT("Checks the AI traversal opportunity probe cache of the first climber against uncached probes and its entry cap"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(!World) return;
+
+			for(TObjectIterator<UCustomMovementComponent> It; It; ++It)
+			{
+				if(It->GetWorld() != World || !It->GetCharacterOwner()) continue;
+
+				CheckProbeCache(*It);
+				return;
+			}
+			UE_LOG(LogClimbing, Error, TEXT("Traversal opportunity cache check found no climber"));
+		}));
+}
+
+UEnvQueryTest_TraversalOpportunity::UEnvQueryTest_TraversalOpportunity(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	Cost = EEnvTestCost::High;
+	ValidItemType = UEnvQueryItemType_VectorBase::StaticClass();
+	SetWorkOnFloatValues(false);
+	MaxTracesPerQuery.DefaultValue = 64;
+}
+
+void UEnvQueryTest_TraversalOpportunity::RunTest(FEnvQueryInstance& QueryInstance) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_TraversalEQS_Test);
+
+	UObject* QueryOwner = QueryInstance.Owner.Get();
+	BoolValue.BindData(QueryOwner, QueryInstance.QueryID);
+	MaxTracesPerQuery.BindData(QueryOwner, QueryInstance.QueryID);
+
+	const bool bWantsOpportunity = BoolValue.GetValue();
+
+	const AController* QuerierController = Cast<AController>(QueryOwner);
+	const ACharacter* QuerierCharacter = Cast<ACharacter>(QuerierController ? QuerierController->GetPawn() : QueryOwner);
+	UCustomMovementComponent* MovementComponent = QuerierCharacter ? Cast<UCustomMovementComponent>(QuerierCharacter->GetCharacterMovement()) : nullptr;
+	if(!MovementComponent)
+	{
+		// Unscored items would pass a filter, only a climber can say whether it could start from them
+		static bool bLoggedMissingClimber = false;
+		if(!bLoggedMissingClimber)
+		{
+			bLoggedMissingClimber = true;
+			UE_LOG(LogClimbing, Warning, TEXT("%s queried by %s, which has no UCustomMovementComponent. Every item fails"),
+				*GetNameSafe(this), *GetNameSafe(QueryOwner));
+		}
+
+		FEnvQueryInstance::ItemIterator It(this, QueryInstance);
+		for(It.IgnoreTimeLimit(); It; ++It)
+		{
+			It.ForceItemState(EEnvItemStatus::Failed);
+		}
+		return;
+	}
+
+	const FVector QuerierLocation = QuerierCharacter->GetActorLocation();
+
+	struct FCandidate
+	{
+		int32 ItemIndex;
+		FVector Location;
+		ETraversalProbeOutcome Outcome;
+	};
+
+	auto ProbeCandidate = [this, MovementComponent, &QuerierLocation, &QuerierCharacter](const FVector& Location, int32& InOutTraceBudget)
+	{
+		FVector BaseFacing = (Location - QuerierLocation).GetSafeNormal2D();
+		if(BaseFacing.IsNearlyZero()) BaseFacing = QuerierCharacter->GetActorForwardVector().GetSafeNormal2D();
+
+		ETraversalProbeOutcome Outcome = ETraversalProbeOutcome::NotFound;
+		for(int32 FacingIndex = 0; FacingIndex < NumFacings; ++FacingIndex)
+		{
+			const FVector Facing = BaseFacing.RotateAngleAxis(360.f * FacingIndex / NumFacings, FVector::UpVector);
+			const ETraversalProbeOutcome FacingOutcome = MovementComponent->ProbeTraversalOpportunity(Opportunity, Location, Facing, InOutTraceBudget);
+
+			if(FacingOutcome == ETraversalProbeOutcome::Found) return ETraversalProbeOutcome::Found;
+			if(FacingOutcome == ETraversalProbeOutcome::OutOfBudget) Outcome = ETraversalProbeOutcome::OutOfBudget;
+		}
+		return Outcome;
+	};
+
+	// First batch: everything the index or the probe cache can answer, without spending a trace
+	TArray<FCandidate> Candidates;
+	Candidates.Reserve(QueryInstance.Items.Num());
+	for(int32 ItemIndex = 0; ItemIndex < QueryInstance.Items.Num(); ++ItemIndex)
+	{
+		if(!QueryInstance.Items[ItemIndex].IsValid()) continue;
+
+		const FVector Location = GetItemLocation(QueryInstance, ItemIndex);
+		int32 NoTraces = 0;
+		Candidates.Add({ItemIndex, Location, ProbeCandidate(Location, NoTraces)});
+	}
+	INC_DWORD_STAT_BY(STAT_TraversalEQS_Items, Candidates.Num());
+
+	// Second batch: trace the rest nearest first, so the budget goes to the spots the AI would reach soonest
+	TArray<FCandidate*> Unresolved;
+	for(FCandidate& Candidate : Candidates)
+	{
+		if(Candidate.Outcome == ETraversalProbeOutcome::OutOfBudget) Unresolved.Add(&Candidate);
+	}
+	Unresolved.Sort([&QuerierLocation](const FCandidate& A, const FCandidate& B)
+	{
+		return FVector::DistSquared(A.Location, QuerierLocation) < FVector::DistSquared(B.Location, QuerierLocation);
+	});
+
+	const int32 TraceBudget = FMath::Max(MaxTracesPerQuery.GetValue(), 0);
+	int32 TracesLeft = TraceBudget;
+	for(FCandidate* Candidate : Unresolved)
+	{
+		Candidate->Outcome = ProbeCandidate(Candidate->Location, TracesLeft);
+	}
+	INC_DWORD_STAT_BY(STAT_TraversalEQS_Traces, TraceBudget - TracesLeft);
+
+	TMap<int32, ETraversalProbeOutcome> Outcomes;
+	Outcomes.Reserve(Candidates.Num());
+	for(const FCandidate& Candidate : Candidates)
+	{
+		Outcomes.Add(Candidate.ItemIndex, Candidate.Outcome);
+	}
+
+	// Outcomes were resolved up front, so the scoring pass must not be split across frames
+	FEnvQueryInstance::ItemIterator It(this, QueryInstance);
+	for(It.IgnoreTimeLimit(); It; ++It)
+	{
+		const ETraversalProbeOutcome* Outcome = Outcomes.Find(It.GetIndex());
+		if(!Outcome || *Outcome == ETraversalProbeOutcome::OutOfBudget)
+		{
+			INC_DWORD_STAT(STAT_TraversalEQS_OverBudget);
+			It.ForceItemState(EEnvItemStatus::Failed);
+			continue;
+		}
+
+		It.SetScore(TestPurpose, FilterType, *Outcome == ETraversalProbeOutcome::Found, bWantsOpportunity);
+	}
+}
+
+FText UEnvQueryTest_TraversalOpportunity::GetDescriptionTitle() const
+{
+	return FText::Format(LOCTEXT("TraversalOpportunityTitle", "{0}: {1}"), Super::GetDescriptionTitle(),
+		UEnum::GetDisplayValueAsText(Opportunity));
+}
+
+FText UEnvQueryTest_TraversalOpportunity::GetDescriptionDetails() const
+{
+	return FText::Format(LOCTEXT("TraversalOpportunityDetails", "{0}, at most {1} traces, {2} facings"),
+		DescribeBoolTestParams(TEXT("can start")), FText::FromString(MaxTracesPerQuery.ToString()), FText::AsNumber(NumFacings));
+}
+
+#undef LOCTEXT_NAMESPACE
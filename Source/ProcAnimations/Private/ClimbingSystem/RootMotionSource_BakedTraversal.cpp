@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/RootMotionSource_BakedTraversal.h"
+
+#include "ClimbingSystem/TraversalMotionData.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+FRootMotionSource_BakedTraversal::FRootMotionSource_BakedTraversal()
+{
+	AccumulateMode = ERootMotionAccumulateMode::Override;
+	Priority = 500;
+}
+
+const FBakedTraversalMotion* FRootMotionSource_BakedTraversal::GetMotion() const
+{
+	return MotionData ? MotionData->GetMotion(MotionIndex) : nullptr;
+}
+
+void FRootMotionSource_BakedTraversal::ResolveWarpTargets(const TMap<FName, FVector>& WarpTargets, float RootHeightOffset)
+{
+	WarpWindowOffsets.Reset();
+
+	const FBakedTraversalMotion* Motion = GetMotion();
+	if(!Motion) return;
+
+	Duration = Motion->Duration;
+
+	// Windows run in order, each one pulls the end of its window onto its target on top of the earlier corrections
+	FVector AccumulatedOffset = FVector::ZeroVector;
+	for(const FBakedTraversalWarpWindow& WarpWindow : Motion->WarpWindows)
+	{
+		FVector WindowOffset = FVector::ZeroVector;
+		if(const FVector* WarpTarget = WarpTargets.Find(WarpWindow.WarpTargetName))
+		{
+			const FVector UnwarpedEnd = StartLocation + StartBasis.RotateVector(Motion->EvaluateTranslation(WarpWindow.EndTime)) + AccumulatedOffset;
+			WindowOffset = (*WarpTarget + FVector::UpVector * RootHeightOffset) - UnwarpedEnd;
+		}
+
+		WarpWindowOffsets.Add(WindowOffset);
+		AccumulatedOffset += WindowOffset;
+	}
+}
+
+FVector FRootMotionSource_BakedTraversal::EvaluateLocation(float InTime) const
+{
+	const FBakedTraversalMotion* Motion = GetMotion();
+	if(!Motion) return StartLocation;
+
+	FVector WarpOffset = FVector::ZeroVector;
+	for(int32 WindowIndex = 0; WindowIndex < Motion->WarpWindows.Num() && WindowIndex < WarpWindowOffsets.Num(); ++WindowIndex)
+	{
+		const FBakedTraversalWarpWindow& WarpWindow = Motion->WarpWindows[WindowIndex];
+		if(InTime <= WarpWindow.StartTime) break;
+
+		const float WindowLength = FMath::Max(WarpWindow.EndTime - WarpWindow.StartTime, KINDA_SMALL_NUMBER);
+		const float WindowAlpha = FMath::Clamp((InTime - WarpWindow.StartTime) / WindowLength, 0.f, 1.f);
+		WarpOffset += WarpWindowOffsets[WindowIndex] * WindowAlpha;
+	}
+
+	return StartLocation + StartBasis.RotateVector(Motion->EvaluateTranslation(InTime)) + WarpOffset;
+}
+
+FRootMotionSource* FRootMotionSource_BakedTraversal::Clone() const
+{
+	return new FRootMotionSource_BakedTraversal(*this);
+}
+
+bool FRootMotionSource_BakedTraversal::Matches(const FRootMotionSource* Other) const
+{
+	if(!FRootMotionSource::Matches(Other)) return false;
+
+	const FRootMotionSource_BakedTraversal* OtherCast = static_cast<const FRootMotionSource_BakedTraversal*>(Other);
+	return MotionData == OtherCast->MotionData &&
+		MotionIndex == OtherCast->MotionIndex &&
+		StartLocation.Equals(OtherCast->StartLocation, 1.f);
+}
+
+bool FRootMotionSource_BakedTraversal::UpdateStateFrom(const FRootMotionSource* SourceToTakeStateFrom,
+	bool bMarkForSimulatedCatchup)
+{
+	return FRootMotionSource::UpdateStateFrom(SourceToTakeStateFrom, bMarkForSimulatedCatchup);
+}
+
+void FRootMotionSource_BakedTraversal::PrepareRootMotion(float SimulationTime, float MovementTickTime,
+	const ACharacter& Character, const UCharacterMovementComponent& MoveComponent)
+{
+	RootMotionParams.Clear();
+
+	if(Duration > SMALL_NUMBER && MovementTickTime > SMALL_NUMBER && SimulationTime > SMALL_NUMBER)
+	{
+		// Velocity that lands the updated component on the curve at the end of this tick
+		const FVector TargetLocation = EvaluateLocation(GetTime() + SimulationTime);
+		const FVector CurrentLocation = Character.GetActorLocation();
+		const FVector Force = (TargetLocation - CurrentLocation) / MovementTickTime;
+
+		RootMotionParams.Set(FTransform(Force));
+	}
+
+	SetTime(GetTime() + SimulationTime);
+}
+
+bool FRootMotionSource_BakedTraversal::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	if(!FRootMotionSource::NetSerialize(Ar, Map, bOutSuccess)) return false;
+
+	UObject* MotionDataObject = const_cast<UTraversalMotionData*>(MotionData.Get());
+	Ar << MotionDataObject;
+	MotionData = Cast<UTraversalMotionData>(MotionDataObject);
+
+	Ar << MotionIndex;
+	Ar << StartLocation;
+	Ar << StartBasis;
+	Ar << WarpWindowOffsets;
+
+	bOutSuccess = true;
+	return true;
+}
+
+UScriptStruct* FRootMotionSource_BakedTraversal::GetScriptStruct() const
+{
+	return FRootMotionSource_BakedTraversal::StaticStruct();
+}
+
+FString FRootMotionSource_BakedTraversal::ToSimpleString() const
+{
+	return FString::Printf(TEXT("[ID:%u]FRootMotionSource_BakedTraversal %s"), LocalID, *InstanceName.GetPlainNameString());
+}
+
+void FRootMotionSource_BakedTraversal::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(MotionData);
+
+	FRootMotionSource::AddReferencedObjects(Collector);
+}
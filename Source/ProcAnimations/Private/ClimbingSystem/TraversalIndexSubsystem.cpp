@@ -0,0 +1,552 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/TraversalIndexSubsystem.h"
+
+#include "Async/MappedFileHandle.h"
+#include "ClimbingSystem/ClimbingCharacter.h"
+#include "ClimbingSystem/CustomMovementComponent.h"
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingMemory.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "ClimbingSystem/ClimbStreamingSubsystem.h"
+#include "ClimbingSystem/TraversalIndexWriter.h"
+#include "Engine/LevelBounds.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "WorldPartition/WorldPartitionRuntimeCell.h"
+#include "WorldPartition/WorldPartitionSubsystem.h"
+
+namespace TraversalIndexPointArrays
+{
+	/** In the order of the chunk's point arrays and their sub-cell ranges */
+	static constexpr int32 ClimbSurfaces = 0;
+	static constexpr int32 Ledges = 1;
+	static constexpr int32 VaultPoints = 2;
+}
+
+namespace TraversalIndexCommands
+{
+	static FAutoConsoleCommandWithWorldAndArgs BakeCommand(
+		TEXT("Climbing.TraversalIndex.Bake"),
+		TEXT("Bakes the traversal index of the current level to Content/TraversalData. Args: [SampleSpacing]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(!World || !World->PersistentLevel) return;
+
+			const float SampleSpacing = Args.IsValidIndex(0) ? FMath::Max(10.f, FCString::Atof(*Args[0])) : 50.f;
+			const FBox Bounds = ALevelBounds::CalculateLevelBounds(World->PersistentLevel);
+
+			// The bake runs the probes of the character the level is played with
+			UClass* ClimberClass = UClimbingSettings::Get()->BenchmarkCharacterClass.LoadSynchronous();
+			const AClimbingCharacter* Climber = GetDefault<AClimbingCharacter>(ClimberClass ? ClimberClass : AClimbingCharacter::StaticClass());
+
+			FTraversalIndexWriter Writer(UClimbingSettings::Get()->TraversalIndexCellSize);
+			TraversalIndexBaker::BakeWorld(World, Bounds, SampleSpacing, Climber->GetCustomMovementComponent()->GetTraversalIndexBakeParams(), Writer);
+
+			const FString FilePath = UTraversalIndexSubsystem::GetIndexFilePath(World);
+			if(Writer.Write(FilePath))
+			{
+				UE_LOG(LogClimbing, Display, TEXT("Baked %d traversal points to %s"), Writer.GetNumPoints(), *FilePath);
+			}
+			else
+			{
+				UE_LOG(LogClimbing, Error, TEXT("Could not write traversal index %s"), *FilePath);
+			}
+		}));
+}
+
+bool UTraversalIndexSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UTraversalIndexSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTraversalIndexSubsystem, STATGROUP_Climbing);
+}
+
+FString UTraversalIndexSubsystem::GetIndexFilePath(const UWorld* World)
+{
+	const FString MapName = UWorld::RemovePIEPrefix(FPackageName::GetShortName(World->GetOutermost()));
+	return FPaths::ProjectContentDir() / TEXT("TraversalData") / (MapName + TEXT(".ctix"));
+}
+
+void UTraversalIndexSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if(UClimbingSettings::Get()->bUseTraversalIndex)
+	{
+		OpenIndex();
+	}
+}
+
+void UTraversalIndexSubsystem::Deinitialize()
+{
+	ResidentCells.Empty();
+	CellTableRegion.Reset();
+	MappedFile.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UTraversalIndexSubsystem::OpenIndex()
+{
+	const FString FilePath = GetIndexFilePath(GetWorld());
+
+	// Mapping needs the file loose on disk, see DirectoriesToAlwaysStageAsNonUFS
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+	if(!MappedFile) return false;
+
+	const int64 FileSize = MappedFile->GetFileSize();
+	if(FileSize < (int64)sizeof(FTraversalIndexHeader))
+	{
+		MappedFile.Reset();
+		return false;
+	}
+
+	TUniquePtr<IMappedFileRegion> HeaderRegion(MappedFile->MapRegion(0, sizeof(FTraversalIndexHeader)));
+	const FTraversalIndexHeader* Header = HeaderRegion ? reinterpret_cast<const FTraversalIndexHeader*>(HeaderRegion->GetMappedPtr()) : nullptr;
+
+	const bool bValidHeader = Header &&
+		Header->Magic == TraversalIndexFormat::Magic &&
+		Header->Version == TraversalIndexFormat::Version &&
+		Header->FileSize == (uint64)FileSize &&
+		Header->CellTableOffset + Header->NumCells * sizeof(FTraversalIndexCellEntry) <= (uint64)FileSize;
+
+	if(!bValidHeader)
+	{
+		UE_LOG(LogClimbing, Warning, TEXT("%s is not a version %u traversal index, falling back to traces"), *FilePath, TraversalIndexFormat::Version);
+		MappedFile.Reset();
+		return false;
+	}
+
+	CellSize = Header->CellSize;
+	GripTableHash = Header->GripTableHash;
+
+	// The cell table stays mapped for the life of the world, it is only a few bytes per cell
+	CellTableRegion.Reset(MappedFile->MapRegion(Header->CellTableOffset, Header->NumCells * sizeof(FTraversalIndexCellEntry)));
+	if(!CellTableRegion)
+	{
+		MappedFile.Reset();
+		return false;
+	}
+
+	const TConstArrayView<FTraversalIndexCellEntry> CellTable(
+		reinterpret_cast<const FTraversalIndexCellEntry*>(CellTableRegion->GetMappedPtr()), Header->NumCells);
+
+	IndexedCells.Reserve(CellTable.Num());
+	for(const FTraversalIndexCellEntry& Entry : CellTable)
+	{
+		if(Entry.ChunkOffset + Entry.ChunkSize > (uint64)FileSize) continue;
+
+		IndexedCells.Add(FIntPoint(Entry.CellX, Entry.CellY), Entry);
+	}
+
+	UE_LOG(LogClimbing, Display, TEXT("Opened traversal index %s with %d cells"), *FilePath, IndexedCells.Num());
+	UpdateResidentCells();
+	return true;
+}
+
+void UTraversalIndexSubsystem::Tick(float DeltaTime)
+{
+	if(!MappedFile) return;
+
+	TimeUntilStreamingUpdate -= DeltaTime;
+	if(TimeUntilStreamingUpdate > 0.f) return;
+
+	TimeUntilStreamingUpdate = UClimbingSettings::Get()->TraversalIndexStreamingInterval;
+	UpdateResidentCells();
+}
+
+void UTraversalIndexSubsystem::UpdateResidentCells()
+{
+	LLM_SCOPE_BYTAG(Climbing_TraversalIndex);
+	SCOPE_CYCLE_COUNTER(STAT_TraversalIndex_Streaming);
+
+	UWorld* World = GetWorld();
+	const float StreamingRadius = UClimbingSettings::Get()->TraversalIndexStreamingRadius;
+	const int32 CellRadius = FMath::CeilToInt(StreamingRadius / CellSize);
+
+	// Same sources world partition streams around: every player's view point, and the climb lookahead ahead of them
+	TArray<FVector, TInlineAllocator<8>> StreamingCenters;
+	for(FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if(!PlayerController) continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		StreamingCenters.Add(ViewLocation);
+	}
+	if(const UClimbStreamingSubsystem* ClimbStreaming = World->GetSubsystem<UClimbStreamingSubsystem>())
+	{
+		TArray<FWorldPartitionStreamingSource> LookaheadSources;
+		ClimbStreaming->GetStreamingSources(LookaheadSources);
+		for(const FWorldPartitionStreamingSource& Source : LookaheadSources)
+		{
+			StreamingCenters.Add(Source.Location);
+		}
+	}
+
+	// Candidate cells, with the height of the source that wants them for the streaming query
+	TMap<FIntPoint, double> WantedCells;
+	for(const FVector& StreamingCenter : StreamingCenters)
+	{
+		const FIntPoint CenterCell = GetCell(StreamingCenter);
+		for(int32 X = -CellRadius; X <= CellRadius; ++X)
+		{
+			for(int32 Y = -CellRadius; Y <= CellRadius; ++Y)
+			{
+				const FIntPoint Cell = CenterCell + FIntPoint(X, Y);
+				const FVector2D CellCenter = (FVector2D(Cell) + FVector2D(0.5f)) * CellSize;
+				if(FVector2D::DistSquared(CellCenter, FVector2D(StreamingCenter)) <= FMath::Square(StreamingRadius + CellSize) && IndexedCells.Contains(Cell))
+				{
+					WantedCells.Add(Cell, StreamingCenter.Z);
+				}
+			}
+		}
+	}
+
+	// In a partitioned world a cell is only resident while the level under it is active, so the index never answers
+	// for geometry that has not streamed in yet, nor keeps answering for geometry that streamed out
+	UWorldPartitionSubsystem* WorldPartitionSubsystem = World->IsPartitionedWorld() ? World->GetSubsystem<UWorldPartitionSubsystem>() : nullptr;
+	if(WorldPartitionSubsystem)
+	{
+		TArray<FWorldPartitionStreamingQuerySource> CellArea;
+		FWorldPartitionStreamingQuerySource& Query = CellArea.AddDefaulted_GetRef();
+		Query.Radius = CellSize * UE_HALF_SQRT_2;
+		Query.bUseGridLoadingRange = false;
+
+		for(auto It = WantedCells.CreateIterator(); It; ++It)
+		{
+			Query.Location = FVector((FVector2D(It.Key()) + FVector2D(0.5f)) * CellSize, It.Value());
+			if(!WorldPartitionSubsystem->IsStreamingCompleted(EWorldPartitionRuntimeCellState::Activated, CellArea, false))
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	for(auto It = ResidentCells.CreateIterator(); It; ++It)
+	{
+		if(!WantedCells.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for(const TPair<FIntPoint, double>& Cell : WantedCells)
+	{
+		if(!ResidentCells.Contains(Cell.Key))
+		{
+			MapCell(Cell.Key, IndexedCells.FindChecked(Cell.Key));
+		}
+	}
+
+	SET_DWORD_STAT(STAT_TraversalIndex_ResidentCells, ResidentCells.Num());
+}
+
+bool UTraversalIndexSubsystem::MapCell(const FIntPoint& Cell, const FTraversalIndexCellEntry& Entry)
+{
+	TUniquePtr<IMappedFileRegion> Region(MappedFile->MapRegion(Entry.ChunkOffset, Entry.ChunkSize));
+	if(!Region || Entry.ChunkSize < sizeof(FTraversalIndexChunkHeader)) return false;
+
+	const uint8* ChunkBase = Region->GetMappedPtr();
+	const FTraversalIndexChunkHeader* ChunkHeader = reinterpret_cast<const FTraversalIndexChunkHeader*>(ChunkBase);
+
+	// A chunk whose arrays run past its end is corrupt and stays unindexed, so queries fall back to traces
+	const uint32 SubCellsPerSide = ChunkHeader->SubCellsPerSide;
+	const uint32 NumSubCellRanges = TraversalIndexFormat::GetNumSubCellRanges(SubCellsPerSide);
+	const bool bValidChunk =
+		SubCellsPerSide > 0 && SubCellsPerSide <= 256 &&
+		ChunkHeader->SubCellRangesOffset + NumSubCellRanges * sizeof(uint32) <= Entry.ChunkSize &&
+		ChunkHeader->ClimbSurfacesOffset + ChunkHeader->NumClimbSurfaces * sizeof(FTraversalClimbSurfacePoint) <= Entry.ChunkSize &&
+		ChunkHeader->LedgesOffset + ChunkHeader->NumLedges * sizeof(FTraversalLedgePoint) <= Entry.ChunkSize &&
+		ChunkHeader->VaultPointsOffset + ChunkHeader->NumVaultPoints * sizeof(FTraversalVaultPoint) <= Entry.ChunkSize;
+	if(!bValidChunk) return false;
+
+	// Queries index the point arrays with the ranges unchecked, so every range has to stay within its array
+	const TConstArrayView<uint32> SubCellRanges(reinterpret_cast<const uint32*>(ChunkBase + ChunkHeader->SubCellRangesOffset), NumSubCellRanges);
+	const uint32 NumPoints[TraversalIndexFormat::NumPointArrays] = {ChunkHeader->NumClimbSurfaces, ChunkHeader->NumLedges, ChunkHeader->NumVaultPoints};
+	const int32 RangesPerArray = NumSubCellRanges / TraversalIndexFormat::NumPointArrays;
+	for(int32 PointArray = 0; PointArray < TraversalIndexFormat::NumPointArrays; ++PointArray)
+	{
+		const TConstArrayView<uint32> Ranges = SubCellRanges.Slice(PointArray * RangesPerArray, RangesPerArray);
+		if(Ranges.Last() != NumPoints[PointArray]) return false;
+		for(int32 Index = 1; Index < Ranges.Num(); ++Index)
+		{
+			if(Ranges[Index] < Ranges[Index - 1]) return false;
+		}
+	}
+
+	FResidentCell& Resident = ResidentCells.Add(Cell);
+	Resident.CellOrigin = FVector(Cell.X * CellSize, Cell.Y * CellSize, 0.f);
+	Resident.SubCellRanges = SubCellRanges;
+	Resident.SubCellsPerSide = SubCellsPerSide;
+	Resident.SubCellSize = CellSize / SubCellsPerSide;
+	Resident.ClimbSurfaces = MakeArrayView(reinterpret_cast<const FTraversalClimbSurfacePoint*>(ChunkBase + ChunkHeader->ClimbSurfacesOffset), ChunkHeader->NumClimbSurfaces);
+	Resident.Ledges = MakeArrayView(reinterpret_cast<const FTraversalLedgePoint*>(ChunkBase + ChunkHeader->LedgesOffset), ChunkHeader->NumLedges);
+	Resident.VaultPoints = MakeArrayView(reinterpret_cast<const FTraversalVaultPoint*>(ChunkBase + ChunkHeader->VaultPointsOffset), ChunkHeader->NumVaultPoints);
+	Resident.Region = MoveTemp(Region);
+	return true;
+}
+
+FIntPoint UTraversalIndexSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+bool UTraversalIndexSubsystem::MatchesBakedFacing(const FVector& BakedDirection, const FVector& Forward)
+{
+	static const float MinFacingDot = FMath::Cos(PI / TraversalIndexBaker::NumDirections);
+	return (FVector2D(BakedDirection).GetSafeNormal() | FVector2D(Forward).GetSafeNormal()) >= MinFacingDot;
+}
+
+bool UTraversalIndexSubsystem::GatherCells(const FVector& Location, float Radius,
+	TArray<const FResidentCell*, TInlineAllocator<4>>& OutCells) const
+{
+	if(!MappedFile) return false;
+
+	const FIntPoint MinCell = GetCell(Location - FVector(Radius));
+	const FIntPoint MaxCell = GetCell(Location + FVector(Radius));
+	for(int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for(int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			const FResidentCell* Resident = ResidentCells.Find(FIntPoint(X, Y));
+			if(!Resident) return false;
+
+			OutCells.Add(Resident);
+		}
+	}
+	return true;
+}
+
+bool UTraversalIndexSubsystem::GatherPointSpans(int32 PointArray, const FVector& Location, float Radius, FPointSpans& OutSpans) const
+{
+	TArray<const FResidentCell*, TInlineAllocator<4>> Cells;
+	if(!GatherCells(Location, Radius, Cells)) return false;
+
+	for(const FResidentCell* Cell : Cells)
+	{
+		const int32 SubCellsPerSide = Cell->SubCellsPerSide;
+		const int32 RangesPerArray = SubCellsPerSide * SubCellsPerSide + 1;
+		const TConstArrayView<uint32> Ranges = Cell->SubCellRanges.Slice(PointArray * RangesPerArray, RangesPerArray);
+
+		const FVector CellLocation = Location - Cell->CellOrigin;
+		auto GetSubCell = [Cell, SubCellsPerSide](double Coordinate)
+		{
+			return FMath::Clamp(FMath::FloorToInt(Coordinate / Cell->SubCellSize), 0, SubCellsPerSide - 1);
+		};
+		const int32 MinX = GetSubCell(CellLocation.X - Radius);
+		const int32 MaxX = GetSubCell(CellLocation.X + Radius);
+		const int32 MinY = GetSubCell(CellLocation.Y - Radius);
+		const int32 MaxY = GetSubCell(CellLocation.Y + Radius);
+
+		// Sub-cells are sorted along X within a row, so each overlapped row is one run of points
+		for(int32 Y = MinY; Y <= MaxY; ++Y)
+		{
+			const int32 First = Ranges[Y * SubCellsPerSide + MinX];
+			const int32 End = Ranges[Y * SubCellsPerSide + MaxX + 1];
+			if(End > First)
+			{
+				OutSpans.Add({Cell, First, End - First});
+			}
+		}
+	}
+	return true;
+}
+
+ETraversalIndexResult UTraversalIndexSubsystem::FindClimbSurface(const FVector& EyeLocation, const FVector& Forward, float Reach) const
+{
+	const float LateralTolerance = UClimbingSettings::Get()->TraversalIndexLateralTolerance;
+	FPointSpans Spans;
+	if(!GatherPointSpans(TraversalIndexPointArrays::ClimbSurfaces, EyeLocation, Reach + LateralTolerance, Spans)) return ETraversalIndexResult::NotIndexed;
+
+	INC_DWORD_STAT(STAT_TraversalIndex_Queries);
+
+	for(const FPointSpan& Span : Spans)
+	{
+		for(const FTraversalClimbSurfacePoint& Point : Span.Cell->ClimbSurfaces.Slice(Span.First, Span.Num))
+		{
+			const FVector ToPoint = Span.Cell->CellOrigin + FVector(Point.Location) - EyeLocation;
+			const float ForwardDistance = ToPoint | Forward;
+			if(ForwardDistance < 0.f || ForwardDistance > Reach) continue;
+			if((ToPoint - Forward * ForwardDistance).SizeSquared() > FMath::Square(LateralTolerance)) continue;
+			if((FVector(Point.Normal) | -Forward) < 0.5f) continue;
+
+			return ETraversalIndexResult::Found;
+		}
+	}
+	return ETraversalIndexResult::NotFound;
+}
+
+ETraversalIndexResult UTraversalIndexSubsystem::FindLedge(const FVector& FeetLocation, const FVector& Forward, float MinDistance, float MaxDistance) const
+{
+	const float LateralTolerance = UClimbingSettings::Get()->TraversalIndexLateralTolerance;
+	FPointSpans Spans;
+	if(!GatherPointSpans(TraversalIndexPointArrays::Ledges, FeetLocation, MaxDistance + LateralTolerance, Spans)) return ETraversalIndexResult::NotIndexed;
+
+	INC_DWORD_STAT(STAT_TraversalIndex_Queries);
+
+	for(const FPointSpan& Span : Spans)
+	{
+		for(const FTraversalLedgePoint& Point : Span.Cell->Ledges.Slice(Span.First, Span.Num))
+		{
+			// The edge has to fall between the probe's walkable trace and its drop trace
+			const FVector ToPoint = Span.Cell->CellOrigin + FVector(Point.Location) - FeetLocation;
+			const float ForwardDistance = ToPoint | Forward;
+			if(ForwardDistance < MinDistance || ForwardDistance > MaxDistance) continue;
+			if(FVector2D(ToPoint - Forward * ForwardDistance).SizeSquared() > FMath::Square(LateralTolerance)) continue;
+			if(FMath::Abs(ToPoint.Z) > 5.f) continue;
+			if(!MatchesBakedFacing(FVector(Point.OutwardDirection), Forward)) continue;
+
+			return ETraversalIndexResult::Found;
+		}
+	}
+	return ETraversalIndexResult::NotFound;
+}
+
+ETraversalIndexResult UTraversalIndexSubsystem::FindCatchLedge(const FVector& HandStart, const FVector& HandEnd, const FVector& Facing,
+	FVector& OutEdgeLocation, FVector& OutWallNormal) const
+{
+	// How far inboard of the edge the hands may pass over the top and still hold it
+	static constexpr float EdgeAllowance = 40.f;
+
+	const float LateralTolerance = UClimbingSettings::Get()->TraversalIndexLateralTolerance;
+	const FVector Center = (HandStart + HandEnd) * 0.5f;
+	const float Radius = (HandEnd - HandStart).Size() * 0.5f + EdgeAllowance + LateralTolerance;
+
+	FPointSpans Spans;
+	if(!GatherPointSpans(TraversalIndexPointArrays::Ledges, Center, Radius, Spans)) return ETraversalIndexResult::NotIndexed;
+
+	INC_DWORD_STAT(STAT_TraversalIndex_Queries);
+
+	const float Drop = HandStart.Z - HandEnd.Z;
+	if(Drop <= 0.f) return ETraversalIndexResult::NotFound;
+
+	for(const FPointSpan& Span : Spans)
+	{
+		for(const FTraversalLedgePoint& Point : Span.Cell->Ledges.Slice(Span.First, Span.Num))
+		{
+			const FVector Location = Span.Cell->CellOrigin + FVector(Point.Location);
+			if(Location.Z > HandStart.Z || Location.Z < HandEnd.Z) continue;
+
+			const FVector Outward(Point.OutwardDirection);
+			if((Outward | Facing) > -0.7f) continue;
+
+			// Where the hands are as they pass the height of the top, which has to be over the top near its edge
+			const FVector HandsAtTop = FMath::Lerp(HandStart, HandEnd, (HandStart.Z - Location.Z) / Drop);
+			const FVector ToHands = FVector(HandsAtTop.X - Location.X, HandsAtTop.Y - Location.Y, 0.f);
+			const float OutwardDistance = ToHands | Outward;
+			if(OutwardDistance < -EdgeAllowance || OutwardDistance > 0.f) continue;
+			if((ToHands - Outward * OutwardDistance).SizeSquared() > FMath::Square(LateralTolerance)) continue;
+
+			OutEdgeLocation = FVector(HandsAtTop.X, HandsAtTop.Y, Location.Z);
+			OutWallNormal = Outward;
+			return ETraversalIndexResult::Found;
+		}
+	}
+	return ETraversalIndexResult::NotFound;
+}
+
+ETraversalIndexResult UTraversalIndexSubsystem::FindVaultPoint(const FVector& FeetLocation, const FVector& Forward,
+	FVector& OutStart, FVector& OutLand) const
+{
+	// CanStartVaulting finds the obstacle top with its first trace, 100 ahead
+	static constexpr float VaultTopDistance = 100.f;
+	static constexpr float VaultReach = 200.f;
+
+	FPointSpans Spans;
+	if(!GatherPointSpans(TraversalIndexPointArrays::VaultPoints, FeetLocation, VaultReach, Spans)) return ETraversalIndexResult::NotIndexed;
+
+	INC_DWORD_STAT(STAT_TraversalIndex_Queries);
+
+	const float LateralTolerance = UClimbingSettings::Get()->TraversalIndexLateralTolerance;
+	float BestOffset = MAX_flt;
+	for(const FPointSpan& Span : Spans)
+	{
+		for(const FTraversalVaultPoint& Point : Span.Cell->VaultPoints.Slice(Span.First, Span.Num))
+		{
+			const FVector Start = Span.Cell->CellOrigin + FVector(Point.Start);
+			const FVector Land = Span.Cell->CellOrigin + FVector(Point.Land);
+			const FVector ToStart = Start - FeetLocation;
+
+			const float ForwardDistance = ToStart | Forward;
+			const float Offset = FMath::Abs(ForwardDistance - VaultTopDistance);
+			if(Offset > LateralTolerance || Offset >= BestOffset) continue;
+			if(FVector2D(ToStart - Forward * ForwardDistance).SizeSquared() > FMath::Square(LateralTolerance)) continue;
+			if(!MatchesBakedFacing(Land - Start, Forward)) continue;
+
+			BestOffset = Offset;
+			OutStart = Start;
+			OutLand = Land;
+		}
+	}
+	return BestOffset < MAX_flt ? ETraversalIndexResult::Found : ETraversalIndexResult::NotFound;
+}
+
+bool UTraversalIndexSubsystem::IsAreaResident(const FVector& Location, float Radius) const
+{
+	TArray<const FResidentCell*, TInlineAllocator<4>> Cells;
+	return GatherCells(Location, Radius, Cells);
+}
+
+void UTraversalIndexSubsystem::GatherApproachLocations(ETraversalOpportunity Opportunity, const FVector& Center, float Radius,
+	float EyeHeightAboveFeet, TArray<FVector>& OutFeetLocations) const
+{
+	// Matches the reach the start probes accept from, see FindClimbSurface and FindVaultPoint
+	static constexpr float ClimbStandOff = 50.f;
+	static constexpr float VaultStandOff = 100.f;
+	static constexpr float LedgeStandOff = 25.f;
+
+	// The points sit a stand off from the feet locations, which are what has to be within Radius
+	const int32 PointArray = Opportunity == ETraversalOpportunity::Climb ? TraversalIndexPointArrays::ClimbSurfaces :
+		Opportunity == ETraversalOpportunity::Vault ? TraversalIndexPointArrays::VaultPoints : TraversalIndexPointArrays::Ledges;
+	FPointSpans Spans;
+	if(!GatherPointSpans(PointArray, Center, Radius + VaultStandOff, Spans)) return;
+
+	const float RadiusSq = FMath::Square(Radius);
+	for(const FPointSpan& Span : Spans)
+	{
+		const FResidentCell* Cell = Span.Cell;
+		switch(Opportunity)
+		{
+		case ETraversalOpportunity::Climb:
+			for(const FTraversalClimbSurfacePoint& Point : Cell->ClimbSurfaces.Slice(Span.First, Span.Num))
+			{
+				const FVector Normal = FVector(Point.Normal.X, Point.Normal.Y, 0.f).GetSafeNormal();
+				const FVector FeetLocation = Cell->CellOrigin + FVector(Point.Location) + Normal * ClimbStandOff - FVector::UpVector * EyeHeightAboveFeet;
+				if(FVector::DistSquared(FeetLocation, Center) <= RadiusSq) OutFeetLocations.Add(FeetLocation);
+			}
+			break;
+		case ETraversalOpportunity::DropDown:
+			for(const FTraversalLedgePoint& Point : Cell->Ledges.Slice(Span.First, Span.Num))
+			{
+				// Ledge points are the edge itself, stand back from it on the floor
+				const FVector FeetLocation = Cell->CellOrigin + FVector(Point.Location) - FVector(Point.OutwardDirection) * LedgeStandOff;
+				if(FVector::DistSquared(FeetLocation, Center) <= RadiusSq) OutFeetLocations.Add(FeetLocation);
+			}
+			break;
+		case ETraversalOpportunity::Vault:
+			for(const FTraversalVaultPoint& Point : Cell->VaultPoints.Slice(Span.First, Span.Num))
+			{
+				const FVector Start = Cell->CellOrigin + FVector(Point.Start);
+				const FVector Land = Cell->CellOrigin + FVector(Point.Land);
+				const FVector Direction = FVector(Land.X - Start.X, Land.Y - Start.Y, 0.f).GetSafeNormal();
+
+				// The vault start is the obstacle top, stand back from it on the landing's floor height
+				const FVector FeetLocation = FVector(Start.X, Start.Y, Land.Z) - Direction * VaultStandOff;
+				if(FVector::DistSquared(FeetLocation, Center) <= RadiusSq) OutFeetLocations.Add(FeetLocation);
+			}
+			break;
+		}
+	}
+}
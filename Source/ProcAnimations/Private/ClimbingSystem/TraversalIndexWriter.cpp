@@ -0,0 +1,351 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/TraversalIndexWriter.h"
+
+#include "Algo/StableSort.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+namespace TraversalIndexWriter
+{
+	/** Points closer than this to one already added are duplicates from a neighbouring sample */
+	static constexpr float DuplicateDistance = 25.f;
+
+	static FIntVector Quantize(const FVector& Location)
+	{
+		return FIntVector(
+			FMath::RoundToInt(Location.X / DuplicateDistance),
+			FMath::RoundToInt(Location.Y / DuplicateDistance),
+			FMath::RoundToInt(Location.Z / DuplicateDistance));
+	}
+
+	static void PadTo(FArchive& Ar, int64 Alignment)
+	{
+		static const uint8 Zeros[TraversalIndexFormat::ChunkAlignment] = {};
+
+		const int64 Padding = Align(Ar.Tell(), Alignment) - Ar.Tell();
+		Ar.Serialize(const_cast<uint8*>(Zeros), Padding);
+	}
+
+	template<typename PointType>
+	static void WriteArray(FArchive& Ar, const TArray<PointType>& Points)
+	{
+		Ar.Serialize(const_cast<PointType*>(Points.GetData()), Points.Num() * sizeof(PointType));
+	}
+
+	static uint32 GetSubCell(const FVector3f& CellLocation, float SubCellSize)
+	{
+		const int32 MaxSubCell = TraversalIndexFormat::SubCellsPerSide - 1;
+		const int32 SubX = FMath::Clamp(FMath::FloorToInt(CellLocation.X / SubCellSize), 0, MaxSubCell);
+		const int32 SubY = FMath::Clamp(FMath::FloorToInt(CellLocation.Y / SubCellSize), 0, MaxSubCell);
+		return SubY * TraversalIndexFormat::SubCellsPerSide + SubX;
+	}
+
+	/** Sorts Points by sub-cell and appends the index of the first point of each sub-cell, then the point count */
+	template<typename PointType, typename GetLocationType>
+	static void SortBySubCell(TArray<PointType>& Points, float SubCellSize, GetLocationType GetLocation, TArray<uint32>& OutRanges)
+	{
+		Algo::StableSortBy(Points, [&](const PointType& Point) { return GetSubCell(GetLocation(Point), SubCellSize); });
+
+		int32 PointIndex = 0;
+		for(uint32 SubCell = 0; SubCell < TraversalIndexFormat::SubCellsPerSide * TraversalIndexFormat::SubCellsPerSide; ++SubCell)
+		{
+			while(PointIndex < Points.Num() && GetSubCell(GetLocation(Points[PointIndex]), SubCellSize) < SubCell)
+			{
+				++PointIndex;
+			}
+			OutRanges.Add(PointIndex);
+		}
+		OutRanges.Add(Points.Num());
+	}
+}
+
+FTraversalIndexWriter::FTraversalIndexWriter(float InCellSize)
+	: CellSize(InCellSize)
+{
+}
+
+FIntPoint FTraversalIndexWriter::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FTraversalIndexWriter::AddCell(const FIntPoint& Cell)
+{
+	Cells.FindOrAdd(Cell);
+}
+
+void FTraversalIndexWriter::RemoveCell(const FIntPoint& Cell)
+{
+	Cells.Remove(Cell);
+}
+
+void FTraversalIndexWriter::GetCells(TArray<FIntPoint>& OutCells) const
+{
+	Cells.GetKeys(OutCells);
+}
+
+FTraversalIndexWriter::FCellData& FTraversalIndexWriter::GetCellData(const FVector& Location, FVector3f& OutCellOrigin)
+{
+	const FIntPoint Cell = GetCell(Location);
+	OutCellOrigin = FVector3f(Cell.X * CellSize, Cell.Y * CellSize, 0.f);
+	return Cells.FindOrAdd(Cell);
+}
+
+void FTraversalIndexWriter::AddClimbSurface(const FVector& Location, const FVector& Normal)
+{
+	bool bAlreadyAdded = false;
+	AddedPointKeys[0].Add(TraversalIndexWriter::Quantize(Location), &bAlreadyAdded);
+	if(bAlreadyAdded) return;
+
+	FVector3f CellOrigin;
+	GetCellData(Location, CellOrigin).ClimbSurfaces.Add({FVector3f(Location) - CellOrigin, FVector3f(Normal)});
+}
+
+void FTraversalIndexWriter::AddLedge(const FVector& Location, const FVector& OutwardDirection)
+{
+	bool bAlreadyAdded = false;
+	AddedPointKeys[1].Add(TraversalIndexWriter::Quantize(Location + OutwardDirection * TraversalIndexWriter::DuplicateDistance), &bAlreadyAdded);
+	if(bAlreadyAdded) return;
+
+	FVector3f CellOrigin;
+	GetCellData(Location, CellOrigin).Ledges.Add({FVector3f(Location) - CellOrigin, FVector3f(OutwardDirection)});
+}
+
+void FTraversalIndexWriter::AddVaultPoint(const FVector& Start, const FVector& Land)
+{
+	bool bAlreadyAdded = false;
+	AddedPointKeys[2].Add(TraversalIndexWriter::Quantize(Start + (Land - Start).GetSafeNormal() * TraversalIndexWriter::DuplicateDistance), &bAlreadyAdded);
+	if(bAlreadyAdded) return;
+
+	// Vaults are filed under their start, which is where the query looks for them
+	FVector3f CellOrigin;
+	GetCellData(Start, CellOrigin).VaultPoints.Add({FVector3f(Start) - CellOrigin, FVector3f(Land) - CellOrigin});
+}
+
+int32 FTraversalIndexWriter::GetNumPoints() const
+{
+	int32 NumPoints = 0;
+	for(const TPair<FIntPoint, FCellData>& Cell : Cells)
+	{
+		NumPoints += Cell.Value.ClimbSurfaces.Num() + Cell.Value.Ledges.Num() + Cell.Value.VaultPoints.Num();
+	}
+	return NumPoints;
+}
+
+bool FTraversalIndexWriter::Write(const FString& FilePath) const
+{
+	using namespace TraversalIndexWriter;
+
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*FilePath));
+	if(!Ar) return false;
+
+	FTraversalIndexHeader Header;
+	Header.CellSize = CellSize;
+	Header.NumCells = Cells.Num();
+	Header.GripTableHash = GripTableHash;
+	Ar->Serialize(&Header, sizeof(Header));
+
+	TArray<FTraversalIndexCellEntry> CellTable;
+	CellTable.Reserve(Cells.Num());
+
+	const float SubCellSize = CellSize / SubCellsPerSide;
+	TArray<uint32> SubCellRanges;
+
+	for(const TPair<FIntPoint, FCellData>& Cell : Cells)
+	{
+		// Page aligned chunks map on their own pages and never drag a neighbour in with them
+		PadTo(*Ar, ChunkAlignment);
+
+		// Sorted copies, the writer's own cells stay as added
+		FCellData Data = Cell.Value;
+		SubCellRanges.Reset(GetNumSubCellRanges(SubCellsPerSide));
+		SortBySubCell(Data.ClimbSurfaces, SubCellSize, [](const FTraversalClimbSurfacePoint& Point) { return Point.Location; }, SubCellRanges);
+		SortBySubCell(Data.Ledges, SubCellSize, [](const FTraversalLedgePoint& Point) { return Point.Location; }, SubCellRanges);
+		SortBySubCell(Data.VaultPoints, SubCellSize, [](const FTraversalVaultPoint& Point) { return Point.Start; }, SubCellRanges);
+
+		FTraversalIndexChunkHeader ChunkHeader;
+		ChunkHeader.NumClimbSurfaces = Data.ClimbSurfaces.Num();
+		ChunkHeader.NumLedges = Data.Ledges.Num();
+		ChunkHeader.NumVaultPoints = Data.VaultPoints.Num();
+		ChunkHeader.SubCellsPerSide = SubCellsPerSide;
+		ChunkHeader.SubCellRangesOffset = sizeof(FTraversalIndexChunkHeader);
+		ChunkHeader.ClimbSurfacesOffset = ChunkHeader.SubCellRangesOffset + SubCellRanges.Num() * sizeof(uint32);
+		ChunkHeader.LedgesOffset = ChunkHeader.ClimbSurfacesOffset + Data.ClimbSurfaces.Num() * sizeof(FTraversalClimbSurfacePoint);
+		ChunkHeader.VaultPointsOffset = ChunkHeader.LedgesOffset + Data.Ledges.Num() * sizeof(FTraversalLedgePoint);
+
+		FTraversalIndexCellEntry& Entry = CellTable.AddDefaulted_GetRef();
+		Entry.CellX = Cell.Key.X;
+		Entry.CellY = Cell.Key.Y;
+		Entry.ChunkOffset = Ar->Tell();
+		Entry.ChunkSize = ChunkHeader.VaultPointsOffset + Data.VaultPoints.Num() * sizeof(FTraversalVaultPoint);
+
+		Ar->Serialize(&ChunkHeader, sizeof(ChunkHeader));
+		WriteArray(*Ar, SubCellRanges);
+		WriteArray(*Ar, Data.ClimbSurfaces);
+		WriteArray(*Ar, Data.Ledges);
+		WriteArray(*Ar, Data.VaultPoints);
+	}
+
+	PadTo(*Ar, alignof(FTraversalIndexCellEntry));
+	Header.CellTableOffset = Ar->Tell();
+	WriteArray(*Ar, CellTable);
+	Header.FileSize = Ar->Tell();
+
+	// The header goes last so a partially written file never validates
+	Ar->Seek(0);
+	Ar->Serialize(&Header, sizeof(Header));
+
+	return Ar->Close();
+}
+
+void TraversalIndexBaker::BakeWorld(UWorld* World, const FBox& Bounds, float SampleSpacing, const FTraversalIndexBakeParams& Params,
+	FTraversalIndexWriter& Writer)
+{
+	static constexpr float WalkableFloorZ = 0.7f;
+	/** Bisection steps placing a ledge's edge between the probe's walkable and drop traces */
+	static constexpr int32 EdgeSearchSteps = 5;
+
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TraversalIndexBake), false);
+	// Climb sweep hits resolve their grip from the physical material
+	FCollisionQueryParams SweepQueryParams = QueryParams;
+	SweepQueryParams.bReturnPhysicalMaterial = true;
+	Writer.SetGripTableHash(Params.GripTableHash);
+
+	const FCollisionShape ClimbCapsule = FCollisionShape::MakeCapsule(Params.ClimbCapsuleRadius, Params.ClimbCapsuleHalfHeight);
+
+	TSet<FIntPoint> ProbedCells;
+	TSet<FIntPoint> MovableCells;
+	FIntPoint ColumnCell;
+
+	// Anything that can move invalidates the answers of the cell it was seen from
+	auto NoteMobility = [&](const FHitResult& Hit)
+	{
+		const UPrimitiveComponent* Component = Hit.GetComponent();
+		if(Component && Component->Mobility != EComponentMobility::Static)
+		{
+			MovableCells.Add(ColumnCell);
+		}
+	};
+	auto LineTrace = [&](const FVector& Start, const FVector& End)
+	{
+		FHitResult Hit;
+		const bool bHit = World->LineTraceSingleByObjectType(Hit, Start, End, Params.ObjectQueryParams, QueryParams);
+		NoteMobility(Hit);
+		return bHit;
+	};
+
+	TArray<FHitResult> FloorHits;
+	TArray<FHitResult> SweepHits;
+	for(float X = Bounds.Min.X; X <= Bounds.Max.X; X += SampleSpacing)
+	{
+		for(float Y = Bounds.Min.Y; Y <= Bounds.Max.Y; Y += SampleSpacing)
+		{
+			ColumnCell = Writer.GetCell(FVector(X, Y, 0.f));
+
+			// Every walkable floor in the column, not just the top one. A column that hits nothing may just not be loaded
+			World->LineTraceMultiByObjectType(FloorHits, FVector(X, Y, Bounds.Max.Z), FVector(X, Y, Bounds.Min.Z), Params.ObjectQueryParams, QueryParams);
+			if(FloorHits.IsEmpty()) continue;
+			ProbedCells.Add(ColumnCell);
+
+			for(const FHitResult& FloorHit : FloorHits)
+			{
+				NoteMobility(FloorHit);
+				if(FloorHit.ImpactNormal.Z < WalkableFloorZ) continue;
+
+				const FVector Floor = FloorHit.ImpactPoint;
+				const FVector CharacterLocation = Floor + FVector::UpVector * Params.StandingHalfHeight;
+
+				for(int32 DirectionIndex = 0; DirectionIndex < NumDirections; ++DirectionIndex)
+				{
+					const float Angle = 2.f * PI * DirectionIndex / NumDirections;
+					const FVector Forward(FMath::Cos(Angle), FMath::Sin(Angle), 0.f);
+
+					// Climb: the climbable surface sweep and eye trace of CanStartClimbing
+					const FVector SweepStart = CharacterLocation + Forward * Params.ClimbSweepOffset;
+					World->SweepMultiByObjectType(SweepHits, SweepStart, SweepStart + Forward, FQuat::Identity, Params.ClimbObjectQueryParams, ClimbCapsule, SweepQueryParams);
+					for(const FHitResult& SweepHit : SweepHits)
+					{
+						NoteMobility(SweepHit);
+					}
+					if(Params.IsGrippable)
+					{
+						SweepHits.RemoveAll([&Params](const FHitResult& SweepHit) { return !Params.IsGrippable(SweepHit); });
+					}
+					if(!SweepHits.IsEmpty())
+					{
+						const FVector EyeLocation = CharacterLocation + FVector::UpVector * Params.EyeHeight;
+						FHitResult EyeHit;
+						if(World->LineTraceSingleByObjectType(EyeHit, EyeLocation, EyeLocation + Forward * Params.ClimbEyeReach, Params.ObjectQueryParams, QueryParams))
+						{
+							NoteMobility(EyeHit);
+							Writer.AddClimbSurface(EyeHit.ImpactPoint, EyeHit.ImpactNormal);
+						}
+					}
+
+					// Ledge: the walkable and drop traces of CanClimbDownLedge, then the edge between them
+					const FVector WalkableTraceStart = CharacterLocation + Forward * Params.WalkableSurfaceTraceOffset;
+					const FVector LedgeTraceStart = WalkableTraceStart + Forward * Params.LedgeTraceOffset;
+					if(LineTrace(WalkableTraceStart, WalkableTraceStart - FVector::UpVector * 100.f) &&
+						!LineTrace(LedgeTraceStart, LedgeTraceStart - FVector::UpVector * 200.f))
+					{
+						float FloorDistance = Params.WalkableSurfaceTraceOffset;
+						float DropDistance = FloorDistance + Params.LedgeTraceOffset;
+						for(int32 Step = 0; Step < EdgeSearchSteps; ++Step)
+						{
+							const float MidDistance = (FloorDistance + DropDistance) * 0.5f;
+							const FVector MidStart = CharacterLocation + Forward * MidDistance;
+							(LineTrace(MidStart, MidStart - FVector::UpVector * 100.f) ? FloorDistance : DropDistance) = MidDistance;
+						}
+						Writer.AddLedge(Floor + Forward * FloorDistance, Forward);
+					}
+
+					// Vault: the same five stepped down traces as CanStartVaulting
+					FVector VaultStart = FVector::ZeroVector;
+					FVector VaultLand = FVector::ZeroVector;
+					for(int32 Step = 0; Step < 5; ++Step)
+					{
+						const FVector Start = CharacterLocation + FVector::UpVector * 100.f + Forward * 100.f * (Step + 1);
+						const FVector End = Start - FVector::UpVector * 100.f * (Step + 1);
+						FHitResult Hit;
+						if(!World->LineTraceSingleByObjectType(Hit, Start, End, Params.ObjectQueryParams, QueryParams)) continue;
+						NoteMobility(Hit);
+
+						if(Step == 0) VaultStart = Hit.ImpactPoint;
+						if(Step == 3) VaultLand = Hit.ImpactPoint;
+					}
+
+					if(VaultStart != FVector::ZeroVector && VaultLand != FVector::ZeroVector)
+					{
+						Writer.AddVaultPoint(VaultStart, VaultLand);
+					}
+				}
+			}
+		}
+	}
+
+	// Points can land in a neighbouring cell, which only stays indexed if its own floors were probed
+	TArray<FIntPoint> WrittenCells;
+	Writer.GetCells(WrittenCells);
+	for(const FIntPoint& Cell : WrittenCells)
+	{
+		if(!ProbedCells.Contains(Cell))
+		{
+			Writer.RemoveCell(Cell);
+		}
+	}
+	for(const FIntPoint& Cell : ProbedCells)
+	{
+		if(MovableCells.Contains(Cell))
+		{
+			Writer.RemoveCell(Cell);
+		}
+		else
+		{
+			Writer.AddCell(Cell);
+		}
+	}
+}
@@ -0,0 +1,177 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/TraversalMotionData.h"
+
+#include "Animation/AnimMontage.h"
+#include "AnimNotifyState_MotionWarping.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "RootMotionModifier.h"
+#include "UObject/ObjectSaveContext.h"
+
+namespace TraversalMotionData
+{
+	static FTransform ExtractRootMotionUpTo(const UAnimMontage* Montage, float Time)
+	{
+		return Montage->ExtractRootMotionFromTrackRange(0.f, Time);
+	}
+}
+
+bool FBakedTraversalMotion::Bake()
+{
+	RootTranslation.Reset();
+	WarpWindows.Reset();
+	Duration = 0.f;
+
+	if(!Montage) return false;
+
+	Duration = Montage->GetPlayLength();
+	const int32 NumSamples = FMath::Max(2, FMath::CeilToInt(Duration * SampleRate) + 1);
+	RootTranslation.Reserve(NumSamples);
+
+	FTransform AccumulatedRootMotion = FTransform::Identity;
+	float PreviousTime = 0.f;
+	for(int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+	{
+		const float SampleTime = FMath::Min(SampleIndex / SampleRate, Duration);
+		// Same accumulation order as FRootMotionMovementParams so baked and extracted tracks agree
+		AccumulatedRootMotion = Montage->ExtractRootMotionFromTrackRange(PreviousTime, SampleTime) * AccumulatedRootMotion;
+		RootTranslation.Add(FVector3f(AccumulatedRootMotion.GetTranslation()));
+		PreviousTime = SampleTime;
+	}
+
+	for(const FAnimNotifyEvent& NotifyEvent : Montage->Notifies)
+	{
+		const UAnimNotifyState_MotionWarping* WarpNotify = Cast<UAnimNotifyState_MotionWarping>(NotifyEvent.NotifyStateClass);
+		if(!WarpNotify) continue;
+
+		const URootMotionModifier_Warp* WarpModifier = Cast<URootMotionModifier_Warp>(WarpNotify->RootMotionModifier);
+		if(!WarpModifier) continue;
+
+		FBakedTraversalWarpWindow& WarpWindow = WarpWindows.AddDefaulted_GetRef();
+		WarpWindow.WarpTargetName = WarpModifier->WarpTargetName;
+		WarpWindow.StartTime = NotifyEvent.GetTriggerTime();
+		WarpWindow.EndTime = NotifyEvent.GetEndTriggerTime();
+	}
+
+	WarpWindows.Sort([](const FBakedTraversalWarpWindow& A, const FBakedTraversalWarpWindow& B) { return A.StartTime < B.StartTime; });
+	return true;
+}
+
+FVector FBakedTraversalMotion::EvaluateTranslation(float Time) const
+{
+	if(RootTranslation.IsEmpty()) return FVector::ZeroVector;
+
+	const float SamplePosition = FMath::Clamp(Time, 0.f, Duration) * SampleRate;
+	const int32 SampleIndex = FMath::Min(FMath::FloorToInt(SamplePosition), RootTranslation.Num() - 1);
+	const int32 NextSampleIndex = FMath::Min(SampleIndex + 1, RootTranslation.Num() - 1);
+
+	return FVector(FMath::Lerp(RootTranslation[SampleIndex], RootTranslation[NextSampleIndex], SamplePosition - SampleIndex));
+}
+
+const FBakedTraversalMotion* UTraversalMotionData::FindMotion(const UAnimMontage* Montage, int32* OutIndex) const
+{
+	const int32 MotionIndex = BakedMotions.IndexOfByPredicate([Montage](const FBakedTraversalMotion& Motion)
+	{
+		return Motion.Montage == Montage && Motion.IsBaked();
+	});
+
+	if(OutIndex)
+	{
+		*OutIndex = MotionIndex;
+	}
+	return MotionIndex != INDEX_NONE ? &BakedMotions[MotionIndex] : nullptr;
+}
+
+void UTraversalMotionData::BakeMotions()
+{
+	for(FBakedTraversalMotion& Motion : BakedMotions)
+	{
+		if(!Motion.Bake())
+		{
+			UE_LOG(LogClimbing, Warning, TEXT("%s: traversal motion without a montage was not baked"), *GetName());
+		}
+	}
+
+	MarkPackageDirty();
+}
+
+float UTraversalMotionData::ValidateAgainstMontages(float Tolerance, TArray<FString>& OutErrors) const
+{
+	float WorstError = 0.f;
+
+	for(const FBakedTraversalMotion& Motion : BakedMotions)
+	{
+		if(!Motion.Montage || !Motion.IsBaked())
+		{
+			OutErrors.Add(FString::Printf(TEXT("%s: motion for %s is not baked"), *GetName(), *GetNameSafe(Motion.Montage)));
+			continue;
+		}
+
+		// Check between samples as well, that is where interpolation error shows up
+		const int32 NumChecks = FMath::CeilToInt(Motion.Duration * Motion.SampleRate * 4.f);
+		for(int32 CheckIndex = 0; CheckIndex <= NumChecks; ++CheckIndex)
+		{
+			const float CheckTime = Motion.Duration * CheckIndex / FMath::Max(NumChecks, 1);
+			const FVector Expected = TraversalMotionData::ExtractRootMotionUpTo(Motion.Montage, CheckTime).GetTranslation();
+			const float Error = FVector::Dist(Expected, Motion.EvaluateTranslation(CheckTime));
+
+			WorstError = FMath::Max(WorstError, Error);
+			if(Error > Tolerance)
+			{
+				OutErrors.Add(FString::Printf(TEXT("%s: %s diverges by %.2f cm at %.3f s"),
+					*GetName(), *Motion.Montage->GetName(), Error, CheckTime));
+				break;
+			}
+		}
+	}
+
+	return WorstError;
+}
+
+FVector UTraversalMotionData::PredictMontageEndLocation(const UAnimMontage* Montage, const FVector& StartLocation,
+	const FQuat& StartBasis, const TMap<FName, FVector>& WarpTargets, float RootHeightOffset)
+{
+	if(!Montage) return StartLocation;
+
+	const float Duration = Montage->GetPlayLength();
+	const FVector EndTranslation = TraversalMotionData::ExtractRootMotionUpTo(Montage, Duration).GetTranslation();
+
+	// Each warp window ends on its target, so only the root motion after the last one that found a target adds on
+	float LastWarpEndTime = -1.f;
+	FVector LastWarpTarget = FVector::ZeroVector;
+	for(const FAnimNotifyEvent& NotifyEvent : Montage->Notifies)
+	{
+		const UAnimNotifyState_MotionWarping* WarpNotify = Cast<UAnimNotifyState_MotionWarping>(NotifyEvent.NotifyStateClass);
+		const URootMotionModifier_Warp* WarpModifier = WarpNotify ? Cast<URootMotionModifier_Warp>(WarpNotify->RootMotionModifier) : nullptr;
+		const FVector* WarpTarget = WarpModifier ? WarpTargets.Find(WarpModifier->WarpTargetName) : nullptr;
+		if(!WarpTarget || NotifyEvent.GetEndTriggerTime() <= LastWarpEndTime) continue;
+
+		LastWarpEndTime = NotifyEvent.GetEndTriggerTime();
+		LastWarpTarget = *WarpTarget + FVector::UpVector * RootHeightOffset;
+	}
+
+	if(LastWarpEndTime < 0.f)
+	{
+		return StartLocation + StartBasis.RotateVector(EndTranslation);
+	}
+
+	const FVector WarpEndTranslation = TraversalMotionData::ExtractRootMotionUpTo(Montage, LastWarpEndTime).GetTranslation();
+	return LastWarpTarget + StartBasis.RotateVector(EndTranslation - WarpEndTranslation);
+}
+
+#if WITH_EDITOR
+void UTraversalMotionData::PreSave(FObjectPreSaveContext SaveContext)
+{
+	// Cooked builds always carry curves that match the montages they ship with
+	if(SaveContext.IsCooking())
+	{
+		for(FBakedTraversalMotion& Motion : BakedMotions)
+		{
+			Motion.Bake();
+		}
+	}
+
+	Super::PreSave(SaveContext);
+}
+#endif
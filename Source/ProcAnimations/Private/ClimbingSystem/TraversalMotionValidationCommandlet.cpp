@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/TraversalMotionValidationCommandlet.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "ClimbingSystem/TraversalMotionData.h"
+
+UTraversalMotionValidationCommandlet::UTraversalMotionValidationCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTraversalMotionValidationCommandlet::Main(const FString& Params)
+{
+	float Tolerance = 1.f;
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+	const bool bRebake = FParse::Param(*Params, TEXT("Rebake"));
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> MotionDataAssets;
+	AssetRegistry.GetAssetsByClass(UTraversalMotionData::StaticClass()->GetClassPathName(), MotionDataAssets, true);
+
+	int32 NumFailures = 0;
+	for(const FAssetData& AssetData : MotionDataAssets)
+	{
+		UTraversalMotionData* MotionData = Cast<UTraversalMotionData>(AssetData.GetAsset());
+		if(!MotionData) continue;
+
+		// Rebaking checks the baking itself, without it the saved curves are checked against the current montages
+		if(bRebake)
+		{
+			MotionData->BakeMotions();
+		}
+
+		TArray<FString> Errors;
+		const float WorstError = MotionData->ValidateAgainstMontages(Tolerance, Errors);
+
+		UE_LOG(LogClimbing, Display, TEXT("%s: worst trajectory error %.3f cm"), *AssetData.GetObjectPathString(), WorstError);
+		for(const FString& Error : Errors)
+		{
+			UE_LOG(LogClimbing, Error, TEXT("%s"), *Error);
+		}
+		NumFailures += Errors.Num();
+	}
+
+	UE_LOG(LogClimbing, Display, TEXT("Validated %d traversal motion assets, %d failures"), MotionDataAssets.Num(), NumFailures);
+	return NumFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/TraversalQueryCoalescer.h"
+
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingMemory.h"
+#include "ClimbingSystem/ClimbingStats.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+
+bool UTraversalQueryCoalescer::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UTraversalQueryCoalescer::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTraversalQueryCoalescer, STATGROUP_Climbing);
+}
+
+void UTraversalQueryCoalescer::Tick(float DeltaTime)
+{
+	LLM_SCOPE_BYTAG(Climbing_Queries);
+
+	// A shared probe that reached a primitive still ran its narrowphase, only the broadphase was shared
+	LastFrameQueriesSaved = FMath::Max(0, SkippedQueries - GatherQueries);
+
+	SET_DWORD_STAT(STAT_Coalescer_AgentQueries, AgentQueries);
+	SET_DWORD_STAT(STAT_Coalescer_SceneQueries, SceneQueries);
+	SET_DWORD_STAT(STAT_Coalescer_NarrowphaseQueries, NarrowphaseQueries);
+	SET_DWORD_STAT(STAT_Coalescer_QueriesSaved, LastFrameQueriesSaved);
+
+	AgentQueries = 0;
+	SceneQueries = 0;
+	GatherQueries = 0;
+	NarrowphaseQueries = 0;
+	SkippedQueries = 0;
+
+	// Cells nobody probed for a whole frame are forgotten, the rest start the next frame with fresh primitives
+	for(auto It = CellBuckets.CreateIterator(); It; ++It)
+	{
+		FCellBucket& Bucket = It.Value();
+		if(Bucket.Requesters.IsEmpty() && Bucket.LastFrameRequesterCount == 0)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		Bucket.LastFrameRequesterCount = Bucket.Requesters.Num();
+		Bucket.Requesters.Reset();
+		Bucket.Primitives.Reset();
+		Bucket.bPrimitivesGathered = false;
+	}
+}
+
+UTraversalQueryCoalescer::FCellBucket* UTraversalQueryCoalescer::FindCoalescedBucket(const void* Requester,
+	const FBox& QueryBounds, const FCollisionObjectQueryParams& ObjectQueryParams)
+{
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	if(!Settings->bCoalesceTraversalQueries) return nullptr;
+
+	const float CellSize = Settings->CoalescingCellSize;
+	const FVector QueryCenter = QueryBounds.GetCenter();
+	const FCellKey Key{FIntVector(
+		FMath::FloorToInt(QueryCenter.X / CellSize),
+		FMath::FloorToInt(QueryCenter.Y / CellSize),
+		FMath::FloorToInt(QueryCenter.Z / CellSize)),
+		ObjectQueryParams.GetQueryBitfield()};
+
+	// The gathered primitives only cover the cell plus its margin, longer probes go to the scene
+	const FVector CellMin = FVector(Key.Cell) * CellSize;
+	const FBox CellBounds = FBox(CellMin, CellMin + FVector(CellSize)).ExpandBy(Settings->CoalescingCellMargin);
+	if(!CellBounds.IsInside(QueryBounds)) return nullptr;
+
+	FCellBucket& Bucket = CellBuckets.FindOrAdd(Key);
+	Bucket.Requesters.AddUnique(Requester);
+
+	// A lone agent gains nothing from sharing
+	if(Bucket.LastFrameRequesterCount < 2) return nullptr;
+
+	if(!Bucket.bPrimitivesGathered)
+	{
+		GatherCellPrimitives(Key, Bucket, ObjectQueryParams);
+	}
+	return &Bucket;
+}
+
+void UTraversalQueryCoalescer::GatherCellPrimitives(const FCellKey& Key, FCellBucket& Bucket,
+	const FCollisionObjectQueryParams& ObjectQueryParams)
+{
+	const UClimbingSettings* Settings = UClimbingSettings::Get();
+	const float CellSize = Settings->CoalescingCellSize;
+	const FVector CellCenter = (FVector(Key.Cell) + FVector(0.5f)) * CellSize;
+	const FVector CellHalfExtent = FVector(CellSize * 0.5f + Settings->CoalescingCellMargin);
+
+	TArray<FOverlapResult> Overlaps;
+	GetWorld()->OverlapMultiByObjectType(Overlaps, CellCenter, FQuat::Identity, ObjectQueryParams,
+		FCollisionShape::MakeBox(CellHalfExtent), FCollisionQueryParams(SCENE_QUERY_STAT(TraversalCoalescedGather), false));
+	++SceneQueries;
+	++GatherQueries;
+
+	for(const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* Primitive = Overlap.GetComponent();
+		if(!Primitive || Bucket.Primitives.ContainsByPredicate([Primitive](const FCellPrimitive& Cached) { return Cached.Primitive == Primitive; })) continue;
+
+		Bucket.Primitives.Add({Primitive, Primitive->Bounds.GetBox()});
+	}
+
+	Bucket.bPrimitivesGathered = true;
+}
+
+bool UTraversalQueryCoalescer::LineTraceSingle(const void* Requester, FHitResult& OutHit, const FVector& Start,
+	const FVector& End, const FCollisionObjectQueryParams& ObjectQueryParams)
+{
+	++AgentQueries;
+	OutHit = FHitResult(Start, End);
+
+	const FBox QueryBounds = FBox(Start.ComponentMin(End), Start.ComponentMax(End));
+	FCellBucket* Bucket = FindCoalescedBucket(Requester, QueryBounds, ObjectQueryParams);
+
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TraversalLineTrace), false);
+	if(!Bucket)
+	{
+		++SceneQueries;
+		return GetWorld()->LineTraceSingleByObjectType(OutHit, Start, End, ObjectQueryParams, QueryParams);
+	}
+
+	const FVector Direction = End - Start;
+	const FVector OneOverDirection = Direction.Reciprocal();
+
+	bool bHit = false;
+	const int32 StartNarrowphaseQueries = NarrowphaseQueries;
+	for(const FCellPrimitive& CellPrimitive : Bucket->Primitives)
+	{
+		UPrimitiveComponent* Primitive = CellPrimitive.Primitive.Get();
+		if(!Primitive || !FMath::LineBoxIntersection(CellPrimitive.Bounds, Start, End, Direction, OneOverDirection)) continue;
+
+		++NarrowphaseQueries;
+		FHitResult PrimitiveHit;
+		if(Primitive->LineTraceComponent(PrimitiveHit, Start, End, QueryParams) && (!bHit || PrimitiveHit.Time < OutHit.Time))
+		{
+			OutHit = PrimitiveHit;
+			bHit = true;
+		}
+	}
+
+	if(NarrowphaseQueries == StartNarrowphaseQueries)
+	{
+		++SkippedQueries;
+	}
+	return bHit;
+}
+
+void UTraversalQueryCoalescer::CapsuleSweepMulti(const void* Requester, TArray<FHitResult>& OutHits, const FVector& Start,
+	const FVector& End, float Radius, float HalfHeight, const FCollisionObjectQueryParams& ObjectQueryParams)
+{
+	++AgentQueries;
+	OutHits.Reset();
+
+	const FVector CapsuleExtent(Radius, Radius, HalfHeight);
+	const FBox QueryBounds = FBox(Start.ComponentMin(End) - CapsuleExtent, Start.ComponentMax(End) + CapsuleExtent);
+	FCellBucket* Bucket = FindCoalescedBucket(Requester, QueryBounds, ObjectQueryParams);
+
+	const FCollisionShape CapsuleShape = FCollisionShape::MakeCapsule(Radius, HalfHeight);
+	// Climb sweep hits resolve their grip from the physical material
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TraversalCapsuleSweep), false);
+	QueryParams.bReturnPhysicalMaterial = true;
+	if(!Bucket)
+	{
+		++SceneQueries;
+		GetWorld()->SweepMultiByObjectType(OutHits, Start, End, FQuat::Identity, ObjectQueryParams, CapsuleShape, QueryParams);
+		return;
+	}
+
+	const int32 StartNarrowphaseQueries = NarrowphaseQueries;
+	for(const FCellPrimitive& CellPrimitive : Bucket->Primitives)
+	{
+		UPrimitiveComponent* Primitive = CellPrimitive.Primitive.Get();
+		if(!Primitive || !CellPrimitive.Bounds.Intersect(QueryBounds)) continue;
+
+		++NarrowphaseQueries;
+		FHitResult PrimitiveHit;
+		if(Primitive->SweepComponent(PrimitiveHit, Start, End, FQuat::Identity, CapsuleShape, false))
+		{
+			OutHits.Add(PrimitiveHit);
+		}
+	}
+
+	if(NarrowphaseQueries == StartNarrowphaseQueries)
+	{
+		++SkippedQueries;
+	}
+	OutHits.Sort([](const FHitResult& A, const FHitResult& B) { return A.Time < B.Time; });
+}
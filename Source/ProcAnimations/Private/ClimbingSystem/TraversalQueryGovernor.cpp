@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbingSystem/TraversalQueryGovernor.h"
+
+#include "ClimbingSystem/ClimbingSettings.h"
+#include "ClimbingSystem/ClimbingStats.h"
+
+void UTraversalQueryGovernor::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	ResetFrameBudget();
+}
+
+bool UTraversalQueryGovernor::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UTraversalQueryGovernor::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTraversalQueryGovernor, STATGROUP_Climbing);
+}
+
+void UTraversalQueryGovernor::Tick(float DeltaTime)
+{
+	LastFrameStats = CurrentFrameStats;
+	CurrentFrameStats = FTraversalQueryGovernorStats();
+
+	SET_DWORD_STAT(STAT_TraversalQueries_Served, LastFrameStats.Served);
+	SET_DWORD_STAT(STAT_TraversalQueries_Deferred, LastFrameStats.Deferred);
+	SET_DWORD_STAT(STAT_TraversalQueries_Dropped, LastFrameStats.Dropped);
+	SET_DWORD_STAT(STAT_TraversalQueries_Traces, LastFrameStats.TracesSpent);
+
+	ResetFrameBudget();
+}
+
+void UTraversalQueryGovernor::ResetFrameBudget()
+{
+	// Reserve for each tier what it asked for last frame, highest priority first. The lowest tier gets the rest
+	int32 Remaining = UClimbingSettings::Get()->MaxTraversalQueriesPerFrame;
+	for(uint8 Tier = 0; Tier < (uint8)ETraversalQueryPriority::Num; ++Tier)
+	{
+		const bool bLastTier = Tier == (uint8)ETraversalQueryPriority::Num - 1;
+		Allowance[Tier] = bLastTier ? Remaining : FMath::Min(Remaining, Demand[Tier]);
+		Remaining -= Allowance[Tier];
+		Demand[Tier] = 0;
+	}
+}
+
+ETraversalQueryDecision UTraversalQueryGovernor::RequestQuery(ETraversalQueryPriority Priority, int32 TraceCost,
+	FTraversalProbeCache& Cache)
+{
+	const uint8 RequestTier = (uint8)Priority;
+	Demand[RequestTier] += TraceCost;
+
+	// Borrow from our own tier first, then from lower priority tiers
+	for(uint8 Tier = RequestTier; Tier < (uint8)ETraversalQueryPriority::Num; ++Tier)
+	{
+		if(Allowance[Tier] < TraceCost) continue;
+
+		Allowance[Tier] -= TraceCost;
+		++CurrentFrameStats.Served;
+		CurrentFrameStats.TracesSpent += TraceCost;
+		return ETraversalQueryDecision::Serve;
+	}
+
+	const int32 MaxStaleFrames = UClimbingSettings::Get()->MaxTraversalProbeStaleFrames;
+	if(Cache.bHasResult && Cache.StaleFrames < MaxStaleFrames)
+	{
+		++Cache.StaleFrames;
+		++CurrentFrameStats.Deferred;
+		return ETraversalQueryDecision::Defer;
+	}
+
+	// The local player never loses a probe outright, it runs over budget instead
+	if(Priority == ETraversalQueryPriority::LocallyControlled)
+	{
+		++CurrentFrameStats.Served;
+		CurrentFrameStats.TracesSpent += TraceCost;
+		return ETraversalQueryDecision::Serve;
+	}
+
+	++CurrentFrameStats.Dropped;
+	return ETraversalQueryDecision::Drop;
+}
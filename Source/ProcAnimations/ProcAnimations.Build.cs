@@ -10,7 +10,7 @@ public class ProcAnimations : ModuleRules
 	
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput" });
 
-		PrivateDependencyModuleNames.AddRange(new string[] { "MotionWarping" });
+		PrivateDependencyModuleNames.AddRange(new string[] { "MotionWarping", "DeveloperSettings", "AssetRegistry", "AnimationBudgetAllocator", "AIModule", "GameplayTasks", "PhysicsCore", "ImageWrapper" });
 
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
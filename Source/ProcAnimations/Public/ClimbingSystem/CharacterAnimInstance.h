@@ -27,6 +27,12 @@ private:
 	UPROPERTY()
 	UCustomMovementComponent* CustomMovementComponent;
 
+	/** Set on dedicated servers, where nothing reads the anim graph variables */
+	bool bSkipGraphVariableUpdate = false;
+
+	/** Closes the pending climb input once its traversal montage has advanced past its first frame */
+	void ResolveMontageInputLatency();
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Reference", meta= (AllowPrivateAccess = true))
 	float GroundSpeed;
 	void GetGroundSpeed();
@@ -47,7 +53,31 @@ private:
 	bool bIsClimbing;
 	void GetIsClimbing();
 
+	/** Holding a ledge edge, bIsClimbing stays set so graphs without a hang state fall back to climbing */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Reference", meta= (AllowPrivateAccess = true))
+	bool bIsHanging;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Reference", meta= (AllowPrivateAccess = true))
+	bool bIsWallRunning;
+	void GetIsWallRunning();
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Reference", meta= (AllowPrivateAccess = true))
 	FVector ClimbVelocity;
 	void GetClimbVelocity();
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Climb IK", meta= (AllowPrivateAccess = true))
+	float ClimbIKAlpha;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Climb IK", meta= (AllowPrivateAccess = true))
+	FVector LeftHandIKLocation;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Climb IK", meta= (AllowPrivateAccess = true))
+	FVector RightHandIKLocation;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Climb IK", meta= (AllowPrivateAccess = true))
+	FVector LeftFootIKLocation;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Climb IK", meta= (AllowPrivateAccess = true))
+	FVector RightFootIKLocation;
+	void GetClimbIKTargets();
 };
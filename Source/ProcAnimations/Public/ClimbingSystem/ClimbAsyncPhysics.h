@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeLock.h"
+#include "ClimbingSystem/ClimbMath.h"
+
+/** Game thread snapshot the async physics climb step consumes */
+struct FClimbAsyncInput
+{
+	uint32 Frame = 0;
+	bool bClimbing = false;
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector Velocity = FVector::ZeroVector;
+	FVector Acceleration = FVector::ZeroVector;
+	FVector SurfaceLocation = FVector::ZeroVector;
+	FVector SurfaceNormal = FVector::ZeroVector;
+	float MaxSpeed = 0.f;
+	/** Max speed scaled by the analog input modifier, as CalcVelocity uses it */
+	float MaxInputSpeed = 0.f;
+	float BrakingDeceleration = 0.f;
+	float RotationInterpSpeed = 5.f;
+};
+
+/** Result of the latest async physics climb step, read back on the game thread */
+struct FClimbAsyncOutput
+{
+	uint32 InputFrame = 0;
+	float SimTime = 0.f;
+	FVector Velocity = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector SnapVelocity = FVector::ZeroVector;
+	/** Physics steps integrated since InputFrame was taken, 1 for the step straight off the game thread snapshot */
+	uint32 StepsSinceInput = 0;
+};
+
+/**
+ * Two slot state handoff between the game and physics threads.
+ * The writer fills the back slot and flips, the reader copies the front slot, so the lock only covers one copy.
+ * Peek leaves the state in place for a reader that keeps using the latest snapshot, Consume takes it exactly once.
+ */
+template<typename StateType>
+class TClimbStateDoubleBuffer
+{
+public:
+	void Publish(const StateType& State)
+	{
+		FScopeLock Lock(&SwapLock);
+		const int32 BackIndex = 1 - FrontIndex;
+		Buffers[BackIndex] = State;
+		FrontIndex = BackIndex;
+		bHasState = true;
+	}
+
+	bool Peek(StateType& OutState) const
+	{
+		FScopeLock Lock(&SwapLock);
+		if(!bHasState) return false;
+
+		OutState = Buffers[FrontIndex];
+		return true;
+	}
+
+	bool Consume(StateType& OutState)
+	{
+		FScopeLock Lock(&SwapLock);
+		if(!bHasState) return false;
+
+		OutState = Buffers[FrontIndex];
+		bHasState = false;
+		return true;
+	}
+
+	void Reset()
+	{
+		FScopeLock Lock(&SwapLock);
+		bHasState = false;
+	}
+
+private:
+	StateType Buffers[2];
+	int32 FrontIndex = 0;
+	bool bHasState = false;
+	mutable FCriticalSection SwapLock;
+};
+
+namespace ClimbAsyncPhysics
+{
+	/** UCharacterMovementComponent::BRAKE_TO_STOP_VELOCITY */
+	static constexpr float BrakeToStopVelocity = 10.f;
+	/** The over max speed margin UCharacterMovementComponent::IsExceedingMaxSpeed allows */
+	static constexpr float OverVelocityPercent = 1.01f;
+
+	/**
+	 * One fixed rate climb step: CalcVelocity with zero friction in fluid mode, then climb rotation and surface snap.
+	 * Mirrors the game thread PhysClimb so the two paths can be compared for parity.
+	 */
+	FORCEINLINE void SimulateClimbStep(const FClimbAsyncInput& Input, const FVector& Velocity, const FQuat& Rotation,
+		float DeltaTime, FClimbAsyncOutput& Output)
+	{
+		FVector NewVelocity = Velocity;
+		const FVector& Acceleration = Input.Acceleration;
+		const bool bZeroAcceleration = Acceleration.IsNearlyZero();
+		const bool bVelocityOverMax = NewVelocity.SizeSquared() > FMath::Square(Input.MaxSpeed) * OverVelocityPercent;
+
+		if(bZeroAcceleration || bVelocityOverMax)
+		{
+			// Braking without friction: decelerate along the current velocity, never reverse it and stop once slow enough
+			const FVector OldVelocity = NewVelocity;
+			NewVelocity += -Input.BrakingDeceleration * NewVelocity.GetSafeNormal() * DeltaTime;
+			const float BrakeToStopSpeed = Input.BrakingDeceleration > 0.f ? BrakeToStopVelocity : 0.f;
+			if((NewVelocity | OldVelocity) <= 0.f || NewVelocity.SizeSquared() <= FMath::Max(KINDA_SMALL_NUMBER, FMath::Square(BrakeToStopSpeed)))
+			{
+				NewVelocity = FVector::ZeroVector;
+			}
+
+			if(bVelocityOverMax && NewVelocity.SizeSquared() < FMath::Square(Input.MaxSpeed) && (Acceleration | OldVelocity) > 0.f)
+			{
+				NewVelocity = OldVelocity.GetSafeNormal() * Input.MaxSpeed;
+			}
+		}
+
+		if(!bZeroAcceleration)
+		{
+			const bool bVelocityOverMaxInput = NewVelocity.SizeSquared() > FMath::Square(Input.MaxInputSpeed) * OverVelocityPercent;
+			const float MaxInputSpeed = bVelocityOverMaxInput ? NewVelocity.Size() : Input.MaxInputSpeed;
+			NewVelocity += Acceleration * DeltaTime;
+			NewVelocity = NewVelocity.GetClampedToMaxSize(MaxInputSpeed);
+		}
+
+		Output.Velocity = NewVelocity;
+		Output.Rotation = ClimbMath::ComputeClimbRotation(Rotation, Input.SurfaceNormal, DeltaTime, Input.RotationInterpSpeed);
+		Output.SnapVelocity = ClimbMath::ComputeSnapVector(Input.Location, Rotation.GetForwardVector(),
+			Input.SurfaceLocation, Input.SurfaceNormal) * Input.MaxSpeed;
+		Output.InputFrame = Input.Frame;
+	}
+}
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+enum class EClimbFlightEventType : uint8
+{
+	/** Value: game frame time in ms */
+	Frame,
+	/** Value: PhysClimb time in ms */
+	ClimbTick,
+	/** Arg: 0 capsule sweep, 1 line trace. Value: hit count */
+	Trace,
+	/** Arg: new movement mode. Value: new custom mode */
+	MovementModeChanged,
+	/** Arg: new ETraversalState */
+	TraversalStateChanged,
+	/** Arg: 1 started, 0 blended out, 2 interrupted. Subject: the montage */
+	MontageEvent,
+	/** Arg: bEnableClimb. Value: traversal state when requested */
+	ToggleClimbing,
+	Num
+};
+
+/** One fixed size record, written to hitch dumps as is */
+struct FClimbFlightEvent
+{
+	uint64 Cycles = 0;
+	uint32 FrameNumber = 0;
+	uint32 AgentId = 0;
+	uint32 SubjectId = 0;
+	EClimbFlightEventType Type = EClimbFlightEventType::Frame;
+	uint8 Arg = 0;
+	uint16 Padding = 0;
+	float Value = 0.f;
+	uint32 Padding2 = 0;
+};
+static_assert(sizeof(FClimbFlightEvent) == 32, "Flight events are dumped raw, keep the layout stable");
+
+/** Header of a .cfr hitch dump, followed by the object name table and the events */
+struct FClimbFlightDumpHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x52464C43; // "CLFR"
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = CurrentVersion;
+	double SecondsPerCycle = 0.0;
+	uint64 TriggerCycles = 0;
+	float TriggerFrameMs = 0.f;
+	uint32 NumAgents = 0;
+	uint32 NumEvents = 0;
+	uint32 Padding = 0;
+};
+
+/**
+ * Always on, fixed size ring buffer of climbing events.
+ * Writers claim a slot with one atomic increment and publish it with its sequence number, so recording never locks.
+ */
+class PROCANIMATIONS_API FClimbFlightRecorder
+{
+public:
+	static constexpr uint32 Capacity = 1 << 16;
+
+	static FClimbFlightRecorder& Get();
+
+	void Record(EClimbFlightEventType Type, const UObject* Agent, uint8 Arg = 0, float Value = 0.f, const UObject* Subject = nullptr);
+
+	/** Writes every event from the last Seconds to a .cfr file in the background, returns the file path */
+	FString DumpToFile(double Seconds, float TriggerFrameMs) const;
+
+	static const TCHAR* GetEventTypeName(EClimbFlightEventType Type);
+
+	bool bEnabled = true;
+
+private:
+	FClimbFlightRecorder();
+
+	struct FSlot
+	{
+		std::atomic<uint64> Sequence{0};
+		FClimbFlightEvent Event;
+	};
+
+	TUniquePtr<FSlot[]> Slots;
+	std::atomic<uint64> WriteIndex{0};
+};
+
+/** Times the enclosing scope into a flight recorder event */
+struct FClimbFlightScopeTimer
+{
+	FClimbFlightScopeTimer(EClimbFlightEventType InType, const UObject* InAgent)
+		: Type(InType), Agent(InAgent), StartCycles(FPlatformTime::Cycles64())
+	{
+	}
+
+	~FClimbFlightScopeTimer()
+	{
+		const float Ms = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+		FClimbFlightRecorder::Get().Record(Type, Agent, 0, Ms);
+	}
+
+	EClimbFlightEventType Type;
+	const UObject* Agent;
+	uint64 StartCycles;
+};
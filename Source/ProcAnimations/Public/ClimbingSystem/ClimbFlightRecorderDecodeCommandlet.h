@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbFlightRecorderDecodeCommandlet.generated.h"
+
+/**
+ * Turns a .cfr flight recorder dump into a readable timeline, times relative to the hitch.
+ * UnrealEditor-Cmd ProcAnimations -run=ClimbFlightRecorderDecode -File=Path [-Out=Path]
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbFlightRecorderDecodeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbFlightRecorderDecodeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbFlightRecorderSubsystem.generated.h"
+
+/**
+ * Feeds frame times into the climbing flight recorder and dumps the recent history when a frame hitches.
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbFlightRecorderSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	double LastDumpTime = -DBL_MAX;
+};
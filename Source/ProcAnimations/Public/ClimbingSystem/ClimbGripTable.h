@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ClimbingSystem/ClimbMath.h"
+#include "ClimbGripTable.generated.h"
+
+class UPhysicalMaterial;
+
+/** How a climber holds on to one kind of surface */
+USTRUCT(BlueprintType)
+struct PROCANIMATIONS_API FClimbGrip
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grip")
+	bool bClimbable = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grip", meta = (ClampMin = 0.f))
+	float MaxClimbSpeed = 100.f;
+
+	/** Climbing stops on surfaces whose normal is within this angle of up */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grip", meta = (ClampMin = 0.f, ClampMax = 90.f))
+	float StopClimbSlopeAngle = 60.f;
+
+	/** Overhangs whose normal is further than this from up cannot be held, 180 holds any overhang */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grip", meta = (ClampMin = 90.f, ClampMax = 180.f))
+	float MaxOverhangAngle = 180.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grip", meta = (ClampMin = 0.f))
+	float StaminaCostPerSecond = 0.f;
+
+	/** Cosines of the slope limits, so the per tick test needs no trig */
+	float StopClimbSlopeCos = ClimbMath::DefaultStopClimbSlopeCos;
+	float MaxOverhangCos = -1.f;
+
+	void CacheSlopeLimits()
+	{
+		StopClimbSlopeCos = FMath::Cos(FMath::DegreesToRadians(StopClimbSlopeAngle));
+		MaxOverhangCos = FMath::Cos(FMath::DegreesToRadians(MaxOverhangAngle));
+	}
+
+	FORCEINLINE bool IsOutsideSlopeLimits(const FVector& SurfaceNormal) const
+	{
+		return ClimbMath::IsSlopeTooFlatToClimb(SurfaceNormal, StopClimbSlopeCos) || SurfaceNormal.Z < MaxOverhangCos;
+	}
+};
+
+USTRUCT()
+struct FClimbGripEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Grip")
+	TObjectPtr<UPhysicalMaterial> PhysicalMaterial;
+
+	UPROPERTY(EditAnywhere, Category = "Grip")
+	FClimbGrip Grip;
+};
+
+/**
+ * Per physical material climbing behaviour, looked up from the material of each climb sweep hit.
+ * Surfaces without an entry, or without a physical material, use DefaultGrip.
+ */
+UCLASS(BlueprintType)
+class PROCANIMATIONS_API UClimbGripTable : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** Constant time, the entries are hashed by material when the table loads */
+	const FClimbGrip& FindGrip(const UPhysicalMaterial* PhysicalMaterial) const;
+
+	/** Fastest climb speed of any grip, for the server side move checks */
+	float GetMaxClimbSpeed() const;
+
+	/** Hash of the default grip and every entry's material and grip, changes whenever what the table answers does. Never 0 */
+	FORCEINLINE uint32 GetContentHash() const { return ContentHash; }
+
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	void BuildGripLookup();
+
+	UPROPERTY(EditAnywhere, Category = "Grip")
+	FClimbGrip DefaultGrip;
+
+	UPROPERTY(EditAnywhere, Category = "Grip")
+	TArray<FClimbGripEntry> Entries;
+
+	TMap<const UPhysicalMaterial*, int32> GripLookup;
+	uint32 ContentHash = 1;
+};
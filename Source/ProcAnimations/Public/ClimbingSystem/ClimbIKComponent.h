@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "WorldCollision.h"
+#include "ClimbIKComponent.generated.h"
+
+class AClimbingCharacter;
+class UCustomMovementComponent;
+
+UENUM(BlueprintType)
+enum class EClimbLimb : uint8
+{
+	LeftHand,
+	RightHand,
+	LeftFoot,
+	RightFoot,
+	Num UMETA(Hidden)
+};
+
+USTRUCT()
+struct FClimbLimbIKState
+{
+	GENERATED_BODY()
+
+	FVector TargetLocation = FVector::ZeroVector;
+	FVector EffectorLocation = FVector::ZeroVector;
+	bool bHasTarget = false;
+};
+
+/**
+ * Places hands and feet on the climbed surface. Placement traces are batched as async traces and
+ * scheduled by UClimbIKSubsystem so the whole world stays inside one per frame trace budget.
+ */
+UCLASS(ClassGroup = (Climbing), meta = (BlueprintSpawnableComponent))
+class PROCANIMATIONS_API UClimbIKComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UClimbIKComponent();
+
+	/** Called by the subsystem when this climber is due. Returns the number of scene traces issued */
+	int32 RefreshLimbTargets(int32 TraceBudget);
+
+	void SetIKDegraded(bool bInDegraded) { bIKDegraded = bInDegraded; }
+	bool WantsIK() const;
+
+	FORCEINLINE float GetIKAlpha() const { return IKAlpha; }
+	FORCEINLINE FVector GetLimbEffectorLocation(EClimbLimb Limb) const { return Limbs[(uint8)Limb].EffectorLocation; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	FVector GetLimbBoneLocation(EClimbLimb Limb) const;
+	bool TryReuseSurfaceHit(const FVector& LimbLocation, FVector& OutTargetLocation) const;
+	void OnLimbTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	UPROPERTY()
+	AClimbingCharacter* OwningClimbingCharacter;
+
+	UPROPERTY()
+	UCustomMovementComponent* CustomMovementComponent;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Climbing: IK", meta= (AllowPrivateAccess = true))
+	FName LeftHandBone = TEXT("hand_l");
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Climbing: IK", meta= (AllowPrivateAccess = true))
+	FName RightHandBone = TEXT("hand_r");
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Climbing: IK", meta= (AllowPrivateAccess = true))
+	FName LeftFootBone = TEXT("foot_l");
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Climbing: IK", meta= (AllowPrivateAccess = true))
+	FName RightFootBone = TEXT("foot_r");
+
+	/** How far off the wall the limb trace starts */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Climbing: IK", meta= (AllowPrivateAccess = true))
+	float LimbTraceOutset = 30.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Climbing: IK", meta= (AllowPrivateAccess = true))
+	float LimbTraceDepth = 60.f;
+
+	/** A climb capsule hit this close to a limb is used instead of tracing for it */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Climbing: IK", meta= (AllowPrivateAccess = true))
+	float SurfaceHitReuseRadius = 25.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Climbing: IK", meta= (AllowPrivateAccess = true))
+	float EffectorInterpSpeed = 15.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Climbing: IK", meta= (AllowPrivateAccess = true))
+	float AlphaInterpSpeed = 6.f;
+
+	FClimbLimbIKState Limbs[(uint8)EClimbLimb::Num];
+	FTraceDelegate LimbTraceDelegate;
+	uint32 TraceGeneration = 0;
+	float IKAlpha = 0.f;
+	bool bIKDegraded = true;
+};
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbIKSubsystem.generated.h"
+
+class UClimbIKComponent;
+
+/**
+ * Owns the global per frame budget for climb IK limb traces.
+ * Climbers update less often with distance, each on its own fixed phase, and lose IK entirely past IKMaxDistance.
+ * Within the budget the most overdue are served first, then the nearest.
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbIKSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterClimber(UClimbIKComponent* Climber);
+	void UnregisterClimber(UClimbIKComponent* Climber);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void GatherViewLocations(TArray<FVector>& OutViewLocations) const;
+	int32 GetUpdateInterval(float DistanceSq) const;
+
+	TArray<TWeakObjectPtr<UClimbIKComponent>> Climbers;
+	/** FrameCounter of each climber's last refresh that had trace budget */
+	TMap<TWeakObjectPtr<UClimbIKComponent>, uint32> LastRefreshFrames;
+	uint32 FrameCounter = 0;
+};
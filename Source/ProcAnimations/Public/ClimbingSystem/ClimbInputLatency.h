@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Traversal actions whose input to motion latency is measured */
+enum class EClimbLatencyAction : uint8
+{
+	EnterClimb,
+	ClimbDownLedge,
+	Vault,
+	WallRun,
+	ExitClimb,
+	ClimbMove,
+	HangShimmy,
+	Num
+};
+
+/** When an input reached the character, carried through the movement component until the motion it asked for shows up */
+struct FClimbInputStamp
+{
+	uint64 Frame = 0;
+	double Seconds = 0.0;
+	/** Num until the input has started an action */
+	EClimbLatencyAction Action = EClimbLatencyAction::Num;
+
+	FORCEINLINE bool IsSet() const { return Frame != 0; }
+	FORCEINLINE bool IsAwaitingMotion() const { return Frame != 0 && Action != EClimbLatencyAction::Num; }
+
+	static FClimbInputStamp Now();
+};
+
+/** Latency distribution of one action, nearest rank percentiles */
+struct FClimbLatencyReport
+{
+	int32 NumSamples = 0;
+	int32 NumUnresolved = 0;
+	uint32 FramesP50 = 0;
+	uint32 FramesP95 = 0;
+	uint32 FramesP99 = 0;
+	float MillisecondsP50 = 0.f;
+	float MillisecondsP95 = 0.f;
+	float MillisecondsP99 = 0.f;
+};
+
+/**
+ * Input to motion latency of the traversal actions. While recording, the character stamps climb and move inputs,
+ * the movement component tags them with the action they start and the first frame of that action's motion closes
+ * them: montage position for montages, root motion for baked traversals, velocity for climbing and shimmying.
+ * Game thread only. Climbing.InputLatency.Start / Stop from the console, Climbing.Bench.InputLatency headless.
+ */
+class PROCANIMATIONS_API FClimbInputLatency
+{
+public:
+	static FClimbInputLatency& Get();
+
+	void Start();
+	void Stop();
+	FORCEINLINE bool IsRecording() const { return bRecording; }
+
+	/** Records the latency of a stamp awaiting motion and clears it */
+	void Resolve(FClimbInputStamp& Stamp);
+	/** Counts a stamp whose motion never showed, replaced by a later input or cut short, and clears it */
+	void Abandon(FClimbInputStamp& Stamp);
+
+	FClimbLatencyReport GetReport(EClimbLatencyAction Action) const;
+	void LogReport(const FString& Label) const;
+
+	static const TCHAR* GetActionName(EClimbLatencyAction Action);
+
+private:
+	struct FSample
+	{
+		uint32 Frames;
+		float Milliseconds;
+	};
+
+	TArray<FSample> Samples[(uint8)EClimbLatencyAction::Num];
+	int32 Unresolved[(uint8)EClimbLatencyAction::Num] = {};
+	bool bRecording = false;
+};
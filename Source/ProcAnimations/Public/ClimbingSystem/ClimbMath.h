@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+
+/**
+ * World free math kernels behind UCustomMovementComponent's climb tick.
+ * Kept free of UObjects so they can be measured and optimised in isolation by the ClimbMathBenchmark commandlet.
+ */
+namespace ClimbMath
+{
+	/** cos(60 deg), the surface slope at which climbing stops */
+	inline constexpr float DefaultStopClimbSlopeCos = 0.5f;
+
+	/** Mean impact point and normalised mean impact normal of the climb sweep hits */
+	FORCEINLINE void AverageSurfaceHits(TConstArrayView<FHitResult> Hits, FVector& OutLocation, FVector& OutNormal)
+	{
+		OutLocation = FVector::ZeroVector;
+		OutNormal = FVector::ZeroVector;
+
+		if(Hits.IsEmpty()) return;
+
+		for(const FHitResult& Hit : Hits)
+		{
+			OutLocation += Hit.ImpactPoint;
+			OutNormal += Hit.ImpactNormal;
+		}
+
+		OutLocation /= Hits.Num();
+		OutNormal = OutNormal.GetSafeNormal();
+	}
+
+	/** Original slope test, kept as the benchmark baseline */
+	FORCEINLINE bool IsSlopeTooFlatToClimb_Acos(const FVector& SurfaceNormal, float MaxSlopeDegrees)
+	{
+		const float DotResult = FVector::DotProduct(SurfaceNormal, FVector::UpVector);
+		return FMath::RadiansToDegrees(FMath::Acos(DotResult)) <= MaxSlopeDegrees;
+	}
+
+	/** Same test without trig: the angle to up is at most the limit when the dot is at least its cosine */
+	FORCEINLINE bool IsSlopeTooFlatToClimb(const FVector& SurfaceNormal, float StopSlopeCos)
+	{
+		return SurfaceNormal.Z >= StopSlopeCos;
+	}
+
+	FORCEINLINE FQuat ComputeClimbRotation(const FQuat& CurrentQuat, const FVector& SurfaceNormal, float DeltaTime, float InterpSpeed)
+	{
+		const FQuat TargetQuat = FRotationMatrix::MakeFromX(-SurfaceNormal).ToQuat();
+		return FMath::QInterpTo(CurrentQuat, TargetQuat, DeltaTime, InterpSpeed);
+	}
+
+	/** Pull toward the surface along its normal, scaled by the distance to it along the component forward */
+	FORCEINLINE FVector ComputeSnapVector(const FVector& ComponentLocation, const FVector& ComponentForward,
+		const FVector& SurfaceLocation, const FVector& SurfaceNormal)
+	{
+		const FVector ProjectedCharacterToSurface = (SurfaceLocation - ComponentLocation).ProjectOnTo(ComponentForward);
+		return -SurfaceNormal * ProjectedCharacterToSurface.Length();
+	}
+
+	FORCEINLINE FVector UnrotateClimbVelocity(const FQuat& ComponentQuat, const FVector& Velocity)
+	{
+		return ComponentQuat.UnrotateVector(Velocity);
+	}
+}
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbMathBenchmarkCommandlet.generated.h"
+
+/**
+ * Times the ClimbMath kernels over several batch sizes, no world required.
+ * UnrealEditor-Cmd ProcAnimations -run=ClimbMathBenchmark [-Iterations=2000000] [-Csv=Path]
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbMathBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbMathBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** One server side sample of a climber after a move, packed to 32 bytes */
+struct FClimbTransformSample
+{
+	enum EFlags : uint8
+	{
+		Climbing = 1 << 0,
+		HasAnchor = 1 << 1,
+		RootMotion = 1 << 2
+	};
+
+	/** Sum of move delta times since the history started */
+	float Time = 0.f;
+	FVector3f Location = FVector3f::ZeroVector;
+	/** Climbed surface point relative to Location, in centimetres */
+	int16 AnchorOffset[3] = {};
+	/** Climbed surface normal quantized to [-127, 127] */
+	int8 AnchorNormal[3] = {};
+	uint8 Flags = 0;
+	uint16 Yaw = 0;
+	uint8 Padding[4] = {};
+
+	bool HasFlag(EFlags Flag) const { return (Flags & Flag) != 0; }
+	FVector GetLocation() const { return FVector(Location); }
+	FVector GetAnchorLocation() const;
+	FVector GetAnchorNormal() const;
+	FVector GetForward() const;
+
+	static FClimbTransformSample Make(float Time, const FVector& Location, float Yaw, bool bClimbing, bool bRootMotion,
+		const FVector* SurfaceLocation = nullptr, const FVector* SurfaceNormal = nullptr);
+};
+
+static_assert(sizeof(FClimbTransformSample) == 32, "FClimbTransformSample is meant to stay two to a cache line");
+
+/** A client's claimed position after a climb move, checked against the server's history for the same move */
+struct FClimbMoveClaim
+{
+	uint32 Sequence = 0;
+	FVector ClaimedLocation = FVector::ZeroVector;
+	/** First climb move after some other mode, there is no previous claim to bound its speed by */
+	bool bStartsClimb = false;
+};
+
+enum class EClimbMoveVerdict : uint8
+{
+	Valid,
+	/** The move fell out of the history before it could be checked */
+	Expired,
+	/** No surface anchor recently, only a trace can tell */
+	NeedsGeometry,
+	TooFast,
+	OffSurface,
+	TraversalOvershoot,
+	NoClimbableGeometry
+};
+
+PROCANIMATIONS_API const TCHAR* LexToString(EClimbMoveVerdict Verdict);
+
+struct FClimbMoveValidationParams
+{
+	float MaxClimbSpeed = 100.f;
+	float RootMotionSpeed = 800.f;
+	float SpeedSlack = 1.25f;
+	float Tolerance = 15.f;
+	float AnchorReach = 90.f;
+	float AnchorWindow = 0.5f;
+	float MaxTraversalDisplacement = 450.f;
+};
+
+/**
+ * Rewindable ring of a climber's recent server samples, plus the bookkeeping validation keeps per climber.
+ * Samples are addressed by a running sequence number, so a queued claim finds exactly the move it was made for.
+ */
+class PROCANIMATIONS_API FClimbMoveHistory
+{
+public:
+	void Init(int32 Capacity);
+	bool IsInitialized() const { return !Samples.IsEmpty(); }
+	SIZE_T GetAllocatedSize() const { return Samples.GetAllocatedSize(); }
+
+	/** Records a sample after a move of DeltaTime, returns its sequence number */
+	uint32 Record(float DeltaTime, const FVector& Location, float Yaw, bool bClimbing, bool bRootMotion,
+		const FVector* SurfaceLocation = nullptr, const FVector* SurfaceNormal = nullptr);
+
+	uint32 GetLastSequence() const { return NextSequence - 1; }
+	const FClimbTransformSample* FindBySequence(uint32 Sequence) const;
+
+	/** The claim and suspicion state validation carries between moves */
+	void NoteClaim(const FClimbMoveClaim& Claim, float Time);
+	bool HasPreviousClaim() const { return LastClaimTime >= 0.f; }
+	void ClearPreviousClaim() { LastClaimTime = -1.f; }
+	FVector GetPreviousClaimLocation() const { return LastClaimLocation; }
+	float GetPreviousClaimTime() const { return LastClaimTime; }
+
+	/** Adds one suspicious move, true when this pushes the climber over FlagThreshold */
+	bool AddSuspicion(double Now, float Decay, float FlagThreshold);
+	void DecaySuspicion(double Now, float Decay);
+	bool IsFlagged() const { return bFlagged; }
+	float GetSuspicion() const { return Suspicion; }
+
+	/** Flags the climber with enough suspicion to stay flagged for Seconds, for checking what flagging does */
+	void ForceFlag(double Now, float Decay, float Seconds);
+	void ClearSuspicion();
+
+	/** Climb moves received while flagged, those where the server had the climber on the wall too, and how many the server corrected */
+	void NoteFlaggedClaim(bool bServerOnWall) { ++FlaggedClaims; OnWallFlaggedClaims += bServerOnWall ? 1 : 0; }
+	void NoteForcedCorrection() { ++ForcedCorrections; }
+	uint32 GetFlaggedClaims() const { return FlaggedClaims; }
+	uint32 GetOnWallFlaggedClaims() const { return OnWallFlaggedClaims; }
+	uint32 GetForcedCorrections() const { return ForcedCorrections; }
+
+private:
+	friend struct FClimbMoveValidator;
+
+	TArray<FClimbTransformSample> Samples;
+	uint32 NextSequence = 1;
+	float SimulatedTime = 0.f;
+
+	FVector LastClaimLocation = FVector::ZeroVector;
+	float LastClaimTime = -1.f;
+
+	float Suspicion = 0.f;
+	double SuspicionTime = 0.0;
+	bool bFlagged = false;
+
+	uint32 FlaggedClaims = 0;
+	uint32 OnWallFlaggedClaims = 0;
+	uint32 ForcedCorrections = 0;
+};
+
+/** The cheap part of climb move validation, no world access, so it can run headless */
+struct PROCANIMATIONS_API FClimbMoveValidator
+{
+	static EClimbMoveVerdict CheckClaim(const FClimbMoveHistory& History, const FClimbMoveClaim& Claim,
+		const FClimbMoveValidationParams& Params, FVector& OutProbeDirection);
+
+	static bool IsSuspicious(EClimbMoveVerdict Verdict)
+	{
+		return Verdict >= EClimbMoveVerdict::TooFast;
+	}
+};
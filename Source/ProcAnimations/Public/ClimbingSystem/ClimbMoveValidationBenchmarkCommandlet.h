@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbMoveValidationBenchmarkCommandlet.generated.h"
+
+/**
+ * Runs climb move validation for simulated clients at the server tick rate under the configured per frame budget,
+ * with a share of teleport cheats mixed in. Fails when an honest move is flagged, a checked cheat slips through or a
+ * frame runs past the budget. No world required, claims that would need a geometry trace are only counted.
+ * UnrealEditor-Cmd ProcAnimations -run=ClimbMoveValidationBenchmark [-Clients=100] [-Seconds=30] [-TickRate=60] [-CheatRate=0.002] [-Csv=Path]
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbMoveValidationBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbMoveValidationBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
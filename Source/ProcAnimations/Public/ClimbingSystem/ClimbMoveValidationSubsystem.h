@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/TimerHandle.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbingSystem/ClimbMoveValidation.h"
+#include "ClimbMoveValidationSubsystem.generated.h"
+
+class UCustomMovementComponent;
+
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnSuspiciousClimbMove, UCustomMovementComponent*, EClimbMoveVerdict, const FVector&)
+
+/**
+ * Checks the climb moves clients report against each climber's server history, within a fixed CPU budget per frame.
+ * Claims queue up and are worked through oldest first. Whatever the budget does not reach waits for the next frame
+ * or expires out of the history. Climbers that keep making suspicious moves are flagged and lose client authority.
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbMoveValidationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void SubmitClaim(UCustomMovementComponent* Climber, const FClimbMoveClaim& Claim);
+
+	/** Fired on the server for every move that fails validation */
+	FOnSuspiciousClimbMove OnSuspiciousClimbMove;
+
+	void LogValidationReport() const;
+
+	/**
+	 * Flags every remotely controlled climber for Seconds, then checks that each climb move they sent meanwhile
+	 * went through the server's real move handling and came back corrected, and that some arrived while the server
+	 * had them on the wall too. Their suspicion is cleared afterwards, bQuitWhenDone exits with the result
+	 */
+	void StartFlaggedCorrectionCheck(float Seconds, bool bQuitWhenDone = false);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FPendingClaim
+	{
+		TWeakObjectPtr<UCustomMovementComponent> Climber;
+		FClimbMoveClaim Claim;
+	};
+
+	EClimbMoveVerdict ValidateClaim(UCustomMovementComponent* Climber, const FClimbMoveClaim& Claim);
+
+	struct FFlaggedCorrectionCheck
+	{
+		TWeakObjectPtr<UCustomMovementComponent> Climber;
+		uint32 StartClaims = 0;
+		uint32 StartOnWallClaims = 0;
+		uint32 StartCorrections = 0;
+	};
+
+	void FinishFlaggedCorrectionCheck();
+	bool bQuitAfterFlaggedCorrectionCheck = false;
+
+	TArray<FFlaggedCorrectionCheck> FlaggedCorrectionChecks;
+	FTimerHandle FlaggedCorrectionCheckTimer;
+
+	TArray<FPendingClaim> PendingClaims;
+	int32 PendingHead = 0;
+
+	uint64 TotalClaims = 0;
+	uint64 TotalSuspicious = 0;
+	uint64 TotalExpired = 0;
+	uint64 TotalDropped = 0;
+	uint64 TotalGeometryTraces = 0;
+	uint64 TotalFlagged = 0;
+	double MaxFrameMs = 0.0;
+};
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbProxyBenchmarkCommandlet.generated.h"
+
+/**
+ * Times the climbing capsule sweeps and line traces against the complex collision of a map's static geometry and
+ * against its climb proxies, from the same points just off the proxy faces, and how often both agree on the hit.
+ * Fails when the map has no climb proxies.
+ * UnrealEditor-Cmd ProcAnimations -run=ClimbProxyBenchmark -Map=/Game/Maps/Level [-Queries=20000] [-Csv=Path]
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbProxyBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbProxyBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ClimbingSystem/ClimbProxyComponent.h"
+
+class UStaticMesh;
+class UWorld;
+
+struct FClimbProxyBuildParams
+{
+	float SlabThickness = 10.f;
+	/** Faces adding up to less than this many square cm get no slab */
+	float MinSlabArea = 2500.f;
+	/** A patch whose faces cover less of its slab than this is split, so slabs do not span openings */
+	float MinSlabCoverage = 0.8f;
+};
+
+namespace ClimbProxyBuilder
+{
+	/**
+	 * Boxes over the wall and ledge top faces of the mesh's LOD0, in mesh space.
+	 * Faces are grouped by facing, walls in eight yaw sectors plus the tops, then by depth along that facing,
+	 * then into patches of faces sharing corners. Each patch gets slabs whose outer faces lie on its outermost plane,
+	 * split until they cover at least MinSlabCoverage.
+	 */
+	PROCANIMATIONS_API int32 BuildSlabs(const UStaticMesh& Mesh, const FClimbProxyBuildParams& Params, TArray<FClimbProxySlab>& OutSlabs);
+
+	/** Loads a map with its collision up for the climb proxy commandlets, null if it does not load */
+	PROCANIMATIONS_API UWorld* LoadWorldForQueries(const FString& MapPath);
+	PROCANIMATIONS_API void ReleaseWorld(UWorld* World);
+}
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "ClimbProxyComponent.generated.h"
+
+/** Object channel of the climb proxies, named ClimbProxy in DefaultEngine.ini */
+#define ECC_ClimbProxy ECC_GameTraceChannel2
+
+class UBodySetup;
+
+/** One box of a climb proxy, in the space of the proxy component */
+USTRUCT()
+struct FClimbProxySlab
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Proxy")
+	FVector Center = FVector::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Proxy")
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Proxy")
+	FVector Extent = FVector::ZeroVector;
+};
+
+/**
+ * Simple boxes over the walls and ledge tops of the mesh it is attached to, generated by the ClimbProxyGenerator commandlet.
+ * Only queries for the ClimbProxy object type find them, every other channel ignores them.
+ */
+UCLASS(ClassGroup = (Climbing), meta = (BlueprintSpawnableComponent))
+class PROCANIMATIONS_API UClimbProxyComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	UClimbProxyComponent(const FObjectInitializer& ObjectInitializer);
+
+	void SetSlabs(TArray<FClimbProxySlab>&& InSlabs);
+	FORCEINLINE const TArray<FClimbProxySlab>& GetSlabs() const { return Slabs; }
+
+	virtual UBodySetup* GetBodySetup() override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+
+private:
+	void UpdateProxyBodySetup();
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Proxy")
+	TArray<FClimbProxySlab> Slabs;
+
+	UPROPERTY(Transient, DuplicateTransient)
+	TObjectPtr<UBodySetup> ProxyBodySetup;
+};
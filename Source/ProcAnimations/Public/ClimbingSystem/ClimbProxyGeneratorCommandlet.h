@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbProxyGeneratorCommandlet.generated.h"
+
+/**
+ * Replaces the climb proxies of a map with boxes generated from its static, colliding static meshes and saves the map.
+ * Instanced meshes are skipped. Rerun it after editing the level geometry.
+ * UnrealEditor-Cmd ProcAnimations -run=ClimbProxyGenerator -Map=/Game/Maps/Level [-SlabThickness=10] [-MinSlabArea=2500] [-MinSlabCoverage=0.8]
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbProxyGeneratorCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbProxyGeneratorCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Traversal query totals of one top down grid cell, written to .cqh files as is */
+struct FClimbQueryHeatmapCell
+{
+	int32 CellX = 0;
+	int32 CellY = 0;
+	uint32 CapsuleTraces = 0;
+	uint32 LineTraces = 0;
+	uint32 Hits = 0;
+	uint32 Padding = 0;
+	/** Summed in double, a float stops adding single trace times once a busy cell reaches a few seconds */
+	double Microseconds = 0.0;
+};
+static_assert(sizeof(FClimbQueryHeatmapCell) == 32, "Heatmap cells are saved raw, keep the layout stable");
+
+/** Header of a .cqh heatmap, followed by the map name and the cells */
+struct FClimbQueryHeatmapHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x4D485143; // "CQHM"
+	static constexpr uint32 CurrentVersion = 2;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = CurrentVersion;
+	float CellSize = 0.f;
+	uint32 NumCells = 0;
+	double RecordedSeconds = 0.0;
+};
+static_assert(sizeof(FClimbQueryHeatmapHeader) == 24, "Heatmap headers are saved raw, keep the layout stable");
+
+/**
+ * Where in the level traversal queries cost the most. While recording, every capsule sweep and line trace of the
+ * climbing funnels adds the time of the query itself and its hit count to the cell under the trace start. Game thread only.
+ * Climbing.QueryHeatmap.Start / Stop from the console, the ClimbQueryHeatmapRender commandlet draws the saved file.
+ */
+class PROCANIMATIONS_API FClimbQueryHeatmap
+{
+public:
+	static FClimbQueryHeatmap& Get();
+
+	void Start(float InCellSize);
+	/** Stops recording and writes a .cqh file in the background, returns the file path or empty when nothing was recorded */
+	FString StopAndSave(const FString& MapName);
+
+	FORCEINLINE bool IsRecording() const { return bRecording; }
+	void Record(const FVector& Location, bool bCapsule, int32 Hits, uint64 Cycles);
+
+	static bool LoadFromFile(const FString& FilePath, FClimbQueryHeatmapHeader& OutHeader, FString& OutMapName, TArray<FClimbQueryHeatmapCell>& OutCells);
+
+	/** Times one trace into the heatmap, from construction until Stop. Costs a branch when not recording */
+	struct FScope
+	{
+		FScope(const FVector& InLocation, bool bInCapsule)
+			: Location(InLocation), bCapsule(bInCapsule), StartCycles(Get().IsRecording() ? FPlatformTime::Cycles64() : 0)
+		{
+		}
+
+		/** Call right after the query returns so debug draw and bookkeeping stay out of the time */
+		void Stop(int32 Hits)
+		{
+			if(StartCycles == 0) return;
+			Get().Record(Location, bCapsule, Hits, FPlatformTime::Cycles64() - StartCycles);
+			StartCycles = 0;
+		}
+
+		FVector Location;
+		bool bCapsule;
+		uint64 StartCycles;
+	};
+
+private:
+	TMap<FIntPoint, FClimbQueryHeatmapCell> Cells;
+	float CellSize = 200.f;
+	double StartTime = 0.0;
+	bool bRecording = false;
+};
@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbQueryHeatmapRenderCommandlet.generated.h"
+
+/**
+ * Draws a .cqh traversal query heatmap as a top down PNG, world X up, and logs the hottest cells with their world location.
+ * Metric: Time (microseconds spent tracing), Traces, or HitsPerTrace.
+ * UnrealEditor-Cmd ProcAnimations -run=ClimbQueryHeatmapRender -File=Path [-Out=Path] [-Metric=Time] [-PixelsPerCell=8] [-Top=10]
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbQueryHeatmapRenderCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbQueryHeatmapRenderCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldPartition/WorldPartitionStreamingSource.h"
+#include "ClimbStreamingSubsystem.generated.h"
+
+class UCustomMovementComponent;
+
+/**
+ * Keeps traversal from probing into World Partition cells that have not streamed in.
+ * Player climbers get a streaming source where their velocity puts them a lookahead from now, so the cells they
+ * head into are requested early. Every climber is told whether the cells within probe reach are active, and
+ * holds its last traced surface instead of probing while they are not, for at most ClimbStreamingHoldTimeout.
+ * Worlds without World Partition are left alone.
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbStreamingSubsystem : public UTickableWorldSubsystem, public IWorldPartitionStreamingSourceProvider
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterClimber(UCustomMovementComponent* Climber);
+	void UnregisterClimber(UCustomMovementComponent* Climber);
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	virtual bool GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const override;
+	virtual const UObject* GetStreamingSourceOwner() const override { return this; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void SetAllStreamedIn();
+
+	TArray<TWeakObjectPtr<UCustomMovementComponent>> Climbers;
+
+	/** When each holding climber started holding, cleared once its cells are active */
+	TMap<TWeakObjectPtr<UCustomMovementComponent>, double> HoldStartTimes;
+
+	/** Lookahead sources handed to World Partition, rebuilt every check */
+	TArray<FWorldPartitionStreamingSource> LookaheadSources;
+
+	float TimeUntilCheck = 0.f;
+	bool bRegisteredAsSourceProvider = false;
+};
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimberSeparationSubsystem.generated.h"
+
+class UCustomMovementComponent;
+
+/**
+ * Keeps climbers sharing a wall apart before their capsule sweeps collide.
+ * Active climbers go into a spatial hash once per frame, each one is steered away from neighbours on the same
+ * surface within the surface plane, so the cost stays linear in the number of climbers.
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimberSeparationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterClimber(UCustomMovementComponent* Climber);
+	void UnregisterClimber(UCustomMovementComponent* Climber);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	TArray<TWeakObjectPtr<UCustomMovementComponent>> Climbers;
+
+	/** Spatial hash rebuilt every frame: first climber per cell, then a chain through NextInCell */
+	TMap<FIntVector, int32> CellHeads;
+	TArray<int32> NextInCell;
+	TArray<FVector> Locations;
+	TArray<FVector> SurfaceNormals;
+};
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbingAnimationBudgetSubsystem.generated.h"
+
+class USkeletalMeshComponentBudgeted;
+
+/**
+ * Configures the animation budget allocator for climber meshes from UClimbingSettings and
+ * provides their significance from distance to the closest local viewer.
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbingAnimationBudgetSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Applies the budget settings to this world's allocator, call again after changing them at runtime */
+	void ApplyBudgetSettings() const;
+
+	/** Bound to OnCalculateSignificance, climber meshes auto calculate their significance through it */
+	static float CalculateClimberSignificance(USkeletalMeshComponentBudgeted* Component);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+};
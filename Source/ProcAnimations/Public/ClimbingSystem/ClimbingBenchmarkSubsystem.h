@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbingSystem/CustomMovementComponent.h"
+#include "ClimbingBenchmarkSubsystem.generated.h"
+
+class AClimbingCharacter;
+
+/** What the benchmark climbers do once warmed up */
+enum class EClimbingBenchmarkScenario : uint8
+{
+	/** Put on the wall and left to climb */
+	Climb,
+	/** Dropped from DropHeight onto the spawn grid at the world origin, only ledges the level has under it get caught */
+	LedgeCatch,
+	/** Driven by scripted climb and move inputs while input latency is recorded */
+	InputLatency,
+	/** Driven by the same scripted inputs while mode changes and overlap refreshes per traversal action are counted */
+	Transitions,
+	/** Put on the wall and left to go dormant, then woken halfway through by an AI move request */
+	NetDormancy
+};
+
+/**
+ * Spawns a crowd of climbers and measures world tick time over a number of frames.
+ * Driven from the console so it can run headless, e.g.
+ * ProcAnimationsServer Map_Climbing -log -ExecCmds="Climbing.Bench.ServerFrameTime 100 600 quit"
+ * ProcAnimations Map_Climbing -game -nullrhi -log -ExecCmds="Climbing.Bench.InputLatency 20 1200 quit"
+ * The net dormancy run needs a server with a client connected over loopback, e.g.
+ * ProcAnimationsServer Map_Climbing -log -ExecCmds="Climbing.Bench.NetDormancy 100 900 quit" and
+ * ProcAnimations 127.0.0.1 -game -nullrhi -log
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbingBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void StartBenchmark(const FString& InBenchmarkName, int32 NumClimbers, int32 NumFrames, bool bInQuitWhenDone,
+		EClimbingBenchmarkScenario InScenario = EClimbingBenchmarkScenario::Climb);
+	FORCEINLINE bool IsBenchmarkRunning() const { return bIsRunning; }
+	FORCEINLINE const TArray<TWeakObjectPtr<AClimbingCharacter>>& GetBenchmarkClimbers() const { return BenchmarkClimbers; }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void SpawnBenchmarkClimbers(int32 NumClimbers);
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void InjectScriptedInputs();
+	void FinishBenchmark();
+
+	TArray<TWeakObjectPtr<AClimbingCharacter>> BenchmarkClimbers;
+	TArray<double> WorldTickTimesMs;
+
+	/** Query count of each dropped climber falling at the start of the tick, INDEX_NONE for the others */
+	TArray<int32> FallingTickStartQueries;
+	int64 FallingTicks = 0;
+	int64 FallingTickQueries = 0;
+	int32 MaxFallingTickQueries = 0;
+	int32 NumLedgeCatches = 0;
+
+	/** Each climber's transition counters once warmed up */
+	TArray<FTraversalTransitionCounters> TransitionStartCounters;
+
+	void CheckDormancyWake();
+
+	int32 DormancyCheckFramesRemaining = 0;
+	int32 DormantBeforeWake = 0;
+	int32 WokenByMoveRequest = 0;
+	uint32 DormantOutBytesPerSecond = 0;
+
+	int32 ScriptedInputFrame = 0;
+
+	FString BenchmarkName;
+	FDelegateHandle TickStartHandle;
+	FDelegateHandle PostActorTickHandle;
+	double WorldTickStartSeconds = 0.0;
+	int32 WarmupFramesRemaining = 0;
+	int32 FramesRemaining = 0;
+	bool bIsRunning = false;
+	bool bQuitWhenDone = false;
+	EClimbingBenchmarkScenario Scenario = EClimbingBenchmarkScenario::Climb;
+};
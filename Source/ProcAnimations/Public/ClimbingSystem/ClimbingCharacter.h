@@ -5,10 +5,13 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "InputActionValue.h"
+#include "ClimbingSystem/CustomMovementComponent.h"
+#include "ClimbingSystem/ClimbingReplicationSubsystem.h"
 #include "ClimbingCharacter.generated.h"
 
 class UCustomMovementComponent;
 class UMotionWarpingComponent;
+class UClimbIKComponent;
 
 UCLASS(config = Game)
 class AClimbingCharacter : public ACharacter
@@ -45,6 +48,9 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	UMotionWarpingComponent* MotionWarpingComponent;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
+	UClimbIKComponent* ClimbIKComponent;
+
 	/** Input Mapping Context */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
 	class UInputMappingContext* DefaultMappingContext;
@@ -94,9 +100,13 @@ private:
 	void HandleGroundMovementInput(const FInputActionValue& Value);
 	void HandleClimbMovementInput(const FInputActionValue& Value);
 
+	/** Strips animation and presentation work that a dedicated server never needs */
+	void ApplyServerClimbingConfiguration();
+
 	/** Climbing State Handling */
 	void OnPlayerEnterClimbState();
 	void OnPlayerExitClimbState();
+	void OnTraversalStateChanged(ETraversalState NewState);
 
 	UPROPERTY(VisibleAnywhere)
 	bool bIsSprintOn = false;
@@ -105,6 +115,14 @@ private:
 
 	bool bIsCrouchActive;
 
+	/** Replication tiers */
+	friend class UClimbingReplicationSubsystem;
+
+	EClimbReplicationTier ClimbReplicationTier = EClimbReplicationTier::Active;
+	double ClimbStationarySince = -1.0;
+	float DefaultNetUpdateFrequency = 0.f;
+	int32 ClimbReplicationWakes = 0;
+
 
 protected:
 	/** APawn interface */
@@ -112,12 +130,26 @@ protected:
 
 	/** Called when the game starts */
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	AClimbingCharacter(const FObjectInitializer& ObjectInitializer);
-	
+
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+	virtual void AddMovementInput(FVector WorldDirection, float ScaleValue = 1.0f, bool bForce = false) override;
+
+	/** Replication tiers, server only */
+	void SetClimbReplicationTier(EClimbReplicationTier NewTier);
+	void WakeClimbReplication();
+	FORCEINLINE EClimbReplicationTier GetClimbReplicationTier() const { return ClimbReplicationTier; }
+	FORCEINLINE int32 GetClimbReplicationWakes() const { return ClimbReplicationWakes; }
+
+	/** Scripted input for harnesses, runs the same handlers as the bound input actions */
+	void InjectClimbAction();
+	void InjectMoveInput(const FVector2D& MoveInput);
 
 	/** Accessor Functions */
 	FORCEINLINE UCustomMovementComponent* GetCustomMovementComponent() const { return CustomMovementComponent; }
 	FORCEINLINE UMotionWarpingComponent* GetMotionWarpingComponent() const { return MotionWarpingComponent; }
+	FORCEINLINE UClimbIKComponent* GetClimbIKComponent() const { return ClimbIKComponent; }
 };
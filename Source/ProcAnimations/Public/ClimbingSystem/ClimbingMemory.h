@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+class AClimbingCharacter;
+
+/** Low level memory tracker tags, shown under Climbing by stat LLMFULL and in -llmcsv captures */
+LLM_DECLARE_TAG_API(Climbing, PROCANIMATIONS_API);
+LLM_DECLARE_TAG_API(Climbing_Character, PROCANIMATIONS_API);
+LLM_DECLARE_TAG_API(Climbing_Movement, PROCANIMATIONS_API);
+LLM_DECLARE_TAG_API(Climbing_Queries, PROCANIMATIONS_API);
+LLM_DECLARE_TAG_API(Climbing_IK, PROCANIMATIONS_API);
+LLM_DECLARE_TAG_API(Climbing_TraversalIndex, PROCANIMATIONS_API);
+LLM_DECLARE_TAG_API(Climbing_FlightRecorder, PROCANIMATIONS_API);
+LLM_DECLARE_TAG_API(Climbing_Validation, PROCANIMATIONS_API);
+
+enum class EClimbingMemoryCategory : uint8
+{
+	Actor,
+	Cameras,
+	Movement,
+	MotionWarping,
+	IK,
+	Mesh,
+	Animation,
+	OtherComponents,
+	Num
+};
+
+/** Bytes one climber owns, per category. Assets shared between instances are not counted */
+struct FClimbingMemoryFootprint
+{
+	int64 Bytes[(uint8)EClimbingMemoryCategory::Num] = {};
+
+	int64 GetTotal() const;
+	void Accumulate(const FClimbingMemoryFootprint& Other);
+	void Max(const FClimbingMemoryFootprint& Other);
+};
+
+namespace ClimbingMemory
+{
+	PROCANIMATIONS_API const TCHAR* GetCategoryName(EClimbingMemoryCategory Category);
+
+	/** The object itself plus whatever it reports as its own through GetResourceSizeEx */
+	PROCANIMATIONS_API int64 GetObjectBytes(const UObject* Object);
+
+	PROCANIMATIONS_API void GatherFootprint(const AClimbingCharacter* Character, FClimbingMemoryFootprint& OutFootprint);
+}
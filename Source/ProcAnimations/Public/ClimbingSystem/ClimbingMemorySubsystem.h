@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbingSystem/ClimbingMemory.h"
+#include "ClimbingMemorySubsystem.generated.h"
+
+/**
+ * Samples the memory footprint of every climber in the world and keeps per class high-water marks,
+ * reported by Climbing.MemReport for sizing crowds.
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbingMemorySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void SampleFootprints();
+
+	/** Logs per class totals and high-water marks, plus every instance when bListInstances */
+	void LogMemoryReport(bool bListInstances);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FClassMemoryRecord
+	{
+		int32 Count = 0;
+		int32 HighWaterCount = 0;
+		FClimbingMemoryFootprint Current;
+		/** Largest total the whole class has reached, per category */
+		FClimbingMemoryFootprint HighWaterTotal;
+		/** Largest single instance seen, per category */
+		FClimbingMemoryFootprint HighWaterInstance;
+	};
+
+	TMap<FName, FClassMemoryRecord> ClassRecords;
+	float TimeUntilSample = 0.f;
+};
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbingReplicationSubsystem.generated.h"
+
+class AClimbingCharacter;
+
+UENUM(BlueprintType)
+enum class EClimbReplicationTier : uint8
+{
+	/** Moving or transitioning, replicated at full rate */
+	Active,
+	/** Hanging still on a wall, dormant until woken by input or a traversal state change */
+	Idle,
+	/** Active but far from every viewer, replicated at a reduced rate */
+	Distant
+};
+
+/**
+ * Server side replication tiers for climbers.
+ * Stationary AI climbers go dormant, distant ones replicate less often and idle ones are culled sooner.
+ */
+UCLASS()
+class PROCANIMATIONS_API UClimbingReplicationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterClimber(AClimbingCharacter* Climber);
+	void UnregisterClimber(AClimbingCharacter* Climber);
+
+	/** Logs the current tier counts and the server's outgoing bandwidth */
+	void LogReplicationReport() const;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	EClimbReplicationTier EvaluateTier(AClimbingCharacter* Climber, const TArray<FVector>& ViewLocations, double WorldTime);
+	void GatherViewLocations(TArray<FVector>& OutViewLocations) const;
+
+	TArray<TWeakObjectPtr<AClimbingCharacter>> Climbers;
+	float TimeUntilEvaluation = 0.f;
+	int32 TierCounts[3] = {};
+};
@@ -0,0 +1,270 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "ClimbingSettings.generated.h"
+
+/**
+ * Project wide tuning for the climbing system, edited under Project Settings > Game > Climbing
+ */
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "Climbing"))
+class PROCANIMATIONS_API UClimbingSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UClimbingSettings();
+
+	static const UClimbingSettings* Get() { return GetDefault<UClimbingSettings>(); }
+
+	/** Climb IK */
+	UPROPERTY(config, EditAnywhere, Category = "IK", meta = (ClampMin = 0))
+	int32 MaxIKLimbTracesPerFrame = 32;
+
+	UPROPERTY(config, EditAnywhere, Category = "IK", meta = (ClampMin = 0.f))
+	float IKFullRateDistance = 1500.f;
+
+	UPROPERTY(config, EditAnywhere, Category = "IK", meta = (ClampMin = 0.f))
+	float IKHalfRateDistance = 3000.f;
+
+	UPROPERTY(config, EditAnywhere, Category = "IK", meta = (ClampMin = 0.f))
+	float IKQuarterRateDistance = 4500.f;
+
+	/** Climbers further than this from every viewer get no IK at all */
+	UPROPERTY(config, EditAnywhere, Category = "IK", meta = (ClampMin = 0.f))
+	float IKMaxDistance = 6000.f;
+
+	/** Traversal query governor */
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Queries", meta = (ClampMin = 1))
+	int32 MaxTraversalQueriesPerFrame = 256;
+
+	/** How many frames a deferred probe may reuse its last result before it is dropped */
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Queries", meta = (ClampMin = 0))
+	int32 MaxTraversalProbeStaleFrames = 4;
+
+	/** Answer climbers probing the same cell from one gathered set of primitives */
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Queries")
+	bool bCoalesceTraversalQueries = true;
+
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Queries", meta = (ClampMin = 50.f))
+	float CoalescingCellSize = 400.f;
+
+	/** Extra reach around a cell covered by its gathered primitives, probes longer than this skip coalescing */
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Queries", meta = (ClampMin = 0.f))
+	float CoalescingCellMargin = 200.f;
+
+	/** Baked traversal index */
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Index")
+	bool bUseTraversalIndex = true;
+
+	/** Matches the world partition runtime grid so index cells stream with level cells */
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Index", meta = (ClampMin = 100.f))
+	float TraversalIndexCellSize = 12800.f;
+
+	/**
+	 * Matches the world partition loading range. Cells this close to a player or a climb lookahead source are mapped,
+	 * in partitioned worlds only once the level cells under them are active
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Index", meta = (ClampMin = 0.f))
+	float TraversalIndexStreamingRadius = 25600.f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Index", meta = (ClampMin = 0.f))
+	float TraversalIndexStreamingInterval = 0.5f;
+
+	/** How far off the probe line a baked point may be and still answer it, half the bake's sample spacing */
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Index", meta = (ClampMin = 0.f))
+	float TraversalIndexLateralTolerance = 25.f;
+
+	/** Seconds an AI traversal opportunity probe result is reused for nearby candidates facing the same way */
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Index", meta = (ClampMin = 0.f))
+	float TraversalOpportunityCacheLifetime = 2.f;
+
+	/** Most AI traversal opportunity probe results one climber keeps, the oldest go first once it is full */
+	UPROPERTY(config, EditAnywhere, Category = "Traversal Index", meta = (ClampMin = 1))
+	int32 TraversalOpportunityCacheMaxEntries = 1024;
+
+	/** Climber separation */
+	UPROPERTY(config, EditAnywhere, Category = "Separation")
+	bool bUseClimberSeparation = true;
+
+	/** Climbers closer than this steer apart within the surface plane */
+	UPROPERTY(config, EditAnywhere, Category = "Separation", meta = (ClampMin = 1.f))
+	float ClimberSeparationRadius = 100.f;
+
+	/** Steering speed at full overlap, in cm/s */
+	UPROPERTY(config, EditAnywhere, Category = "Separation", meta = (ClampMin = 0.f))
+	float ClimberSeparationSpeed = 60.f;
+
+	/** Climbers whose surface normals agree less than this are on different faces and ignore each other */
+	UPROPERTY(config, EditAnywhere, Category = "Separation", meta = (ClampMin = -1.f, ClampMax = 1.f))
+	float ClimberSeparationNormalDot = 0.7f;
+
+	/** Integrate climb velocity, rotation and snap on the async physics tick. Needs Tick Physics Async */
+	UPROPERTY(config, EditAnywhere, Category = "Async Physics")
+	bool bUseAsyncPhysicsClimb = false;
+
+	/** Largest velocity (cm/s) or rotation (deg) difference Climbing.AsyncPhysics.ParityCheck accepts silently */
+	UPROPERTY(config, EditAnywhere, Category = "Async Physics", meta = (ClampMin = 0.f))
+	float AsyncClimbParityTolerance = 0.5f;
+
+	/** Flight recorder */
+	UPROPERTY(config, EditAnywhere, Category = "Flight Recorder")
+	bool bEnableFlightRecorder = true;
+
+	/** Frames longer than this dump the recent climbing history to Saved/Climbing/FlightRecorder */
+	UPROPERTY(config, EditAnywhere, Category = "Flight Recorder", meta = (ClampMin = 1.f))
+	float FlightRecorderHitchThresholdMs = 50.f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Flight Recorder", meta = (ClampMin = 0.1f))
+	float FlightRecorderDumpSeconds = 5.f;
+
+	/** Minimum seconds between two automatic dumps */
+	UPROPERTY(config, EditAnywhere, Category = "Flight Recorder", meta = (ClampMin = 0.f))
+	float FlightRecorderDumpCooldown = 10.f;
+
+	/** Dedicated server: tick only montages for root motion, skip anim graph updates and climb IK */
+	UPROPERTY(config, EditAnywhere, Category = "Server")
+	bool bStripPresentationOnServer = true;
+
+	/** Replication tiers for idle and distant climbers */
+	UPROPERTY(config, EditAnywhere, Category = "Server")
+	bool bUseClimberReplicationTiers = true;
+
+	/** AI climbers hanging still go dormant until input or a traversal state change wakes them */
+	UPROPERTY(config, EditAnywhere, Category = "Server")
+	bool bUseClimberNetDormancy = true;
+
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.f))
+	float ClimberReplicationTierInterval = 0.25f;
+
+	/** Seconds a climber has to hang still before it goes dormant */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.f))
+	float IdleClimberDormancyDelay = 1.f;
+
+	/** Idle climbers stop being relevant past this distance */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.f))
+	float IdleClimberNetCullDistance = 5000.f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.f))
+	float DistantClimberNetDistance = 4000.f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 1.f))
+	float DistantClimberNetUpdateFrequency = 10.f;
+
+	/** Drive traversal from baked root motion curves in networked games, on the server and its clients alike */
+	UPROPERTY(config, EditAnywhere, Category = "Server")
+	bool bUseBakedTraversalOnServer = true;
+
+	/** Drive traversal from baked root motion curves for AI nobody has seen recently */
+	UPROPERTY(config, EditAnywhere, Category = "Server")
+	bool bUseBakedTraversalForUnrenderedAI = true;
+
+	/** Largest distance (cm) between a traversal's end and its montage's root motion end Climbing.BakedTraversal.ParityCheck accepts */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.f))
+	float BakedTraversalParityTolerance = 5.f;
+
+	/** Check the climb moves clients report against the server's own history of each climber */
+	UPROPERTY(config, EditAnywhere, Category = "Server")
+	bool bValidateClimbMoves = true;
+
+	/** Moves of history kept per climber, claims older than this expire unchecked */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 2))
+	int32 ClimbMoveHistoryLength = 64;
+
+	/** Game thread milliseconds climb move validation may spend per frame */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.01f))
+	float ClimbValidationBudgetMs = 0.2f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 1))
+	int32 ClimbValidationMaxPendingClaims = 8192;
+
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.f))
+	float ClimbValidationTolerance = 15.f;
+
+	/** Multiplier on the allowed speed, covers frame time jitter between client and server */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 1.f))
+	float ClimbValidationSpeedSlack = 1.25f;
+
+	/** Fastest a traversal montage's root motion moves a climber */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.f))
+	float ClimbValidationRootMotionSpeed = 800.f;
+
+	/** Furthest a single traversal montage carries a climber from where it started */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.f))
+	float ClimbValidationMaxTraversalDisplacement = 450.f;
+
+	/** How far from the climbed surface a claimed climb position may be */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.f))
+	float ClimbValidationAnchorReach = 90.f;
+
+	/** Seconds a surface the server found still vouches for claims near it */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.f))
+	float ClimbValidationAnchorWindow = 0.5f;
+
+	/** Suspicious moves, net of decay, before a climber is flagged */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 1.f))
+	float ClimbValidationFlagThreshold = 3.f;
+
+	/** Suspicion forgiven per second */
+	UPROPERTY(config, EditAnywhere, Category = "Server", meta = (ClampMin = 0.f))
+	float ClimbValidationSuspicionDecay = 0.5f;
+
+	/** Animation budget allocator */
+	UPROPERTY(config, EditAnywhere, Category = "Animation Budget")
+	bool bUseAnimationBudget = true;
+
+	/** Game thread milliseconds all budgeted climber meshes may spend on animation per frame */
+	UPROPERTY(config, EditAnywhere, Category = "Animation Budget", meta = (ClampMin = 0.1f))
+	float AnimationBudgetMs = 1.f;
+
+	/** Lowest tick rate a throttled climber drops to, in frames between updates */
+	UPROPERTY(config, EditAnywhere, Category = "Animation Budget", meta = (ClampMin = 1))
+	int32 AnimationBudgetMaxTickRate = 10;
+
+	/** Distance from the closest viewer at which a climber reaches zero significance */
+	UPROPERTY(config, EditAnywhere, Category = "Animation Budget", meta = (ClampMin = 1.f))
+	float AnimationSignificanceFalloffDistance = 5000.f;
+
+	/** Seconds between climber memory footprint samples for the Climbing.MemReport high-water marks, zero samples only on demand */
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (ClampMin = 0.f))
+	float ClimbingMemorySampleInterval = 1.f;
+
+	/** World Partition */
+	/** Request the cells climbers head into ahead of time and hold traversal probes until the cells around them are active */
+	UPROPERTY(config, EditAnywhere, Category = "World Partition")
+	bool bClimbStreamingAwareness = true;
+
+	/** Seconds of current velocity ahead of a player climber where its lookahead streaming source sits */
+	UPROPERTY(config, EditAnywhere, Category = "World Partition", meta = (ClampMin = 0.f))
+	float ClimbStreamingLookahead = 2.f;
+
+	/** Radius around a climber whose cells must be active before it probes, covers the longest traversal probe */
+	UPROPERTY(config, EditAnywhere, Category = "World Partition", meta = (ClampMin = 0.f))
+	float ClimbStreamingProbeRadius = 300.f;
+
+	/** Seconds between streaming checks */
+	UPROPERTY(config, EditAnywhere, Category = "World Partition", meta = (ClampMin = 0.f))
+	float ClimbStreamingCheckInterval = 0.1f;
+
+	/** Seconds a climber holds for cells that have not streamed in before it probes whatever geometry is there */
+	UPROPERTY(config, EditAnywhere, Category = "World Partition", meta = (ClampMin = 0.f))
+	float ClimbStreamingHoldTimeout = 3.f;
+
+	/** Collision */
+	/** The climbable surface sweep and IK traces only look for the ClimbProxy object type, floor, ledge, vault and wall run traces keep seeing the level. Run the ClimbProxyGenerator commandlet on every climbable level first */
+	UPROPERTY(config, EditAnywhere, Category = "Collision")
+	bool bUseClimbProxyChannel = false;
+
+	/** Benchmarks */
+	UPROPERTY(config, EditAnywhere, Category = "Benchmark")
+	TSoftClassPtr<class AClimbingCharacter> BenchmarkCharacterClass;
+
+	UPROPERTY(config, EditAnywhere, Category = "Benchmark", meta = (ClampMin = 0.f))
+	float BenchmarkSpawnSpacing = 200.f;
+
+	/** Grid cell size of Climbing.QueryHeatmap.Start when none is given */
+	UPROPERTY(config, EditAnywhere, Category = "Benchmark", meta = (ClampMin = 1.f))
+	float QueryHeatmapCellSize = 200.f;
+};
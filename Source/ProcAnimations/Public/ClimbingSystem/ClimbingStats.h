@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+/** Stat group for the climbing system, view with "stat Climbing" */
+DECLARE_STATS_GROUP(TEXT("Climbing"), STATGROUP_Climbing, STATCAT_Advanced);
+
+/** Log category for the climbing system's reports, checks and warnings */
+PROCANIMATIONS_API DECLARE_LOG_CATEGORY_EXTERN(LogClimbing, Log, All);
+
+/** Climb IK */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Climb IK Schedule"), STAT_ClimbIK_Schedule, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Climb IK Update"), STAT_ClimbIK_Update, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb IK Limb Traces"), STAT_ClimbIK_LimbTraces, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb IK Reused Surface Hits"), STAT_ClimbIK_ReusedSurfaceHits, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb IK Active Climbers"), STAT_ClimbIK_ActiveClimbers, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb IK Degraded Climbers"), STAT_ClimbIK_DegradedClimbers, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** Traversal query governor */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traversal Queries Served"), STAT_TraversalQueries_Served, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traversal Queries Deferred"), STAT_TraversalQueries_Deferred, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traversal Queries Dropped"), STAT_TraversalQueries_Dropped, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traversal Query Traces"), STAT_TraversalQueries_Traces, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** Traversal query coalescing */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coalescer Agent Queries"), STAT_Coalescer_AgentQueries, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coalescer Scene Queries"), STAT_Coalescer_SceneQueries, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coalescer Narrowphase Queries"), STAT_Coalescer_NarrowphaseQueries, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coalescer Queries Saved"), STAT_Coalescer_QueriesSaved, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** Climber replication tiers */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Climb Net Evaluate Tiers"), STAT_ClimbNet_EvaluateTiers, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Net Active Climbers"), STAT_ClimbNet_ActiveClimbers, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Net Idle Climbers"), STAT_ClimbNet_IdleClimbers, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Net Distant Climbers"), STAT_ClimbNet_DistantClimbers, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Climb Net Dormancy Wakes"), STAT_ClimbNet_DormancyWakes, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** Async physics climb */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Climb Async Physics Step"), STAT_ClimbAsync_Step, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** Baked traversal index */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Traversal Index Streaming"), STAT_TraversalIndex_Streaming, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traversal Index Resident Cells"), STAT_TraversalIndex_ResidentCells, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traversal Index Queries"), STAT_TraversalIndex_Queries, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** Climber separation */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Climb Separation Update"), STAT_ClimbSeparation_Update, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Separation Climbers"), STAT_ClimbSeparation_Climbers, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Separation Neighbour Pairs"), STAT_ClimbSeparation_NeighbourPairs, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Sweep Impacts"), STAT_ClimbSeparation_SweepImpacts, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** AI traversal queries */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Traversal EQS Test"), STAT_TraversalEQS_Test, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traversal EQS Items"), STAT_TraversalEQS_Items, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traversal EQS Traces"), STAT_TraversalEQS_Traces, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traversal EQS Items Over Budget"), STAT_TraversalEQS_OverBudget, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** Server climb move validation */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Climb Validation Update"), STAT_ClimbValidation_Update, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Validation Claims"), STAT_ClimbValidation_Claims, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Validation Suspicious"), STAT_ClimbValidation_Suspicious, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Validation Geometry Traces"), STAT_ClimbValidation_GeometryTraces, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Validation Expired"), STAT_ClimbValidation_Expired, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Validation Dropped"), STAT_ClimbValidation_Dropped, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Validation Pending"), STAT_ClimbValidation_Pending, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** Memory */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Climbing Memory Sample"), STAT_ClimbingMemory_Sample, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Climber Footprint"), STAT_ClimbingMemory_Climbers, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** Climb and hang movement ticks */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Climb Tick"), STAT_ClimbTick_Climb, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hang Tick"), STAT_ClimbTick_Hang, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** Wall run */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Wall Run Tick"), STAT_WallRun_Tick, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Wall Run Probes"), STAT_WallRun_Probes, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** World Partition streaming */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Climb Streaming Update"), STAT_ClimbStreaming_Update, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Streaming Sources"), STAT_ClimbStreaming_Sources, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Streaming Holding"), STAT_ClimbStreaming_Holding, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Streaming Probes Suppressed"), STAT_ClimbStreaming_ProbesSuppressed, STATGROUP_Climbing, PROCANIMATIONS_API);
+
+/** Ledge catch */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ledge Catch Probes"), STAT_LedgeCatch_Probes, STATGROUP_Climbing, PROCANIMATIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ledge Catches"), STAT_LedgeCatch_Catches, STATGROUP_Climbing, PROCANIMATIONS_API);
@@ -4,6 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "ClimbingSystem/TraversalQueryGovernor.h"
+#include "ClimbingSystem/ClimbAsyncPhysics.h"
+#include "ClimbingSystem/TraversalIndexSubsystem.h"
+#include "ClimbingSystem/ClimbMoveValidation.h"
+#include "ClimbingSystem/ClimbGripTable.h"
+#include "ClimbingSystem/ClimbInputLatency.h"
 #include "CustomMovementComponent.generated.h"
 
 DECLARE_DELEGATE(FOnEnterClimbState)
@@ -11,16 +17,181 @@ DECLARE_DELEGATE(FOnExitClimbState)
 
 class UAnimMontage;
 class AClimbingCharacter;
+class UTraversalMotionData;
+class UTraversalQueryCoalescer;
+class UClimberSeparationSubsystem;
+class UClimbStreamingSubsystem;
+class UClimbMoveValidationSubsystem;
+struct FTraversalIndexBakeParams;
+
+/** Probes that go through the traversal query governor, each with its own cached result */
+enum class ETraversalProbe : uint8
+{
+	ClimbableSurfaces,
+	StartClimbing,
+	ClimbDownLedge,
+	ReachedFloor,
+	ReachedLedge,
+	StartVaulting,
+	HangEdge,
+	WallRun,
+	LedgeCatch,
+	Num
+};
 
 UENUM(BlueprintType)
 namespace ECustomMovementMode
 {
 	enum Type
 	{
-		Move_Climb UMETA(DisplayName = "Climb Mode")
+		Move_Climb UMETA(DisplayName = "Climb Mode"),
+		Move_Hang UMETA(DisplayName = "Hang Mode"),
+		Move_WallRun UMETA(DisplayName = "Wall Run Mode"),
+		Move_Traversal UMETA(DisplayName = "Traversal Mode")
 	};
 }
 
+UENUM(BlueprintType)
+enum class ETraversalState : uint8
+{
+	Idle,
+	Entering,
+	Climbing,
+	ToppingOut,
+	Vaulting,
+	Dropping,
+	Hanging,
+	WallRunning
+};
+
+DECLARE_DELEGATE_OneParam(FOnTraversalStateChanged, ETraversalState)
+
+enum class ETraversalProbeOutcome : uint8
+{
+	Found,
+	NotFound,
+	/** Answering would need more traces than the caller has left */
+	OutOfBudget
+};
+
+/** A 25cm cell, facing octant and opportunity, every probe that quantizes the same shares one result */
+struct FTraversalOpportunityCacheKey
+{
+	FIntVector Cell = FIntVector::ZeroValue;
+	uint8 FacingOctant = 0;
+	ETraversalOpportunity Opportunity = ETraversalOpportunity::Climb;
+
+	bool operator==(const FTraversalOpportunityCacheKey& Other) const
+	{
+		return Cell == Other.Cell && FacingOctant == Other.FacingOctant && Opportunity == Other.Opportunity;
+	}
+
+	friend uint32 GetTypeHash(const FTraversalOpportunityCacheKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.Cell), ::GetTypeHash(Key.FacingOctant * 4 + (uint32)Key.Opportunity));
+	}
+};
+
+struct FTraversalOpportunityCacheEntry
+{
+	bool bFound = false;
+	double Time = 0.0;
+};
+
+/** The ledge a hanging climber holds, as a line along the top of the wall and the stretch of it known to have wall below */
+struct FClimbLedgeEdge
+{
+	FVector Origin = FVector::ZeroVector;
+	FVector Direction = FVector::ZeroVector;
+	/** Horizontal, pointing out of the wall */
+	FVector WallNormal = FVector::ZeroVector;
+
+	/** Distances along Direction from Origin, grown by the shimmy probes */
+	float VerifiedMin = 0.f;
+	float VerifiedMax = 0.f;
+
+	/** Set once a probe found the wall ending past that side of the verified stretch */
+	bool bMinIsEnd = false;
+	bool bMaxIsEnd = false;
+
+	FORCEINLINE FVector PointAt(float Distance) const {return Origin + Direction * Distance;}
+};
+
+/** A wall run predicted from its entry velocity, followed without probing until EndTime */
+struct FWallRunPath
+{
+	FVector Start = FVector::ZeroVector;
+	FVector RunDirection = FVector::ZeroVector;
+	/** Horizontal, pointing out of the wall */
+	FVector WallNormal = FVector::ZeroVector;
+	float RunSpeed = 0.f;
+	float StartVerticalSpeed = 0.f;
+	float GravityZ = 0.f;
+
+	/** Where the run runs out, or where the wall it is on was found to end */
+	float EndTime = 0.f;
+	bool bEndsAtDiscontinuity = false;
+
+	FORCEINLINE FVector PositionAt(float Time) const
+	{
+		return Start + RunDirection * (RunSpeed * Time) + FVector::UpVector * (StartVerticalSpeed * Time + 0.5f * GravityZ * Time * Time);
+	}
+
+	FORCEINLINE FVector VelocityAt(float Time) const
+	{
+		return RunDirection * RunSpeed + FVector::UpVector * (StartVerticalSpeed + GravityZ * Time);
+	}
+};
+
+/** Per component counters of the traversal transition work, used to verify that transitions stay deduplicated */
+USTRUCT(BlueprintType)
+struct FTraversalTransitionCounters
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Traversal")
+	int32 TraversalStateChanges = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Traversal")
+	int32 MovementModeChanges = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Traversal")
+	int32 RedundantModeChangesSkipped = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Traversal")
+	int32 OverlapRefreshes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Traversal")
+	int32 IgnoredMontageEvents = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Traversal")
+	int32 RejectedTransitions = 0;
+};
+
+/** Carries climb presses and releases in the client's move stream, so the server toggles climbing on the same move */
+class PROCANIMATIONS_API FSavedMove_Climbing : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+
+	uint8 bWantsToStartClimb : 1;
+	uint8 bWantsToStopClimb : 1;
+};
+
+class PROCANIMATIONS_API FNetworkPredictionData_Client_Climbing : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	FNetworkPredictionData_Client_Climbing(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
 
 /**
  * 
@@ -32,15 +203,60 @@ class PROCANIMATIONS_API UCustomMovementComponent : public UCharacterMovementCom
 public:
 	FOnEnterClimbState OnEnterClimbStateDelegate;
 	FOnExitClimbState OnExitClimbStateDelegate;
+	FOnTraversalStateChanged OnTraversalStateChangedDelegate;
 
 private:
 	
 #pragma region ClimbTraces
 
-	TArray<FHitResult> DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End, bool bShowDebugShape = false, bool bDrawPersistantShapes = false);
+	/** bClimbSurface sweeps the climb proxies when the settings route climbing to them, every other trace sees the level itself */
+	TArray<FHitResult> DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End, bool bShowDebugShape = false, bool bDrawPersistantShapes = false, bool bClimbSurface = false);
 	FHitResult DoLineTraceSingleByObject(const FVector& Start, const FVector& End, bool bShowDebugShape = false, bool bDrawPersistantShapes = false);
 #pragma endregion 
 
+#pragma region ClimbQueryBudget
+
+	bool AcquireTraversalQuery(ETraversalProbe Probe, int32 TraceCost);
+	ETraversalQueryPriority GetTraversalQueryPriority() const;
+
+	UPROPERTY()
+	UTraversalQueryGovernor* TraversalQueryGovernor;
+
+	/** Shares scene queries with other climbers probing the same cell */
+	UPROPERTY()
+	UTraversalQueryCoalescer* TraversalQueryCoalescer;
+
+	/** The climbable surface sweep and IK traces */
+	FCollisionObjectQueryParams ClimbableSurfaceObjectQueryParams;
+	/** Floor, ledge, vault and wall run traces, always ClimbableSurfaceTraceTypes */
+	FCollisionObjectQueryParams WorldObjectQueryParams;
+
+	/** ClimbableSurfaceTraceTypes, or only the ClimbProxy object type when the settings route climbing to the proxies */
+	TArray<TEnumAsByte<EObjectTypeQuery> > ClimbTraceObjectTypes;
+
+	/** Baked climb, ledge and vault points, answers the start probes without tracing where the level is indexed */
+	UPROPERTY()
+	UTraversalIndexSubsystem* TraversalIndex;
+
+	FTraversalProbeCache TraversalProbeCaches[(uint8)ETraversalProbe::Num];
+	FVector CachedVaultStartPosition;
+	FVector CachedVaultLandPosition;
+
+#pragma endregion
+
+#pragma region TraversalOpportunities
+
+	/** The start probe rules, evaluated as if the character stood at CharacterLocation facing Forward */
+	ETraversalIndexResult QueryTraversalIndex(ETraversalOpportunity Opportunity, const FVector& CharacterLocation, const FVector& Forward,
+		FVector& OutVaultStart, FVector& OutVaultLand) const;
+	bool TraceTraversalOpportunity(ETraversalOpportunity Opportunity, const FVector& CharacterLocation, const FVector& Forward,
+		FVector& OutVaultStart, FVector& OutVaultLand);
+	static int32 GetTraversalOpportunityTraceCost(ETraversalOpportunity Opportunity);
+
+	TMap<FTraversalOpportunityCacheKey, FTraversalOpportunityCacheEntry> TraversalOpportunityCache;
+
+#pragma endregion
+
 #pragma region ClimbCore
 
 	bool TraceClimbableSurfaces();
@@ -51,6 +267,8 @@ private:
 	void StopClimbing();
 	void PhysClimb(float deltaTime, int32 Iterations);
 	void ProcessClimbableSurfaceInfo();
+	void DetectClimbCorner();
+	void UpdateCornerWrap(float DeltaTime);
 	bool CheckShouldStopClimbing();
 	bool CheckHasReachedFloor();
 	FQuat GetClimbRotation(float DeltaTime);
@@ -58,21 +276,247 @@ private:
 	bool CheckHasReachedLedge();
 	void TryStartVaulting();
 	bool CanStartVaulting(FVector& OutVaultStartPosition, FVector& OutVaultLandPosition);
-	void PlayClimbMontage(UAnimMontage* MontageToPlay);
+	bool PlayClimbMontage(UAnimMontage* MontageToPlay);
 	UFUNCTION()
 	void OnClimbMontageEnded(UAnimMontage *Montage, bool bInterrupted);
 	void SetMotionWarpTarget(const FName& InWarpTargetName, const FVector& InTargetPosition);
+	bool SetClimbCapsuleHalfHeight(float NewHalfHeight);
+	void TryClimbToTop();
+	const FClimbGrip& ResolveClimbGrip(const FHitResult& Hit) const;
+	void RemoveUngrippableHits(TArray<FHitResult>& Hits) const;
 	
 	
 	
 #pragma endregion 
+
+#pragma region LedgeHang
+
+	/** Finds the edge of the ledge in front of the climber, three traces that are only paid on entering the hang */
+	bool TraceLedgeEdge(FClimbLedgeEdge& OutEdge);
+	bool StartHanging();
+	void PhysHang(float deltaTime, int32 Iterations);
+	/** Verifies more of the edge around LeadDistance with a single probe, false if the climber may not reach it yet */
+	bool ExtendHangEdge(float LeadDistance);
+	bool TryLeaveHang();
+	FVector GetHangLocation() const;
+	FVector GetHangLocationAt(float EdgeDistance) const;
+	/** Holds Edge from where the climber is now, with only the stretch under the hands verified */
+	void SetHangEdge(const FClimbLedgeEdge& Edge);
+
+	FClimbLedgeEdge HangEdge;
+	float HangEdgeDistance = 0.f;
+	float HangWallOffset = 0.f;
+	float HangDropBelowEdge = 0.f;
+	/** A ledge catch guessed the edge from a single probe, the first hang tick traces the real one */
+	bool bHangEdgeProvisional = false;
+
+	/** Scene queries issued by this component, for comparing the climb and hang tick costs */
+	int32 QueryTraceCount = 0;
+	/** QueryTraceCount when the last fall ended, what the fall cost up to the catch or landing */
+	int32 FallEndQueryTraceCount = 0;
+
+	/** Climbing down over a ledge ends hanging from it instead of on the wall below */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta= (AllowPrivateAccess = true))
+	bool bEnableLedgeHang = true;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta= (AllowPrivateAccess = true))
+	float MaxHangShimmySpeed = 60.f;
+
+	/** The edge has to continue this far either side of the capsule for the hands to hold it */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta= (AllowPrivateAccess = true))
+	float HangHandReach = 35.f;
+
+	/** How far past the leading hand each edge probe verifies, a steady shimmy traces once per this distance */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta= (AllowPrivateAccess = true))
+	float HangEdgeProbeSpacing = 25.f;
+
+	/** Depth below the top of the ledge at which the edge probes look for the wall */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta= (AllowPrivateAccess = true))
+	float HangEdgeProbeDepth = 10.f;
+
+#pragma endregion
+
+#pragma region LedgeCatch
+
+	/** Grabs a ledge the hands pass while falling, one index lookup and at most one line trace along this move's fall path */
+	bool TryCatchLedge(float DeltaTime);
+
+	/** Set for the rest of the move a ledge was caught in, the provisional edge is only verified from the next move on */
+	bool bDeferHangEdgeVerification = false;
+	double LastWallReleaseTime = -1.0;
+	double WalkOffTime = -1.0;
+	/** Back toward the floor the character walked off, the ledge it would catch */
+	FVector WalkOffFacing = FVector::ZeroVector;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Ledge Catch", meta= (AllowPrivateAccess = true))
+	bool bEnableLedgeCatch = true;
+
+	/** Height of the hands above the capsule centre while falling, the catch hangs the climber this far below the edge */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Ledge Catch", meta= (AllowPrivateAccess = true))
+	float LedgeCatchHandHeight = 80.f;
+
+	/** Distance of the hands in front of the capsule centre */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Ledge Catch", meta= (AllowPrivateAccess = true))
+	float LedgeCatchReach = 50.f;
+
+	/** Seconds after letting go of a wall or ledge before the same fall can catch one */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Ledge Catch", meta= (AllowPrivateAccess = true))
+	float LedgeCatchReentryDelay = 0.5f;
+
+	/** Seconds after walking off an edge during which the catch looks back at it instead of ahead */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Ledge Catch", meta= (AllowPrivateAccess = true))
+	float LedgeCatchWalkOffWindow = 0.4f;
+
+	/** Warped to the hang location through the LedgeCatchPoint target, without it the catch snaps into the hang */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Ledge Catch", meta= (AllowPrivateAccess = true))
+	UAnimMontage* LedgeCatchMontage;
+
+#pragma endregion
 	
+#pragma region TraversalState
+
+	static bool IsValidTraversalTransition(ETraversalState From, ETraversalState To);
+	bool CanEnterTraversalState(ETraversalState NewState) const;
+	bool TryEnterTraversalState(ETraversalState NewState);
+
+	ETraversalState TraversalState = ETraversalState::Idle;
+
+	/** The traversal montage whose blend out finishes the current transition. Any other montage event is ignored */
+	UPROPERTY()
+	UAnimMontage* PendingTraversalMontage;
+
+	FTraversalTransitionCounters TransitionCounters;
+
+#pragma endregion
+
+#pragma region BakedTraversal
+
+	bool ShouldUseBakedTraversal(const UAnimMontage* Montage) const;
+	bool StartBakedTraversal(UAnimMontage* Montage);
+	void UpdateBakedTraversal();
+	/** Moves a baked traversal that started off the wall, along its root motion source and nothing else */
+	void PhysTraversal(float deltaTime, int32 Iterations);
+
+	/** Climbing.BakedTraversal.ParityCheck: where the traversal starts, and how far its end lands from the montage's */
+	void BeginTraversalParityCheck();
+	void CheckTraversalParity(const UAnimMontage* Montage) const;
+
+	/** Baked root motion for the traversal montages, used where no pose needs evaluating */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta= (AllowPrivateAccess = true))
+	UTraversalMotionData* BakedTraversalMotionData;
+
+	TMap<FName, FVector> MotionWarpTargets;
+	uint16 ActiveBakedTraversalID = 0;
+
+	UPROPERTY()
+	UAnimMontage* ActiveBakedTraversalMontage;
+
+	/** Set while the montage of a baked traversal plays for the pose only, with the anim instance's root motion off */
+	bool bPlayingBakedTraversalPose = false;
+	TEnumAsByte<ERootMotionMode::Type> PreBakedTraversalRootMotionMode = ERootMotionMode::RootMotionFromMontagesOnly;
+
+	FVector TraversalParityStartLocation = FVector::ZeroVector;
+	FQuat TraversalParityStartBasis = FQuat::Identity;
+	float TraversalParityRootHeightOffset = 0.f;
+	TMap<FName, FVector> TraversalParityWarpTargets;
+
+#pragma endregion
+
+#pragma region InputLatency
+
+	/** Tags the pending climb input with the action it started, inputs that start nothing are dropped */
+	void ClaimClimbInput(EClimbLatencyAction Action);
+	void ResolveMoveInputLatency(const FVector& PreviousVelocity);
+
+	FClimbInputStamp ClimbInputStamp;
+	FClimbInputStamp MoveInputStamp;
+	uint64 LastMoveInputFrame = 0;
+
+#pragma endregion
+
+#pragma region AsyncPhysicsClimb
+
+	FClimbAsyncInput MakeClimbAsyncInput() const;
+	/** Moves the climber with the physics thread step published since the last frame, false when there is none for this climb */
+	bool ApplyAsyncClimbStep(float deltaTime);
+	void RecordAsyncClimbParityReference(const FClimbAsyncInput& Input);
+	void CheckAsyncClimbParity(const FClimbAsyncOutput& Output);
+
+	bool bAsyncPhysicsClimbActive = false;
+	TClimbStateDoubleBuffer<FClimbAsyncInput> AsyncClimbInput;
+	TClimbStateDoubleBuffer<FClimbAsyncOutput> AsyncClimbOutput;
+	uint32 AsyncClimbInputFrame = 0;
+	uint32 AsyncClimbStartFrame = 0;
+	float MaxAsyncClimbParityError = 0.f;
+	/** What the game thread climb made of each recently published input over one physics step, by input frame */
+	static constexpr int32 NumAsyncClimbParityReferences = 4;
+	FClimbAsyncOutput AsyncClimbParityReferences[NumAsyncClimbParityReferences];
+
+	/** Physics thread only */
+	uint32 AsyncSimulatedInputFrame = 0;
+	uint32 AsyncSimulatedSteps = 0;
+	FVector AsyncSimulatedVelocity;
+	FQuat AsyncSimulatedRotation;
+
+#pragma endregion
+
+#pragma region ClimbMoveValidation
+
+	/** Server only, the moves of remotely controlled climbers for validating what their clients claim */
+	FClimbMoveHistory ClimbMoveHistory;
+	bool bLastClientMoveClaimedClimb = false;
+
+	/** Climb press or release waiting for the next move, set from input locally and from the move's flags on the server */
+	bool bWantsToStartClimb = false;
+	bool bWantsToStopClimb = false;
+
+	UPROPERTY()
+	UClimbMoveValidationSubsystem* ClimbMoveValidator;
+
+#pragma endregion
+
 #pragma region ClimbVariables
 
 	TArray<FHitResult> ClimbableSurfacesTracedResults;
 	FVector CurrentClimbableSurfaceLocation;
 	FVector CurrentClimbableSurfaceNormal;
 
+	/** Grip of the nearest climb sweep hit, FallbackClimbGrip until one resolves */
+	FClimbGrip CurrentClimbGrip;
+	/** The component's own climb speed and the default slope limit, for climbers without a grip table */
+	FClimbGrip FallbackClimbGrip;
+
+	/** Per physical material climbability, speed and slope limits. Without one every climbable object type grips the same */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta= (AllowPrivateAccess = true))
+	UClimbGripTable* ClimbGripTable;
+
+	/** Corner estimate from the last climb sweep */
+	bool bIsAtClimbCorner = false;
+	bool bIsOutsideCorner = false;
+	float ClimbSurfaceCurvature = 0.f;
+	FVector CornerNextFaceLocation;
+	FVector CornerNextFaceNormal;
+
+	/** Steering away from other climbers on the same wall, applied before the climb sweep. Zero unless CanApplyClimbSeparation */
+	FVector ClimbSeparationVelocity = FVector::ZeroVector;
+
+	UPROPERTY()
+	UClimberSeparationSubsystem* ClimberSeparationSubsystem;
+
+	UPROPERTY()
+	UClimbStreamingSubsystem* ClimbStreamingSubsystem;
+
+	/** False while World Partition cells within probe reach are still streaming in, probes hold their last answer until then */
+	bool bTraversalAreaStreamedIn = true;
+
+	/** Active wrap from one corner face to the next */
+	bool bIsCornerWrapping = false;
+	float CornerWrapAlpha = 0.f;
+	FVector CornerWrapFromLocation;
+	FVector CornerWrapFromNormal;
+	FVector CornerWrapToLocation;
+	FVector CornerWrapToNormal;
+
 	UPROPERTY()
 	class UAnimInstance* OwningPlayerAnimInstance;
 
@@ -97,6 +541,14 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta= (AllowPrivateAccess = true))
 	float MaxClimbAcceleration = 300.f;
 
+	/** Two climb hits whose normals differ by more than this are treated as the faces of a corner */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta= (AllowPrivateAccess = true))
+	float CornerDetectionAngle = 30.f;
+
+	/** Lateral distance travelled while wrapping from one corner face to the next */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta= (AllowPrivateAccess = true))
+	float CornerWrapDistance = 60.f;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta= (AllowPrivateAccess = true))
 	UAnimMontage* IdleToClimbMontage;
 
@@ -117,22 +569,147 @@ private:
 	
 #pragma endregion
 
+#pragma region WallRun
+
+	/** Predicts the run along the wall WallHit found, probing into the wall a capsule width apart until it ends */
+	bool PlanWallRun(const FHitResult& WallHit, const FVector& InVelocity, float MaxDuration, FWallRunPath& OutPath);
+	/** The most traces PlanWallRun can spend on a run this long at this horizontal speed, what the governor is charged */
+	int32 GetWallRunPlanTraceCost(float MaxDuration, float HorizontalSpeed) const;
+	void PhysWallRun(float deltaTime, int32 Iterations);
+	/** Looks for the next wall at the predicted end of the current one, one trace plus planning the run along it */
+	bool ReprobeWallRun();
+	void StopWallRun();
+
+	FWallRunPath WallRunPath;
+	float WallRunTime = 0.f;
+	/** Time spent on the earlier walls of this run */
+	float WallRunElapsedTime = 0.f;
+	double LastWallRunEndTime = -1.0;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Wall Run", meta= (AllowPrivateAccess = true))
+	float MinWallRunSpeed = 300.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Wall Run", meta= (AllowPrivateAccess = true))
+	float MaxWallRunDuration = 1.5f;
+
+	/** Walls shorter than this run are not worth entering */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Wall Run", meta= (AllowPrivateAccess = true))
+	float MinWallRunDuration = 0.2f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Wall Run", meta= (AllowPrivateAccess = true))
+	float WallRunGravityScale = 0.25f;
+
+	/** The run ends once falling faster than this */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Wall Run", meta= (AllowPrivateAccess = true))
+	float WallRunMaxFallSpeed = 200.f;
+
+	/** Entering the run lifts the runner to at least this vertical speed */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Wall Run", meta= (AllowPrivateAccess = true))
+	float WallRunEntryVerticalSpeed = 150.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Wall Run", meta= (AllowPrivateAccess = true))
+	float WallRunDetectionDistance = 75.f;
+
+	/** Depth behind the wall face of the sweep that finds where the wall ends */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Wall Run", meta= (AllowPrivateAccess = true))
+	float WallRunProbeDepth = 5.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Wall Run", meta= (AllowPrivateAccess = true))
+	float WallRunReentryDelay = 0.3f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Wall Run", meta= (AllowPrivateAccess = true))
+	float WallJumpOffWallSpeed = 450.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Wall Run", meta= (AllowPrivateAccess = true))
+	float WallJumpUpSpeed = 450.f;
+
+#pragma endregion
+
 #pragma region OverridenMethods
 	protected:
 		virtual void BeginPlay() override;
+		virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 		virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+		virtual void AsyncPhysicsTickComponent(float DeltaTime, float SimTime) override;
 		virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
 		virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+		virtual void PhysFalling(float deltaTime, int32 Iterations) override;
 		virtual float GetMaxSpeed() const override;
 		virtual float GetMaxAcceleration() const override;
+		virtual bool CanAttemptJump() const override;
+		virtual bool DoJump(bool bReplayingMoves) override;
 		virtual FVector ConstrainAnimRootMotionVelocity(const FVector& RootMotionVelocity, const FVector& CurrentVelocity) const override; 
+		virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+		virtual void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity) override;
+		virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc,
+			const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+		virtual bool ServerShouldUseAuthoritativePosition(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc,
+			const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+		virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+		virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
 #pragma endregion 
 	
 
 public:
 
 	void ToggleClimbing(bool bEnableClimb);
+	/** Toggles climbing on the next move through its compressed flags, so a remote client's server toggles it on the same move */
+	void RequestClimbToggle(bool bEnableClimb);
+	FORCEINLINE bool WantsToStartClimb() const {return bWantsToStartClimb;}
+	FORCEINLINE bool WantsToStopClimb() const {return bWantsToStopClimb;}
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	/** Input latency, the character stamps its inputs before handing them over. Free unless FClimbInputLatency is recording */
+	void StampClimbInput();
+	void StampMoveInput();
+	/** The montage whose first frame of motion closes the pending climb input, for the anim instance */
+	const UAnimMontage* GetInputLatencyMontage() const;
+	void ResolveClimbInputLatency();
+
+	/**
+	 * Runs the start probe for Opportunity as if standing at FeetLocation facing Forward, for AI queries.
+	 * Index lookups and results cached within TraversalOpportunityCacheLifetime are free, traces spend InOutTraceBudget.
+	 */
+	ETraversalProbeOutcome ProbeTraversalOpportunity(ETraversalOpportunity Opportunity, const FVector& FeetLocation, const FVector& Forward, int32& InOutTraceBudget);
+	FORCEINLINE int32 GetNumCachedTraversalOpportunities() const {return TraversalOpportunityCache.Num();}
+	FORCEINLINE void ResetTraversalOpportunityCache() {TraversalOpportunityCache.Reset();}
 	bool IsClimbing() const;
+	bool IsHanging() const;
+	bool IsWallRunning() const;
+
+	/** Starts running along a wall beside a falling character, false if there is no wall worth running. AI behaviours call this from Blueprint */
+	UFUNCTION(BlueprintCallable, Category = "Traversal")
+	bool TryStartWallRun();
+
+	/** AI path following moves the character here instead of through AddMovementInput, so these wake a dormant climber too */
+	virtual void RequestDirectMove(const FVector& MoveVelocity, bool bForceMaxSpeed) override;
+	virtual void RequestPathMove(const FVector& MoveInput) override;
+	FORCEINLINE const FWallRunPath& GetWallRunPath() const {return WallRunPath;}
+	FORCEINLINE ETraversalState GetTraversalState() const {return TraversalState;}
+	FORCEINLINE const FTraversalTransitionCounters& GetTransitionCounters() const {return TransitionCounters;}
 	FORCEINLINE FVector GetClimbableSurfaceNormal() const {return CurrentClimbableSurfaceNormal;}
+	FORCEINLINE FVector GetClimbableSurfaceLocation() const {return CurrentClimbableSurfaceLocation;}
+	FORCEINLINE const FClimbGrip& GetCurrentClimbGrip() const {return CurrentClimbGrip;}
+	FORCEINLINE bool IsAtClimbCorner() const {return bIsAtClimbCorner;}
+	FORCEINLINE bool IsCornerWrapping() const {return bIsCornerWrapping;}
+	FORCEINLINE float GetClimbSurfaceCurvature() const {return ClimbSurfaceCurvature;}
+	FORCEINLINE const TArray<FHitResult>& GetClimbableSurfacesTracedResults() const {return ClimbableSurfacesTracedResults;}
+	FORCEINLINE const TArray<TEnumAsByte<EObjectTypeQuery> >& GetClimbableSurfaceTraceTypes() const {return ClimbableSurfaceTraceTypes;}
+	FORCEINLINE const FCollisionObjectQueryParams& GetClimbableSurfaceObjectQueryParams() const {return ClimbableSurfaceObjectQueryParams;}
+	FORCEINLINE FClimbMoveHistory& GetClimbMoveHistory() {return ClimbMoveHistory;}
+	FClimbMoveValidationParams GetClimbMoveValidationParams() const;
+	/** The start probes' trace geometry, for baking a traversal index that answers exactly like them */
+	FTraversalIndexBakeParams GetTraversalIndexBakeParams() const;
+	/** Identifies the content of the grip table filtering climbable surfaces, 0 without one */
+	uint32 GetClimbGripTableHash() const;
 	FVector GetUnrotatedClimbVelocity() const;
+	FORCEINLINE void SetClimbSeparationVelocity(const FVector& InVelocity) {ClimbSeparationVelocity = InVelocity;}
+	/** Separation is not part of saved moves, so only moves the server authors itself may use it */
+	bool CanApplyClimbSeparation() const;
+	FORCEINLINE void SetTraversalAreaStreamedIn(bool bStreamedIn) {bTraversalAreaStreamedIn = bStreamedIn;}
+	FORCEINLINE bool IsTraversalAreaStreamedIn() const {return bTraversalAreaStreamedIn;}
+	FORCEINLINE bool IsAsyncPhysicsClimbActive() const {return bAsyncPhysicsClimbActive;}
+	FORCEINLINE float GetMaxAsyncClimbParityError() const {return MaxAsyncClimbParityError;}
+	FORCEINLINE int32 GetQueryTraceCount() const {return QueryTraceCount;}
+	FORCEINLINE int32 GetFallEndQueryTraceCount() const {return FallEndQueryTraceCount;}
 };
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DataProviders/AIDataProvider.h"
+#include "EnvironmentQuery/Generators/EnvQueryGenerator_ProjectedPoints.h"
+#include "EnvQueryGenerator_TraversalOpportunities.generated.h"
+
+/**
+ * Candidate spots for an AI to start a climb, vault or drop down from.
+ * Where the baked traversal index covers the area the candidates are its approach points, elsewhere a navmesh
+ * projected grid around the context, to be narrowed down by the Traversal Opportunity test.
+ */
+UCLASS(meta = (DisplayName = "Traversal Opportunities"))
+class PROCANIMATIONS_API UEnvQueryGenerator_TraversalOpportunities : public UEnvQueryGenerator_ProjectedPoints
+{
+	GENERATED_BODY()
+
+public:
+	UEnvQueryGenerator_TraversalOpportunities(const FObjectInitializer& ObjectInitializer);
+
+	virtual void GenerateItems(FEnvQueryInstance& QueryInstance) const override;
+
+	virtual FText GetDescriptionTitle() const override;
+	virtual FText GetDescriptionDetails() const override;
+
+protected:
+	UPROPERTY(EditDefaultsOnly, Category = Generator)
+	TSubclassOf<UEnvQueryContext> GenerateAround;
+
+	UPROPERTY(EditDefaultsOnly, Category = Generator)
+	FAIDataProviderFloatValue SearchRadius;
+
+	/** Grid spacing where the area is not indexed */
+	UPROPERTY(EditDefaultsOnly, Category = Generator)
+	FAIDataProviderFloatValue SpaceBetween;
+
+	UPROPERTY(EditDefaultsOnly, Category = Generator)
+	bool bClimb = true;
+
+	UPROPERTY(EditDefaultsOnly, Category = Generator)
+	bool bVault = true;
+
+	UPROPERTY(EditDefaultsOnly, Category = Generator)
+	bool bDropDown = true;
+};
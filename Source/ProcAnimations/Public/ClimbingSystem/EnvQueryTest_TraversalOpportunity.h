@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DataProviders/AIDataProvider.h"
+#include "EnvironmentQuery/EnvQueryTest.h"
+#include "ClimbingSystem/TraversalIndexSubsystem.h"
+#include "EnvQueryTest_TraversalOpportunity.generated.h"
+
+/**
+ * Whether the querying climber could start Opportunity from each item, using the same probes as the player.
+ * Items the index or a recent probe already answers are free, the rest are traced nearest first until
+ * MaxTracesPerQuery runs out, and the ones left over fail.
+ */
+UCLASS(meta = (DisplayName = "Traversal Opportunity"))
+class PROCANIMATIONS_API UEnvQueryTest_TraversalOpportunity : public UEnvQueryTest
+{
+	GENERATED_BODY()
+
+public:
+	UEnvQueryTest_TraversalOpportunity(const FObjectInitializer& ObjectInitializer);
+
+	virtual void RunTest(FEnvQueryInstance& QueryInstance) const override;
+
+	virtual FText GetDescriptionTitle() const override;
+	virtual FText GetDescriptionDetails() const override;
+
+protected:
+	UPROPERTY(EditDefaultsOnly, Category = Traversal)
+	ETraversalOpportunity Opportunity = ETraversalOpportunity::Climb;
+
+	UPROPERTY(EditDefaultsOnly, Category = Traversal)
+	FAIDataProviderIntValue MaxTracesPerQuery;
+
+	/** Facings probed per item, starting with the one from the querier towards the item */
+	UPROPERTY(EditDefaultsOnly, Category = Traversal, meta = (ClampMin = 1, ClampMax = 8))
+	int32 NumFacings = 4;
+};
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/RootMotionSource.h"
+#include "RootMotionSource_BakedTraversal.generated.h"
+
+class UTraversalMotionData;
+struct FBakedTraversalMotion;
+
+/**
+ * Drives a traversal from a baked root motion curve instead of a playing montage.
+ * Warp windows are resolved once at start into per window offsets that blend in over each window.
+ */
+USTRUCT()
+struct PROCANIMATIONS_API FRootMotionSource_BakedTraversal : public FRootMotionSource
+{
+	GENERATED_BODY()
+
+	FRootMotionSource_BakedTraversal();
+
+	UPROPERTY()
+	TObjectPtr<const UTraversalMotionData> MotionData;
+
+	UPROPERTY()
+	int32 MotionIndex = INDEX_NONE;
+
+	UPROPERTY()
+	FVector StartLocation = FVector::ZeroVector;
+
+	/** Mesh space to world rotation at the start of the traversal */
+	UPROPERTY()
+	FQuat StartBasis = FQuat::Identity;
+
+	UPROPERTY()
+	TArray<FVector> WarpWindowOffsets;
+
+	/** Resolves warp targets against the unwarped trajectory. Targets missing from the map leave their window unwarped */
+	void ResolveWarpTargets(const TMap<FName, FVector>& WarpTargets, float RootHeightOffset);
+
+	/** Location of the updated component at Time, with warping applied */
+	FVector EvaluateLocation(float InTime) const;
+
+	virtual FRootMotionSource* Clone() const override;
+	virtual bool Matches(const FRootMotionSource* Other) const override;
+	virtual bool UpdateStateFrom(const FRootMotionSource* SourceToTakeStateFrom, bool bMarkForSimulatedCatchup = false) override;
+	virtual void PrepareRootMotion(float SimulationTime, float MovementTickTime, const ACharacter& Character, const UCharacterMovementComponent& MoveComponent) override;
+	virtual bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) override;
+	virtual UScriptStruct* GetScriptStruct() const override;
+	virtual FString ToSimpleString() const override;
+	virtual void AddReferencedObjects(class FReferenceCollector& Collector) override;
+
+private:
+	const FBakedTraversalMotion* GetMotion() const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRootMotionSource_BakedTraversal> : public TStructOpsTypeTraitsBase2<FRootMotionSource_BakedTraversal>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithCopy = true
+	};
+};
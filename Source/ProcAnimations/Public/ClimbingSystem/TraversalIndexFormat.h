@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * On disk layout of a baked traversal index (.ctix), read in place from memory mapped regions.
+ *
+ * File:  FTraversalIndexHeader | cell chunks, each aligned to ChunkAlignment | FTraversalIndexCellEntry table
+ * Chunk: FTraversalIndexChunkHeader | sub-cell ranges | climb surfaces | ledges | vault points
+ *
+ * Each cell is split into SubCellsPerSide x SubCellsPerSide sub-cells, row by row along Y. Every point array is
+ * sorted by sub-cell, and the sub-cell ranges hold, per array, the index of the first point of each sub-cell plus
+ * the array's length at the end, so a query reads only the points of the sub-cells it overlaps.
+ *
+ * Every offset is relative to the start of the file or of its chunk, so the data is position independent.
+ * Point locations are relative to their cell origin to keep float precision in large worlds.
+ */
+namespace TraversalIndexFormat
+{
+	inline constexpr uint32 Magic = 0x58495443; // "CTIX"
+	inline constexpr uint32 Version = 4;
+	inline constexpr uint32 ChunkAlignment = 4096;
+	/** 800 cm sub-cells in a 12800 cm cell, a start probe overlaps one to four of them */
+	inline constexpr uint32 SubCellsPerSide = 16;
+	/** Climb surfaces, ledges and vault points, in the order of their arrays */
+	inline constexpr int32 NumPointArrays = 3;
+
+	/** uint32 entries in a chunk's sub-cell ranges */
+	inline constexpr uint32 GetNumSubCellRanges(uint32 InSubCellsPerSide) { return NumPointArrays * (InSubCellsPerSide * InSubCellsPerSide + 1); }
+}
+
+struct FTraversalIndexHeader
+{
+	uint32 Magic = TraversalIndexFormat::Magic;
+	uint32 Version = TraversalIndexFormat::Version;
+	float CellSize = 0.f;
+	uint32 NumCells = 0;
+	uint64 CellTableOffset = 0;
+	uint64 FileSize = 0;
+	/** Grip table the climb surfaces were filtered with, 0 for none. Climbers gripping differently trace instead */
+	uint32 GripTableHash = 0;
+	uint32 Padding = 0;
+};
+
+struct FTraversalIndexCellEntry
+{
+	int32 CellX = 0;
+	int32 CellY = 0;
+	uint64 ChunkOffset = 0;
+	uint32 ChunkSize = 0;
+	uint32 Padding = 0;
+};
+
+struct FTraversalIndexChunkHeader
+{
+	uint32 NumClimbSurfaces = 0;
+	uint32 NumLedges = 0;
+	uint32 NumVaultPoints = 0;
+	uint32 SubCellsPerSide = 0;
+	uint32 ClimbSurfacesOffset = 0;
+	uint32 LedgesOffset = 0;
+	uint32 VaultPointsOffset = 0;
+	uint32 SubCellRangesOffset = 0;
+};
+
+/** Where the eye trace of a CanStartClimbing that passed hit the wall */
+struct FTraversalClimbSurfacePoint
+{
+	FVector3f Location;
+	FVector3f Normal;
+};
+
+/** Where the floor ends at the top of a drop CanClimbDownLedge would accept, with the baked facing out over the drop */
+struct FTraversalLedgePoint
+{
+	FVector3f Location;
+	FVector3f OutwardDirection;
+};
+
+/** Start and land of a vault CanStartVaulting would accept */
+struct FTraversalVaultPoint
+{
+	FVector3f Start;
+	FVector3f Land;
+};
+
+static_assert(sizeof(FTraversalIndexHeader) == 40 && sizeof(FTraversalIndexCellEntry) == 24 && sizeof(FTraversalIndexChunkHeader) == 32,
+	"Traversal index structs are read in place, bump TraversalIndexFormat::Version when changing them");
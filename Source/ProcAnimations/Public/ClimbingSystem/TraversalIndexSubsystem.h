@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbingSystem/TraversalIndexFormat.h"
+#include "TraversalIndexSubsystem.generated.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+UENUM(BlueprintType)
+enum class ETraversalOpportunity : uint8
+{
+	Climb,
+	Vault,
+	DropDown
+};
+
+enum class ETraversalIndexResult : uint8
+{
+	/** No resident baked data covers the location, the caller has to trace */
+	NotIndexed,
+	NotFound,
+	Found
+};
+
+/**
+ * Serves climb, ledge and vault queries from the level's baked traversal index.
+ * The .ctix file is memory mapped and cells are mapped in and out with the level around them, queries read the
+ * mapped points of the sub-cells they overlap in place without copying or deserializing them.
+ */
+UCLASS()
+class PROCANIMATIONS_API UTraversalIndexSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Replaces CanStartClimbing: a climbable wall in reach at eye height in front of the character */
+	ETraversalIndexResult FindClimbSurface(const FVector& EyeLocation, const FVector& Forward, float Reach) const;
+
+	/** Replaces CanClimbDownLedge: the floor ends between MinDistance and MaxDistance in front of the character's feet */
+	ETraversalIndexResult FindLedge(const FVector& FeetLocation, const FVector& Forward, float MinDistance, float MaxDistance) const;
+
+	/** Replaces CanStartVaulting: a vault starting in front of the character */
+	ETraversalIndexResult FindVaultPoint(const FVector& FeetLocation, const FVector& Forward, FVector& OutStart, FVector& OutLand) const;
+
+	/** For a falling character: a baked ledge facing it whose top the hands pass between HandStart and HandEnd */
+	ETraversalIndexResult FindCatchLedge(const FVector& HandStart, const FVector& HandEnd, const FVector& Facing, FVector& OutEdgeLocation, FVector& OutWallNormal) const;
+
+	/** Where a character of the given eye height would stand to use each baked opportunity within Radius */
+	void GatherApproachLocations(ETraversalOpportunity Opportunity, const FVector& Center, float Radius, float EyeHeightAboveFeet, TArray<FVector>& OutFeetLocations) const;
+
+	/** True when every cell within Radius is indexed and resident, so the index alone can answer for the area */
+	bool IsAreaResident(const FVector& Location, float Radius) const;
+
+	static FString GetIndexFilePath(const UWorld* World);
+
+	FORCEINLINE bool HasIndex() const { return MappedFile.IsValid(); }
+	/** Identifies the grip table the baked climb surfaces passed, see UCustomMovementComponent::GetClimbGripTableHash */
+	FORCEINLINE uint32 GetGripTableHash() const { return GripTableHash; }
+	FORCEINLINE int32 GetNumResidentCells() const { return ResidentCells.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FResidentCell
+	{
+		TUniquePtr<IMappedFileRegion> Region;
+		FVector CellOrigin;
+		TConstArrayView<FTraversalClimbSurfacePoint> ClimbSurfaces;
+		TConstArrayView<FTraversalLedgePoint> Ledges;
+		TConstArrayView<FTraversalVaultPoint> VaultPoints;
+		/** Per point array, the first point of each sub-cell, see TraversalIndexFormat */
+		TConstArrayView<uint32> SubCellRanges;
+		int32 SubCellsPerSide = 1;
+		float SubCellSize = 0.f;
+	};
+
+	/** The points of one row of overlapped sub-cells, as an index range into one of the cell's point arrays */
+	struct FPointSpan
+	{
+		const FResidentCell* Cell;
+		int32 First;
+		int32 Num;
+	};
+	using FPointSpans = TArray<FPointSpan, TInlineAllocator<16>>;
+
+	bool OpenIndex();
+	void UpdateResidentCells();
+	bool MapCell(const FIntPoint& Cell, const FTraversalIndexCellEntry& Entry);
+
+	/** Gathers the resident cells around Location, false if any of them is indexed but not resident */
+	bool GatherCells(const FVector& Location, float Radius, TArray<const FResidentCell*, TInlineAllocator<4>>& OutCells) const;
+	/** Like GatherCells, but only the points of PointArray in the sub-cells within Radius of Location */
+	bool GatherPointSpans(int32 PointArray, const FVector& Location, float Radius, FPointSpans& OutSpans) const;
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** A baked facing only answers probes within half the bake's direction step of it */
+	static bool MatchesBakedFacing(const FVector& BakedDirection, const FVector& Forward);
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> CellTableRegion;
+	float CellSize = 0.f;
+	uint32 GripTableHash = 0;
+
+	/** Every cell in the file, whether it is resident or not */
+	TMap<FIntPoint, FTraversalIndexCellEntry> IndexedCells;
+	TMap<FIntPoint, FResidentCell> ResidentCells;
+
+	float TimeUntilStreamingUpdate = 0.f;
+};
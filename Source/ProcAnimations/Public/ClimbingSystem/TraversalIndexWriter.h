@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "ClimbingSystem/TraversalIndexFormat.h"
+
+class UWorld;
+
+/** Collects traversal points per cell and writes them as a .ctix traversal index */
+class PROCANIMATIONS_API FTraversalIndexWriter
+{
+public:
+	explicit FTraversalIndexWriter(float InCellSize);
+
+	/** Makes sure the cell exists in the index, an indexed empty cell tells the runtime there is nothing to find */
+	void AddCell(const FIntPoint& Cell);
+	/** Leaves the cell out of the index, the runtime traces there instead */
+	void RemoveCell(const FIntPoint& Cell);
+	void GetCells(TArray<FIntPoint>& OutCells) const;
+
+	void AddClimbSurface(const FVector& Location, const FVector& Normal);
+	void AddLedge(const FVector& Location, const FVector& OutwardDirection);
+	void AddVaultPoint(const FVector& Start, const FVector& Land);
+	FORCEINLINE void SetGripTableHash(uint32 InGripTableHash) { GripTableHash = InGripTableHash; }
+
+	bool Write(const FString& FilePath) const;
+
+	FIntPoint GetCell(const FVector& Location) const;
+	int32 GetNumPoints() const;
+
+private:
+	struct FCellData
+	{
+		TArray<FTraversalClimbSurfacePoint> ClimbSurfaces;
+		TArray<FTraversalLedgePoint> Ledges;
+		TArray<FTraversalVaultPoint> VaultPoints;
+	};
+
+	FCellData& GetCellData(const FVector& Location, FVector3f& OutCellOrigin);
+
+	float CellSize;
+	uint32 GripTableHash = 0;
+	TMap<FIntPoint, FCellData> Cells;
+	/** Quantised locations already added per point kind, neighbouring samples find the same spots */
+	TSet<FIntVector> AddedPointKeys[3];
+};
+
+/** The climbing character's probe geometry, see UCustomMovementComponent::GetTraversalIndexBakeParams */
+struct FTraversalIndexBakeParams
+{
+	float StandingHalfHeight = 96.f;
+	float EyeHeight = 64.f;
+	float ClimbSweepOffset = 30.f;
+	float ClimbCapsuleRadius = 50.f;
+	float ClimbCapsuleHalfHeight = 72.f;
+	float ClimbEyeReach = 100.f;
+	float WalkableSurfaceTraceOffset = 15.f;
+	float LedgeTraceOffset = 25.f;
+
+	/** Climbable surface sweeps, the climb proxies when climbing is routed to them */
+	FCollisionObjectQueryParams ClimbObjectQueryParams;
+	/** The climber's grip table filter for climbable surface sweep hits, unset when everything is climbable */
+	TFunction<bool(const FHitResult&)> IsGrippable;
+	uint32 GripTableHash = 0;
+	/** Eye, floor, ledge and vault traces */
+	FCollisionObjectQueryParams ObjectQueryParams;
+};
+
+namespace TraversalIndexBaker
+{
+	/** Facings sampled per floor point, the runtime only trusts a baked point facing within half a step of it */
+	inline constexpr int32 NumDirections = 16;
+
+	/**
+	 * Samples the world on a grid and records every spot the movement component's probes would accept, running their
+	 * traces from the same origins, with the same lengths and object types. Only cells whose floors were probed are
+	 * indexed, cells with movable geometry are left out so the runtime keeps tracing there.
+	 */
+	PROCANIMATIONS_API void BakeWorld(UWorld* World, const FBox& Bounds, float SampleSpacing, const FTraversalIndexBakeParams& Params, FTraversalIndexWriter& Writer);
+}
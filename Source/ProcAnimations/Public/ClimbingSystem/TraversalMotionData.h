@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "TraversalMotionData.generated.h"
+
+class UAnimMontage;
+
+USTRUCT()
+struct FBakedTraversalWarpWindow
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Traversal")
+	FName WarpTargetName;
+
+	UPROPERTY(VisibleAnywhere, Category = "Traversal")
+	float StartTime = 0.f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Traversal")
+	float EndTime = 0.f;
+};
+
+/**
+ * Root motion track of one traversal montage, sampled at a fixed rate in mesh space relative to the first frame
+ */
+USTRUCT()
+struct PROCANIMATIONS_API FBakedTraversalMotion
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Traversal")
+	TObjectPtr<UAnimMontage> Montage;
+
+	UPROPERTY(EditAnywhere, Category = "Traversal", meta = (ClampMin = 1.f))
+	float SampleRate = 30.f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Traversal")
+	float Duration = 0.f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Traversal")
+	TArray<FVector3f> RootTranslation;
+
+	UPROPERTY(VisibleAnywhere, Category = "Traversal")
+	TArray<FBakedTraversalWarpWindow> WarpWindows;
+
+	bool Bake();
+	bool IsBaked() const { return RootTranslation.Num() > 1 && Duration > 0.f; }
+	FVector EvaluateTranslation(float Time) const;
+};
+
+/**
+ * Precomputed root motion and motion warping windows for the traversal montages.
+ * Baked when the asset is cooked so servers and far AI can drive traversal without evaluating a pose.
+ */
+UCLASS(BlueprintType)
+class PROCANIMATIONS_API UTraversalMotionData : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	const FBakedTraversalMotion* FindMotion(const UAnimMontage* Montage, int32* OutIndex = nullptr) const;
+	const FBakedTraversalMotion* GetMotion(int32 Index) const { return BakedMotions.IsValidIndex(Index) ? &BakedMotions[Index] : nullptr; }
+
+	UFUNCTION(CallInEditor, Category = "Traversal")
+	void BakeMotions();
+
+	/** Compares every baked curve with root motion extracted straight from its montage. Returns the worst error in cm */
+	float ValidateAgainstMontages(float Tolerance, TArray<FString>& OutErrors) const;
+
+	/** Where Montage's own root motion leaves the updated component, its last targeted warp window pulled onto the target */
+	static FVector PredictMontageEndLocation(const UAnimMontage* Montage, const FVector& StartLocation, const FQuat& StartBasis,
+		const TMap<FName, FVector>& WarpTargets, float RootHeightOffset);
+
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+#endif
+
+private:
+	UPROPERTY(EditAnywhere, Category = "Traversal")
+	TArray<FBakedTraversalMotion> BakedMotions;
+};
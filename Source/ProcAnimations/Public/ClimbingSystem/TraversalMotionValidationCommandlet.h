@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TraversalMotionValidationCommandlet.generated.h"
+
+/**
+ * Checks every UTraversalMotionData asset against its montages.
+ * UnrealEditor-Cmd ProcAnimations -run=TraversalMotionValidation [-Tolerance=1.0] [-Rebake]
+ */
+UCLASS()
+class PROCANIMATIONS_API UTraversalMotionValidationCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTraversalMotionValidationCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CollisionQueryParams.h"
+#include "TraversalQueryCoalescer.generated.h"
+
+class UPrimitiveComponent;
+
+/**
+ * Shares traversal scene queries between agents probing the same geometry.
+ * Queries are bucketed by spatial cell and object types. A cell that had several agents last frame gathers its
+ * primitives with one overlap, then every probe in it is answered against those primitives only.
+ * A shared probe still runs the narrowphase against each primitive it reaches, only probes that reach none skip all work.
+ */
+UCLASS()
+class PROCANIMATIONS_API UTraversalQueryCoalescer : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	bool LineTraceSingle(const void* Requester, FHitResult& OutHit, const FVector& Start, const FVector& End,
+		const FCollisionObjectQueryParams& ObjectQueryParams);
+
+	void CapsuleSweepMulti(const void* Requester, TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End,
+		float Radius, float HalfHeight, const FCollisionObjectQueryParams& ObjectQueryParams);
+
+	FORCEINLINE int32 GetLastFrameQueriesSaved() const { return LastFrameQueriesSaved; }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FCellKey
+	{
+		FIntVector Cell;
+		int32 ObjectTypesToQuery;
+
+		bool operator==(const FCellKey& Other) const { return Cell == Other.Cell && ObjectTypesToQuery == Other.ObjectTypesToQuery; }
+		friend uint32 GetTypeHash(const FCellKey& Key) { return HashCombine(GetTypeHash(Key.Cell), ::GetTypeHash(Key.ObjectTypesToQuery)); }
+	};
+
+	struct FCellPrimitive
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Primitive;
+		FBox Bounds;
+	};
+
+	struct FCellBucket
+	{
+		TArray<const void*, TInlineAllocator<8>> Requesters;
+		int32 LastFrameRequesterCount = 0;
+		TArray<FCellPrimitive> Primitives;
+		bool bPrimitivesGathered = false;
+	};
+
+	/** Returns the bucket to answer from, or null when the query should go straight to the scene */
+	FCellBucket* FindCoalescedBucket(const void* Requester, const FBox& QueryBounds, const FCollisionObjectQueryParams& ObjectQueryParams);
+	void GatherCellPrimitives(const FCellKey& Key, FCellBucket& Bucket, const FCollisionObjectQueryParams& ObjectQueryParams);
+
+	TMap<FCellKey, FCellBucket> CellBuckets;
+
+	int32 AgentQueries = 0;
+	int32 SceneQueries = 0;
+	int32 GatherQueries = 0;
+	int32 NarrowphaseQueries = 0;
+	/** Probes answered from a cell without a single narrowphase query, the only ones that cost nothing */
+	int32 SkippedQueries = 0;
+	/** Skipped probes less the overlaps gathering the cells cost */
+	int32 LastFrameQueriesSaved = 0;
+};
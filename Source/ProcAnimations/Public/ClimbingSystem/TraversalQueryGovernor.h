@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TraversalQueryGovernor.generated.h"
+
+UENUM(BlueprintType)
+enum class ETraversalQueryPriority : uint8
+{
+	LocallyControlled,
+	OnScreen,
+	OffScreen,
+	Num UMETA(Hidden)
+};
+
+UENUM()
+enum class ETraversalQueryDecision : uint8
+{
+	/** Run the traces now */
+	Serve,
+	/** Over budget, reuse the last result */
+	Defer,
+	/** Over budget and no usable cached result */
+	Drop
+};
+
+USTRUCT(BlueprintType)
+struct FTraversalQueryGovernorStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Traversal Queries")
+	int32 Served = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Traversal Queries")
+	int32 Deferred = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Traversal Queries")
+	int32 Dropped = 0;
+
+	/** Scene traces spent by served requests */
+	UPROPERTY(BlueprintReadOnly, Category = "Traversal Queries")
+	int32 TracesSpent = 0;
+};
+
+/**
+ * Cached outcome of one traversal probe, reused while the governor defers that probe.
+ * Stamped with where the probe ran from, an answer only holds for a character still standing there
+ */
+struct FTraversalProbeCache
+{
+	static constexpr float MaxReuseDistance = 10.f;
+	/** cos(10 degrees) */
+	static constexpr float MinReuseFacingDot = 0.985f;
+
+	bool bHasResult = false;
+	bool bResult = false;
+	uint16 StaleFrames = 0;
+	FVector Location = FVector::ZeroVector;
+	FVector Facing = FVector::ZeroVector;
+
+	bool Store(bool bInResult)
+	{
+		bHasResult = true;
+		bResult = bInResult;
+		StaleFrames = 0;
+		return bInResult;
+	}
+
+	/** Called as the probe is served, before its traces run */
+	void StampPose(const FVector& InLocation, const FVector& InFacing)
+	{
+		Location = InLocation;
+		Facing = InFacing;
+	}
+
+	bool IsValidAt(const FVector& InLocation, const FVector& InFacing) const
+	{
+		return FVector::DistSquared(Location, InLocation) <= FMath::Square(MaxReuseDistance) &&
+			(Facing | InFacing) >= MinReuseFacingDot;
+	}
+};
+
+/**
+ * Owns the per frame budget of traversal traces shared by every climber and walker in the world.
+ * Capacity is reserved per priority tier from last frame's demand, higher tiers may borrow from lower ones.
+ */
+UCLASS()
+class PROCANIMATIONS_API UTraversalQueryGovernor : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Ask to run a probe costing TraceCost traces. Updates the cache staleness when the probe is not served */
+	ETraversalQueryDecision RequestQuery(ETraversalQueryPriority Priority, int32 TraceCost, FTraversalProbeCache& Cache);
+
+	UFUNCTION(BlueprintCallable, Category = "Traversal Queries")
+	FTraversalQueryGovernorStats GetLastFrameStats() const { return LastFrameStats; }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void ResetFrameBudget();
+
+	int32 Allowance[(uint8)ETraversalQueryPriority::Num] = {};
+	int32 Demand[(uint8)ETraversalQueryPriority::Num] = {};
+
+	FTraversalQueryGovernorStats CurrentFrameStats;
+	FTraversalQueryGovernorStats LastFrameStats;
+};